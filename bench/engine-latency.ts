@@ -0,0 +1,88 @@
+/*
+* ===============================================================================
+* File Name          : engine-latency.ts
+* Creation Date      : 2026-10-18
+* Version            : 1.0.0
+* Author             : Rigoberto L. Salgado Reyes
+* Contact            : rlsalgado2006@gmail.com
+* ===============================================================================
+*/
+// Latency under mixed load: deep + cheap minimax searches racing with fs I/O.
+//
+//   npx tsx bench/engine-latency.ts [--addon path/to/neutron_minimax.node] [--deep 8] [--cheap 32] [--packed]
+//
+// Run it once against a build of this tree and once against a build that still queues on the
+// libuv threadpool (same flags) to compare; the fs probe shows the impact on unrelated I/O.
+// --packed asks for Int32Array results instead of {moves, score} objects.
+import path from "node:path";
+import { stat } from "node:fs/promises";
+import { performance } from "node:perf_hooks";
+
+function arg(name: string, fallback: string): string {
+	const i = process.argv.indexOf(`--${name}`);
+	return i > 0 && process.argv[i + 1] ? process.argv[i + 1] : fallback;
+}
+
+const addonPath = path.resolve(arg("addon", "native/build/Release/neutron_minimax.node"));
+const deepCount = Number(arg("deep", "8"));
+const cheapCount = Number(arg("cheap", "32"));
+const deepDepth = Number(arg("deep-depth", "4"));
+const cheapDepth = Number(arg("cheap-depth", "2"));
+const packed = process.argv.includes("--packed");
+
+const addon = require(addonPath);
+
+const board = Uint8Array.from([
+	1, 4, 4, 4, 2,
+	1, 4, 4, 4, 2,
+	1, 4, 3, 4, 2,
+	1, 4, 4, 4, 2,
+	1, 4, 4, 4, 2
+]);
+
+function percentiles(samples: number[]) {
+	const sorted = [...samples].sort((a, b) => a - b);
+	const at = (p: number) => sorted[Math.min(sorted.length - 1, Math.floor(p * sorted.length))] ?? 0;
+	return {n: sorted.length, p50: at(0.5).toFixed(1), p95: at(0.95).toFixed(1), p99: at(0.99).toFixed(1)};
+}
+
+async function timed(depth: number, out: number[]) {
+	const t0 = performance.now();
+	await addon.minimaxAsync({board, depth, packed});
+	out.push(performance.now() - t0);
+}
+
+async function main() {
+	const deep: number[] = [];
+	const cheap: number[] = [];
+	const io: number[] = [];
+
+	let running = true;
+	const probe = (async () => {
+		while (running) {
+			const t0 = performance.now();
+			await stat(addonPath);
+			io.push(performance.now() - t0);
+		}
+	})();
+
+	const t0 = performance.now();
+	const jobs: Promise<void>[] = [];
+	for (let i = 0; i < deepCount; i++) jobs.push(timed(deepDepth, deep));
+	for (let i = 0; i < cheapCount; i++) jobs.push(timed(cheapDepth, cheap));
+	await Promise.all(jobs);
+	running = false;
+	await probe;
+
+	console.table({
+		[`deep (depth ${deepDepth})`]: percentiles(deep),
+		[`cheap (depth ${cheapDepth})`]: percentiles(cheap),
+		"fs.stat": percentiles(io)
+	});
+	console.log(`wall: ${(performance.now() - t0).toFixed(1)} ms, UV_THREADPOOL_SIZE=${process.env.UV_THREADPOOL_SIZE ?? 4}`);
+}
+
+main().catch((err) => {
+	console.error(err);
+	process.exit(1);
+});
@@ -0,0 +1,75 @@
+/*
+* ===============================================================================
+* File Name          : rl-batch.ts
+* Creation Date      : 2026-10-18
+* Version            : 1.0.0
+* Author             : Rigoberto L. Salgado Reyes
+* Contact            : rlsalgado2006@gmail.com
+* ===============================================================================
+*/
+// MCTS simulations per second by leaf batch size (RL_LEAF_BATCH), one scheduler thread.
+//
+//   npx tsx bench/rl-batch.ts [--addon native/rl/build/Release/neutron_rl_addon.node] [--model data/model.pt]
+//                             [--batches 1,8,16,32] [--moves 4] [--difficulty hard]
+//
+// The batch size is fixed when the scheduler starts, so every size runs in a fresh node process.
+// The cache is off, so every move is searched; the first move of each process is a warm-up.
+import {execFileSync} from "node:child_process";
+import path from "node:path";
+
+function arg(name: string, fallback: string): string {
+	const i = process.argv.indexOf(`--${name}`);
+	return i > 0 && process.argv[i + 1] ? process.argv[i + 1] : fallback;
+}
+
+const addonPath = path.resolve(arg("addon", "native/rl/build/Release/neutron_rl_addon.node"));
+const modelPath = path.resolve(arg("model", "data/model.pt"));
+const batches = arg("batches", "1,8,16,32").split(",").map(Number);
+const moves = Number(arg("moves", "4"));
+const difficulty = arg("difficulty", "hard");
+
+type Sample = { msPerMove: number; simsPerSec: number; meanBatchSize: number; simulations: number };
+
+// Runs in the child: loads the model once, then plays `moves` timed moves from the start position.
+const child = (leafBatch: number) => `
+const {performance} = require("node:perf_hooks");
+const addon = require(${JSON.stringify(addonPath)});
+addon.configureEngine({threads: 1, leafBatch: ${leafBatch}, cacheEntries: 0});
+const board = Uint8Array.from([1, 4, 4, 4, 2, 1, 4, 4, 4, 2, 1, 4, 3, 4, 2, 1, 4, 4, 4, 2, 1, 4, 4, 4, 2]);
+(async () => {
+	await addon.loadModel(${JSON.stringify(modelPath)});
+	await addon.moveAsync({board, difficulty: ${JSON.stringify(difficulty)}});
+	const before = addon.getStats().classes[${JSON.stringify(`rl:${difficulty}`)}];
+	const t0 = performance.now();
+	for (let i = 0; i < ${moves}; i++) await addon.moveAsync({board, difficulty: ${JSON.stringify(difficulty)}});
+	const ms = performance.now() - t0;
+	const after = addon.getStats().classes[${JSON.stringify(`rl:${difficulty}`)}];
+	const simulations = after.units - before.units;
+	console.log(JSON.stringify({
+		msPerMove: ms / ${moves},
+		simsPerSec: simulations / (ms / 1000),
+		meanBatchSize: after.meanBatchSize,
+		simulations
+	}));
+})();
+`;
+
+function main() {
+	const table: Record<string, { msPerMove: string; simsPerSec: string; meanBatchSize: string; speedup: string }> = {};
+	let baseline: number | undefined;
+	for (const leafBatch of batches) {
+		const sample = JSON.parse(execFileSync(process.execPath, ["-e", child(leafBatch)], {encoding: "utf8"}).trim()) as Sample;
+		baseline ??= sample.simsPerSec;
+		table[`K=${leafBatch}`] = {
+			msPerMove: sample.msPerMove.toFixed(1),
+			simsPerSec: sample.simsPerSec.toFixed(0),
+			meanBatchSize: sample.meanBatchSize.toFixed(1),
+			speedup: `${(sample.simsPerSec / baseline).toFixed(2)}x`
+		};
+	}
+
+	console.log(`${difficulty}, ${moves} moves per batch size (neutron + pawn search each), 1 thread`);
+	console.table(table);
+}
+
+main();
@@ -0,0 +1,76 @@
+/*
+* ===============================================================================
+* File Name          : rl-games.ts
+* Creation Date      : 2026-10-18
+* Version            : 1.0.0
+* Author             : Rigoberto L. Salgado Reyes
+* Contact            : rlsalgado2006@gmail.com
+* ===============================================================================
+*/
+// RL throughput with N concurrent games, with and without shared forward passes (RL_INFER_BATCH).
+//
+//   npx tsx bench/rl-games.ts [--addon native/rl/build/Release/neutron_rl_addon.node] [--model data/model.pt]
+//                             [--games 1,2,4,8,16] [--infer-batch 1,64] [--rounds 2] [--difficulty hard]
+//
+// Scheduler options are fixed at startup, so every configuration runs in a fresh node process with
+// the default thread count. The cache is off, so every move is searched.
+import {execFileSync} from "node:child_process";
+import path from "node:path";
+
+function arg(name: string, fallback: string): string {
+	const i = process.argv.indexOf(`--${name}`);
+	return i > 0 && process.argv[i + 1] ? process.argv[i + 1] : fallback;
+}
+
+const addonPath = path.resolve(arg("addon", "native/rl/build/Release/neutron_rl_addon.node"));
+const modelPath = path.resolve(arg("model", "data/model.pt"));
+const games = arg("games", "1,2,4,8,16").split(",").map(Number);
+const inferBatches = arg("infer-batch", "1,64").split(",").map(Number);
+const rounds = Number(arg("rounds", "2"));
+const difficulty = arg("difficulty", "hard");
+
+type Sample = { simsPerSec: number; meanBatchSize: number };
+
+// Runs in the child: `count` games move at once, `rounds` times, after one warm-up move.
+const child = (count: number, inferenceBatch: number) => `
+const {performance} = require("node:perf_hooks");
+const addon = require(${JSON.stringify(addonPath)});
+addon.configureEngine({inferenceBatch: ${inferenceBatch}, cacheEntries: 0});
+const board = Uint8Array.from([1, 4, 4, 4, 2, 1, 4, 4, 4, 2, 1, 4, 3, 4, 2, 1, 4, 4, 4, 2, 1, 4, 4, 4, 2]);
+const key = ${JSON.stringify(`rl:${difficulty}`)};
+(async () => {
+	await addon.loadModel(${JSON.stringify(modelPath)});
+	await addon.moveAsync({board, difficulty: ${JSON.stringify(difficulty)}});
+	const before = addon.getStats().classes[key];
+	const t0 = performance.now();
+	for (let r = 0; r < ${rounds}; r++) {
+		await Promise.all(Array.from({length: ${count}}, () => addon.moveAsync({board, difficulty: ${JSON.stringify(difficulty)}})));
+	}
+	const seconds = (performance.now() - t0) / 1000;
+	const after = addon.getStats().classes[key];
+	console.log(JSON.stringify({
+		simsPerSec: (after.units - before.units) / seconds,
+		meanBatchSize: after.meanBatchSize
+	}));
+})();
+`;
+
+function main() {
+	const table: Record<string, Record<string, string>> = {};
+	for (const count of games) {
+		const row: Record<string, string> = {};
+		for (const inferenceBatch of inferBatches) {
+			const sample = JSON.parse(
+				execFileSync(process.execPath, ["-e", child(count, inferenceBatch)], {encoding: "utf8"}).trim()
+			) as Sample;
+			row[`sims/s batch≤${inferenceBatch}`] = sample.simsPerSec.toFixed(0);
+			row[`mean batch ≤${inferenceBatch}`] = sample.meanBatchSize.toFixed(1);
+		}
+		table[`${count} games`] = row;
+	}
+
+	console.log(`${difficulty}, ${rounds} rounds of concurrent moves per configuration`);
+	console.table(table);
+}
+
+main();
@@ -0,0 +1,80 @@
+/*
+* ===============================================================================
+* File Name          : rl-startup.ts
+* Creation Date      : 2026-10-18
+* Version            : 1.0.0
+* Author             : Rigoberto L. Salgado Reyes
+* Contact            : rlsalgado2006@gmail.com
+* ===============================================================================
+*/
+// Cold start of the RL addon: a fresh node process per run, with and without RL in use.
+//
+//   npx tsx bench/rl-startup.ts [--addon native/rl/build/Release/neutron_rl_addon.node] [--model data/model.pt] [--runs 5]
+//
+// "require" only loads the addon front (what every server instance pays); "require + loadModel"
+// also dlopen()s neutron_rl_engine.so with libtorch and loads the model (first RL game only).
+import {execFileSync} from "node:child_process";
+import path from "node:path";
+
+function arg(name: string, fallback: string): string {
+	const i = process.argv.indexOf(`--${name}`);
+	return i > 0 && process.argv[i + 1] ? process.argv[i + 1] : fallback;
+}
+
+const addonPath = path.resolve(arg("addon", "native/rl/build/Release/neutron_rl_addon.node"));
+const modelPath = path.resolve(arg("model", "data/model.pt"));
+const runs = Number(arg("runs", "5"));
+
+type Sample = { requireMs: number; loadMs: number; rssMb: number; engineLoaded: boolean };
+
+// Runs in the child: times are measured there so process spawn does not count.
+const child = (load: boolean) => `
+const {performance} = require("node:perf_hooks");
+const t0 = performance.now();
+const addon = require(${JSON.stringify(addonPath)});
+const requireMs = performance.now() - t0;
+(async () => {
+	const t1 = performance.now();
+	if (${load}) await addon.loadModel(${JSON.stringify(modelPath)});
+	const loadMs = performance.now() - t1;
+	const rssMb = process.memoryUsage.rss() / 2 ** 20;
+	console.log(JSON.stringify({requireMs, loadMs, rssMb, engineLoaded: addon.engineLoaded()}));
+})();
+`;
+
+function median(values: number[]): number {
+	const sorted = [...values].sort((a, b) => a - b);
+	return sorted[Math.floor(sorted.length / 2)];
+}
+
+function measure(load: boolean): Sample[] {
+	return Array.from({length: runs}, () =>
+		JSON.parse(execFileSync(process.execPath, ["-e", child(load)], {encoding: "utf8"}).trim()) as Sample
+	);
+}
+
+function main() {
+	const baseline = median(
+		Array.from({length: runs}, () =>
+			Number(execFileSync(process.execPath, ["-e", "console.log(process.memoryUsage.rss() / 2 ** 20)"], {encoding: "utf8"}))
+		)
+	);
+
+	const table: Record<string, { requireMs: string; loadModelMs: string; rssMb: string; overNodeMb: string; libtorch: string }> = {};
+	for (const [name, load] of [["require", false], ["require + loadModel", true]] as const) {
+		const samples = measure(load);
+		const rss = median(samples.map((s) => s.rssMb));
+		table[name] = {
+			requireMs: median(samples.map((s) => s.requireMs)).toFixed(1),
+			loadModelMs: load ? median(samples.map((s) => s.loadMs)).toFixed(1) : "-",
+			rssMb: rss.toFixed(1),
+			overNodeMb: (rss - baseline).toFixed(1),
+			libtorch: samples.every((s) => s.engineLoaded) ? "mapped" : "not mapped"
+		};
+	}
+
+	console.log(`node alone: ${baseline.toFixed(1)} MB RSS, ${runs} runs per row (medians)`);
+	console.table(table);
+}
+
+main();
@@ -0,0 +1,90 @@
+/*
+* ===============================================================================
+* File Name          : rl-threads.ts
+* Creation Date      : 2026-10-18
+* Version            : 1.0.0
+* Author             : Rigoberto L. Salgado Reyes
+* Contact            : rlsalgado2006@gmail.com
+* ===============================================================================
+*/
+// One RL game with N scheduler threads on the same MCTS tree (RL_SEARCH_THREADS): simulations per
+// second, time per move, and how often the move matches the single-threaded search.
+//
+//   npx tsx bench/rl-threads.ts [--addon native/rl/build/Release/neutron_rl_addon.node] [--model data/model.pt]
+//                               [--threads 1,2,4,8] [--moves 4] [--difficulty hard]
+//
+// Scheduler options are fixed at startup, so every thread count runs in a fresh node process. The
+// cache is off, so every move is searched; the first move of each process is a warm-up. Each move
+// is searched without a game, so no search reuses the tree of the previous one.
+import {execFileSync} from "node:child_process";
+import path from "node:path";
+
+function arg(name: string, fallback: string): string {
+	const i = process.argv.indexOf(`--${name}`);
+	return i > 0 && process.argv[i + 1] ? process.argv[i + 1] : fallback;
+}
+
+const addonPath = path.resolve(arg("addon", "native/rl/build/Release/neutron_rl_addon.node"));
+const modelPath = path.resolve(arg("model", "data/model.pt"));
+const threads = arg("threads", "1,2,4,8").split(",").map(Number);
+const moves = Number(arg("moves", "4"));
+const difficulty = arg("difficulty", "hard");
+
+// Start position, then two with the neutron and a pawn elsewhere (column-major, BLACK=1, WHITE=2, NEUTRON=3).
+const boards = [
+	[1, 4, 4, 4, 2, 1, 4, 4, 4, 2, 1, 4, 3, 4, 2, 1, 4, 4, 4, 2, 1, 4, 4, 4, 2],
+	[1, 4, 4, 4, 2, 1, 4, 3, 4, 2, 1, 4, 4, 2, 4, 1, 4, 4, 4, 2, 1, 4, 4, 4, 2],
+	[4, 1, 4, 4, 2, 1, 4, 4, 4, 2, 1, 4, 4, 4, 2, 1, 4, 3, 4, 2, 1, 4, 4, 4, 2]
+];
+
+type Sample = { msPerMove: number; simsPerSec: number; played: string[] };
+
+// Runs in the child: `moves` timed moves on every board, after one warm-up move.
+const child = (searchThreads: number) => `
+const {performance} = require("node:perf_hooks");
+const addon = require(${JSON.stringify(addonPath)});
+addon.configureEngine({searchThreads: ${searchThreads}, cacheEntries: 0});
+const boards = ${JSON.stringify(boards)}.map((b) => Uint8Array.from(b));
+const key = ${JSON.stringify(`rl:${difficulty}`)};
+(async () => {
+	await addon.loadModel(${JSON.stringify(modelPath)});
+	await addon.moveAsync({board: boards[0], difficulty: ${JSON.stringify(difficulty)}});
+	const before = addon.getStats().classes[key];
+	const played = [];
+	const t0 = performance.now();
+	for (const board of boards) {
+		for (let i = 0; i < ${moves}; i++) {
+			const result = await addon.moveAsync({board, difficulty: ${JSON.stringify(difficulty)}});
+			played.push(result.moves.map((m) => m.row * 5 + m.col).join(","));
+		}
+	}
+	const ms = performance.now() - t0;
+	const after = addon.getStats().classes[key];
+	console.log(JSON.stringify({
+		msPerMove: ms / played.length,
+		simsPerSec: (after.units - before.units) / (ms / 1000),
+		played
+	}));
+})();
+`;
+
+function main() {
+	const table: Record<string, { msPerMove: string; simsPerSec: string; speedup: string; sameMove: string }> = {};
+	let baseline: Sample | undefined;
+	for (const count of threads) {
+		const sample = JSON.parse(execFileSync(process.execPath, ["-e", child(count)], {encoding: "utf8"}).trim()) as Sample;
+		baseline ??= sample;
+		const same = sample.played.filter((move, i) => move === baseline?.played[i]).length;
+		table[`${count} threads`] = {
+			msPerMove: sample.msPerMove.toFixed(1),
+			simsPerSec: sample.simsPerSec.toFixed(0),
+			speedup: `${(sample.simsPerSec / baseline.simsPerSec).toFixed(2)}x`,
+			sameMove: `${((100 * same) / sample.played.length).toFixed(0)}%`
+		};
+	}
+
+	console.log(`${difficulty}, ${moves} moves on each of ${boards.length} positions per thread count`);
+	console.table(table);
+}
+
+main();
@@ -0,0 +1,145 @@
+/*
+* ===============================================================================
+* File Name          : rules.ts
+* Creation Date      : 2026-10-18
+* Version            : 1.0.0
+* Author             : Rigoberto L. Salgado Reyes
+* Contact            : rlsalgado2006@gmail.com
+* ===============================================================================
+*/
+// Rules on the event loop: the TypeScript move generation engine.ts used to run on every click
+// against the native rules API (legalTargets / gameWinner / legalTurns).
+//
+//   npx tsx bench/rules.ts [--addon path/to/neutron_minimax.node] [--positions 2000] [--rounds 20]
+//
+// Both sides get the same random positions and must agree on every answer before timings are shown.
+import path from "node:path";
+import { performance } from "node:perf_hooks";
+
+function arg(name: string, fallback: string): string {
+	const i = process.argv.indexOf(`--${name}`);
+	return i > 0 && process.argv[i + 1] ? process.argv[i + 1] : fallback;
+}
+
+const addonPath = path.resolve(arg("addon", "native/build/Release/neutron_minimax.node"));
+const positionCount = Number(arg("positions", "2000"));
+const rounds = Number(arg("rounds", "20"));
+
+const addon = require(addonPath);
+
+const BLACK = 1, WHITE = 2, NEUTRON = 3, CELL = 4;
+
+// Previous engine.ts implementation (column-major board, slide until the next cell is not empty).
+const deltas = [[-1, 0], [1, 0], [0, 1], [0, -1], [-1, 1], [-1, -1], [1, 1], [1, -1]];
+
+function tsMoves(board: number[], row: number, col: number): { row: number; col: number }[] {
+	return deltas
+		.map(([dr, dc]) => {
+			let r = row, c = col;
+			while (r + dr >= 0 && r + dr < 5 && c + dc >= 0 && c + dc < 5 && board[(c + dc) * 5 + r + dr] === CELL) {
+				r += dr;
+				c += dc;
+			}
+			return r === row && c === col ? undefined : {row: r, col: c};
+		})
+		.filter((m) => m !== undefined);
+}
+
+function tsWinner(board: number[], mover: number): number {
+	const neutron = board.indexOf(NEUTRON);
+	const row = neutron % 5, col = Math.floor(neutron / 5);
+	if (!tsMoves(board, row, col).length) return mover;
+	if (!row) return BLACK;
+	if (row === 4) return WHITE;
+	return CELL;
+}
+
+function tsTurns(board: number[], player: number): number {
+	const neutron = board.indexOf(NEUTRON);
+	let count = 0;
+	for (const to of tsMoves(board, neutron % 5, Math.floor(neutron / 5))) {
+		const next = board.slice();
+		next[neutron] = CELL;
+		next[to.col * 5 + to.row] = NEUTRON;
+		if (tsWinner(next, player) !== CELL) {
+			count++;
+			continue;
+		}
+		next.forEach((cell, i) => {
+			if (cell === player) count += tsMoves(next, i % 5, Math.floor(i / 5)).length;
+		});
+	}
+	return count;
+}
+
+function randomPosition(): number[] {
+	const cells = Array.from({length: 25}, (_, i) => i).sort(() => Math.random() - 0.5);
+	const board = new Array(25).fill(CELL);
+	board[cells[0]] = NEUTRON;
+	cells.slice(1, 6).forEach((i) => (board[i] = BLACK));
+	cells.slice(6, 11).forEach((i) => (board[i] = WHITE));
+	return board;
+}
+
+function time(run: () => number): { ms: number; checksum: number } {
+	let checksum = 0;
+	const t0 = performance.now();
+	for (let round = 0; round < rounds; round++) checksum += run();
+	return {ms: performance.now() - t0, checksum};
+}
+
+function main() {
+	const positions = Array.from({length: positionCount}, randomPosition);
+	const scratch = new Uint8Array(25);
+	const out = new Int32Array(3 * 320);
+
+	const pieces = (board: number[]) => board.flatMap((cell, i) => (cell === CELL ? [] : [i]));
+
+	const cases = {
+		"targets (every piece)": {
+			ts: () => positions.reduce((n, b) => n + pieces(b).reduce((m, i) => m + tsMoves(b, i % 5, Math.floor(i / 5)).length, 0), 0),
+			native: () => positions.reduce((n, b) => {
+				scratch.set(b);
+				return n + pieces(b).reduce((m, i) => {
+					let mask = addon.legalTargets(scratch, i);
+					for (; mask; mask &= mask - 1) m++;
+					return m;
+				}, 0);
+			}, 0)
+		},
+		"game over": {
+			ts: () => positions.reduce((n, b) => n + tsWinner(b, WHITE), 0),
+			native: () => positions.reduce((n, b) => {
+				scratch.set(b);
+				return n + addon.gameWinner(scratch, WHITE);
+			}, 0)
+		},
+		"legal turns": {
+			ts: () => positions.reduce((n, b) => n + tsTurns(b, BLACK), 0),
+			native: () => positions.reduce((n, b) => {
+				scratch.set(b);
+				return n + addon.legalTurns(scratch, BLACK, out).length / 3;
+			}, 0)
+		}
+	};
+
+	const table: Record<string, { ts: string; native: string; speedup: string }> = {};
+	for (const [name, {ts, native}] of Object.entries(cases)) {
+		ts();
+		native();
+		const a = time(ts);
+		const b = time(native);
+		if (a.checksum !== b.checksum) throw new Error(`${name}: TS and native disagree (${a.checksum} vs ${b.checksum})`);
+
+		const calls = positionCount * rounds;
+		table[name] = {
+			ts: `${((a.ms * 1000) / calls).toFixed(2)} µs`,
+			native: `${((b.ms * 1000) / calls).toFixed(2)} µs`,
+			speedup: `x${(a.ms / b.ms).toFixed(1)}`
+		};
+	}
+
+	console.table(table);
+}
+
+main();
@@ -13,6 +13,8 @@ shell.mkdir("-p", "dist/native/rl/build/Release");
 
 const minimaxAddon = path.join("native", "build", "Release", "neutron_minimax.node");
 const rlAddon = path.join("native", "rl", "build", "Release", "neutron_rl_addon.node");
+// motor libtorch del addon RL; el addon lo busca en su mismo directorio.
+const rlEngine = path.join("native", "rl", "build", "Release", "neutron_rl_engine.so");
 
 if (shell.test("-f", minimaxAddon)) {
 	shell.cp(minimaxAddon, path.join("dist", "native", "build", "Release"));
@@ -21,3 +23,7 @@ if (shell.test("-f", minimaxAddon)) {
 if (shell.test("-f", rlAddon)) {
 	shell.cp(rlAddon, path.join("dist", "native", "rl", "build", "Release"));
 }
+
+if (shell.test("-f", rlEngine)) {
+	shell.cp(rlEngine, path.join("dist", "native", "rl", "build", "Release"));
+}
@@ -1,21 +1,41 @@
 {
   "targets": [{
+    "target_name": "neutron_rules",
+    "type": "none",
+    "direct_dependent_settings": {
+      "include_dirs": [
+        "rules/include"
+      ]
+    }
+  }, {
     "target_name": "neutron_minimax",
     "include_dirs": [
       "include",
       "<!@(node -p \"require('node-addon-api').include\")"
     ],
     "dependencies": [
+      "neutron_rules",
       "<!(node -p \"require('node-addon-api').gyp\")"
     ],
     "sources": [
+      "src/AdmissionControl.cpp",
       "src/Board.cpp",
       "src/cleaners.cpp",
+      "src/CostModel.cpp",
+      "src/EngineAsyncWorker.cpp",
+      "src/EngineScheduler.cpp",
+      "src/EngineStats.cpp",
       "src/FullMove.cpp",
+      "src/GameCodec.cpp",
       "src/gameutils.cpp",
       "src/minimax.cpp",
+      "src/TranspositionTable.cpp",
       "src/Move.cpp",
+      "src/PackedResult.cpp",
+      "src/ResultCache.cpp",
+      "src/SearchPool.cpp",
       "src/MinimaxAsyncWorker.cpp",
+      "src/MinimaxBatchWorker.cpp",
       "src/MinimaxAddon.cpp"
     ],
     "defines": [
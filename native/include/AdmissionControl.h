@@ -0,0 +1,83 @@
+/**
+ * Authors:
+ * Rigoberto Leander Salgado Reyes <rlsalgado2006@gmail.com>
+ *
+ * Copyright 2025 by Rigoberto Leander Salgado Reyes.
+ *
+ * This program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Load shedding in front of the EngineScheduler.
+ *
+ * Keeps an EWMA of the execution time of each cost class ("minimax:4", "rl:hard", ...) and the
+ * expected cost of everything admitted but not finished. A request is expected to complete after
+ * (in-flight cost + own cost) / threads, since time slicing shares the pool between all of them,
+ * and never before its own cost, since one search runs on one thread. When either exceeds the SLO
+ * the request is either rejected (retryable) or served at the most expensive cheaper level that
+ * still fits. With nothing in flight a request is never rejected, and a level without samples
+ * counts as fitting, so every class gets measured at least once.
+ */
+class AdmissionControl {
+   public:
+    using Micros = std::chrono::microseconds;
+
+    enum class Policy { Off, Reject, Downgrade };
+
+    struct Options {
+        Policy policy = Policy::Off;
+        Micros slo{0};
+        double smoothing = 0.2;  // peso de la última muestra en la EWMA
+    };
+
+    // One way of serving a request; `seed` is the cost assumed until the class has samples.
+    struct Level {
+        std::string key;
+        Micros seed;
+    };
+
+    // Reservation of an admitted request; hand it back to complete() when the search ends.
+    struct Ticket {
+        size_t level;
+        std::string key;
+        Micros expected;
+    };
+
+    void configure(const Options& options, unsigned threads);
+
+    // Whether admit() can reject or downgrade at all (a policy and an SLO are set).
+    [[nodiscard]] bool active() const;
+
+    // Levels go from the requested one to the cheapest. Returns the level to run, or nullopt when
+    // the request must be rejected.
+    std::optional<Ticket> admit(const std::vector<Level>& levels);
+
+    void complete(const Ticket& ticket, Micros actual);
+
+    [[nodiscard]] Micros estimate(const std::string& key, Micros seed) const;
+
+    // Expected time for the pool to drain everything already admitted.
+    [[nodiscard]] Micros expectedWait() const;
+
+   private:
+    [[nodiscard]] Micros estimateLocked(const std::string& key, Micros seed) const;
+
+    Options options;
+    unsigned threads{1};
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, double> costs;  // EWMA en microsegundos
+    Micros inflight{0};
+};
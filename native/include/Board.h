@@ -15,7 +15,6 @@
 
 #pragma once
 
-#include <Direction.h>
 #include <FullMove.h>
 #include <Move.h>
 #include <PieceKind.h>
@@ -40,25 +39,15 @@ class Board {
 
     void applyFullMove(const std::unique_ptr<FullMove> &fullMove, bool apply = true);
 
+    [[nodiscard]] const std::array<uint8_t, 25> &cells() const;
+
     // friend std::ostream &operator<<(std::ostream &ostr, const Board &board);
 
    private:
-    static int getRowMove(Direction direction);
-
-    static int getColMove(Direction direction);
-
-    static bool inBounds(int value, int inc);
-
-    [[nodiscard]] std::unique_ptr<Move> checkMove(const std::unique_ptr<Move> &move, const Direction direction) const;
-
-    [[nodiscard]] std::unique_ptr<Move> _check(int row, int col, int incR, int incC) const;
-
     void applyMove(const std::unique_ptr<Move> &from, const std::unique_ptr<Move> &to);
 
     // std::string pieceToString(PieceKind pieceKind) const;
 
-    [[nodiscard]] PieceKind elementAt(int row, int col) const;
-
     void setElementAt(int row, int col, PieceKind pieceKind);
 
     std::array<uint8_t, 25> table{};
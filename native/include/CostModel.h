@@ -0,0 +1,92 @@
+/**
+ * Authors:
+ * Rigoberto Leander Salgado Reyes <rlsalgado2006@gmail.com>
+ *
+ * Copyright 2025 by Rigoberto Leander Salgado Reyes.
+ *
+ * This program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+/**
+ * Predicts how long a minimax search of a position takes at each depth, so a request can ask for
+ * a latency target instead of a fixed depth.
+ *
+ * A position is described by its branching: the BLACK turns at the root (Board::allMoves) and
+ * the mean WHITE replies over a few of them (one-ply probe). The full tree of depth d would hold
+ * raw(d) = root * reply * root * ... nodes; alpha-beta visits about
+ *
+ *   nodes(d) = exp(beta) * raw(d)^alpha
+ *
+ * with alpha and beta fitted by least squares on log-log pairs, older searches weighing less. The
+ * node rate of the host turns nodes into time. Both are seeded by calibrate() at startup and then
+ * follow every search that ends.
+ */
+class CostModel {
+   public:
+    struct Features {
+        double root;   // jugadas de BLACK en la raíz
+        double reply;  // respuestas medias de WHITE
+        bool decided;  // BLACK gana con el neutrón: la búsqueda acaba en un ply
+    };
+
+    struct Prediction {
+        int depth;
+        double nodes;
+        std::chrono::microseconds time;
+    };
+
+    struct Summary {
+        double nodesPerSecond;
+        double alpha;
+        double beta;
+        uint64_t samples;
+    };
+
+    static CostModel &instance();
+
+    // Branching of `board` with BLACK to move.
+    static Features features(const std::array<uint8_t, 25> &board);
+
+    // Deepest depth in [1, maxDepth] whose predicted time fits `budget` (1 when none does; 0 when
+    // maxDepth is 0). Calibrates first when calibrate() was not called.
+    Prediction choose(const Features &features, int maxDepth, std::chrono::microseconds budget);
+
+    Prediction predict(const Features &features, int depth);
+
+    // A finished search of `nodes` nodes that kept a thread busy for `busy`.
+    void record(const Features &features, int depth, uint64_t nodes, std::chrono::microseconds busy);
+
+    // Times a few blocking searches (~100ms) on the calling thread; only the first call does work.
+    Summary calibrate();
+
+    Summary summary();
+
+   private:
+    CostModel();
+
+    static double logRaw(const Features &features, int depth);
+
+    void fit(double x, double y);
+
+    [[nodiscard]] Prediction predictLocked(const Features &features, int depth) const;
+
+    std::once_flag calibrated;
+    std::mutex mutex;
+    // sumas ponderadas de la regresión log(nodos) = alpha * log(raw) + beta.
+    double w{0}, wx{0}, wy{0}, wxx{0}, wxy{0};
+    double alpha{0};
+    double beta{0};
+    double nodesPerMicro{1.0};
+    uint64_t samples{0};
+};
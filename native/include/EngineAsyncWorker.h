@@ -0,0 +1,176 @@
+/**
+ * Authors:
+ * Rigoberto Leander Salgado Reyes <rlsalgado2006@gmail.com>
+ *
+ * Copyright 2025 by Rigoberto Leander Salgado Reyes.
+ *
+ * This program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ */
+
+#pragma once
+#include <napi.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+
+#include "EngineScheduler.h"
+
+/**
+ * Same contract as Napi::AsyncWorker, but Execute() runs on the EngineScheduler pool and the
+ * result comes back to the event loop through a thread-safe function.
+ *
+ * Long searches override ExecuteSlice() instead, doing a bounded amount of work per call so the
+ * scheduler can interleave them with other requests.
+ */
+class EngineAsyncWorker {
+   public:
+    explicit EngineAsyncWorker(Napi::Env env);
+    virtual ~EngineAsyncWorker();
+
+    // Takes ownership: the worker deletes itself after OnOK()/OnError().
+    void Queue(std::chrono::microseconds slack);
+
+    // Run time and counters of this search are reported under the ticket's class.
+    void SetTicket(AdmissionControl::Ticket ticket);
+
+    // Same, for work that does not go through admission control.
+    void SetClass(const std::string& key);
+
+    // Queue() waits for a slot of `pool` before submitting; the slot is held until the search ends.
+    void SetPool(SearchPool& pool);
+
+    // Answers from the ResultCache when `key` is cached (resolved right away) or already being
+    // searched (resolved when that search ends); the worker must not be used afterwards. Returns
+    // false on a miss: the caller runs the search with Lead() and Queue().
+    bool Serve(const ResultCache::Key& key, ClassStats& requested);
+
+    // Lets identical requests join this search and caches its result under `key`.
+    void Lead(ResultCache::Key key);
+
+    // Reads {onProgress?, progressIntervalMs?} from the request; call before Serve()/Queue().
+    void SetProgress(const Napi::Object& input);
+
+    // Retryable rejection for requests refused by admission control (code ENGINE_OVERLOADED).
+    static Napi::Error Overloaded(Napi::Env env);
+
+    // Shares one scheduler between every addon loaded in the process; call from module Init, which
+    // runs once per environment (main thread and each worker_thread).
+    static void Attach(Napi::Env env);
+
+    // JS: configureEngine({threads?, pinThreads?, sliceNodes?, sliceSimulations?, leafBatch?, searchThreads?, inferenceBatch?, inferenceWaitUs?, evalCacheEntries?, inferencePrecision?, rlPoolSize?, sloMs?, overloadPolicy?, cacheEntries?}): boolean
+    static Napi::Value Configure(const Napi::CallbackInfo& info);
+
+    // JS: getStats(): {threads, queueDepth, expectedWaitMs, cache: {...}, rlPool: {...}, classes: {[key]: {...}}}
+    static Napi::Value Stats(const Napi::CallbackInfo& info);
+
+   protected:
+    virtual void Execute() {  // hilo del scheduler
+    }
+
+    // Returns true once the work is complete; the default runs Execute() in a single slice.
+    virtual bool ExecuteSlice() {
+        Execute();
+        return true;
+    }
+
+    // Number of scheduler jobs Queue() submits; they run in parallel and the worker completes
+    // when every lane has returned true.
+    [[nodiscard]] virtual unsigned Lanes() const {
+        return 1;
+    }
+
+    virtual bool ExecuteLane(unsigned lane) {
+        (void)lane;
+        return ExecuteSlice();
+    }
+
+    // Nodes or simulations searched so far, reported to EngineStats when the search ends.
+    [[nodiscard]] virtual uint64_t WorkUnits() const {
+        return 0;
+    }
+
+    // Finished result in cache form, and the way back for requests served from the cache.
+    [[nodiscard]] virtual ResultCache::Value CacheValue() const {
+        return {};
+    }
+
+    virtual void Adopt(const ResultCache::Value& value) {
+        (void)value;
+    }
+
+    // Scheduler thread, once a search has succeeded: `busy` is the pool time of every lane.
+    virtual void Completed(ClassStats* stats, uint64_t units, std::chrono::microseconds busy) {
+        (void)stats;
+        (void)units;
+        (void)busy;
+    }
+
+    virtual void OnOK() = 0;  // hilo principal
+    virtual void OnError(const Napi::Error& e) = 0;
+
+    // Scheduler thread, environment closing: the worker is deleted off the JS thread, so references
+    // to JS values are let go without freeing them (they die with the environment).
+    virtual void DropHandles();
+
+    // Builds the onProgress payload from the snapshot taken before EmitProgress().
+    virtual void OnProgress(Napi::Env env, Napi::Function callback) {
+        (void)env;
+        (void)callback;
+    }
+
+    [[nodiscard]] bool WantsProgress() const;
+
+    // Scheduler thread. True when onProgress was given, the previous report was delivered and
+    // the interval has passed; then take a snapshot and call EmitProgress().
+    [[nodiscard]] bool ProgressDue() const;
+
+    void EmitProgress();
+
+    void SetError(const std::string& error);
+
+    [[nodiscard]] Napi::Env Env() const;
+
+   private:
+    // Progress and completion share one thread-safe function: calls arrive in order, so no
+    // progress report can run after the worker was deleted.
+    enum class Message { Progress, Done };
+
+    static void CallJs(Napi::Env env, Napi::Function callback, EngineAsyncWorker* worker, const Message* message);
+
+    using Completion = Napi::TypedThreadSafeFunction<EngineAsyncWorker, const Message, &EngineAsyncWorker::CallJs>;
+
+    void Submit(std::chrono::microseconds slack);
+
+    bool Step(unsigned lane);
+
+    void Arm();
+
+    void Finish();
+
+    Napi::Env env;
+    Completion completion;
+    bool armed{false};
+    Napi::FunctionReference onProgress;
+    std::chrono::milliseconds progressInterval{100};
+    std::chrono::steady_clock::time_point lastProgress{};
+    std::atomic<bool> progressPending{false};
+    std::mutex errorMutex;
+    std::string errorMessage;
+    std::atomic<bool> failed{false};
+    std::optional<AdmissionControl::Ticket> ticket;
+    std::optional<ResultCache::Key> cacheKey;
+    ClassStats* stats{nullptr};
+    SearchPool* pool{nullptr};
+    std::chrono::steady_clock::time_point queuedAt;
+    std::atomic<bool> started{false};
+    std::atomic<unsigned> lanesLeft{1};
+    std::atomic<int64_t> busyMicros{0};  // suma de todas las lanes
+};
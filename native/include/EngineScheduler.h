@@ -0,0 +1,128 @@
+/**
+ * Authors:
+ * Rigoberto Leander Salgado Reyes <rlsalgado2006@gmail.com>
+ *
+ * Copyright 2025 by Rigoberto Leander Salgado Reyes.
+ *
+ * This program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include "AdmissionControl.h"
+#include "EngineStats.h"
+#include "ResultCache.h"
+#include "SearchPool.h"
+
+/**
+ * Dedicated pool of engine threads, shared by the minimax and RL addons.
+ *
+ * Searches no longer run on the libuv threadpool, so a deep search cannot delay fs/dns/crypto work.
+ * Jobs are ordered by a virtual deadline (submission time + slack): cheap requests get a small
+ * slack and overtake deep ones.
+ *
+ * A job runs one time slice per call and returns whether it finished; unfinished jobs go back to
+ * the queue with a fresh deadline (now + slack), so in-flight searches are multiplexed round-robin.
+ * The fresh deadline is capped at submission time + 2 × slack: once a search reaches it, the
+ * deadline stops moving, and cheap requests submitted after that point no longer overtake it.
+ * A steady stream of cheap work can therefore delay a deep search but cannot starve it.
+ */
+class EngineScheduler {
+   public:
+    struct Options {
+        unsigned threads = 0;  // 0 → std::thread::hardware_concurrency()
+        bool pinThreads = false;
+        unsigned sliceNodes = 20000;     // minimax nodes per time slice
+        unsigned sliceSimulations = 16;  // MCTS simulations per time slice
+        unsigned leafBatch = 1;          // MCTS leaves per forward pass (virtual loss); 1 = one per simulation
+        unsigned searchThreads = 1;      // scheduler threads sharing one MCTS tree (tree parallelism)
+        size_t inferenceBatch = 64;      // RL positions per forward pass shared by all searches; 1 = no sharing
+        std::chrono::microseconds inferenceWait{1000};  // longest an RL leaf waits for others to share its pass
+        size_t evalCacheEntries = 65536;  // RL positions whose network evaluation is kept per model; 0 = off
+        bool int8Inference = false;       // RL models loaded as INT8 (exported weights only)
+        unsigned rlPoolSize = 0;          // RL searches running at once, the rest wait (SearchPool); 0 = no bound
+        size_t cacheEntries = 4096;      // ResultCache capacity; 0 disables caching and coalescing
+        AdmissionControl::Options admission;
+    };
+
+    // Returns true when done; false re-queues the job for another slice.
+    using Job = std::function<bool()>;
+
+    EngineScheduler();
+    explicit EngineScheduler(Options options);
+    ~EngineScheduler();
+
+    EngineScheduler(const EngineScheduler &) = delete;
+    EngineScheduler &operator=(const EngineScheduler &) = delete;
+
+    // Process-wide scheduler of this module (see adopt()).
+    static EngineScheduler &instance();
+
+    // Makes instance() return a scheduler created by a sibling addon, so both share capacity.
+    static void adopt(EngineScheduler *scheduler);
+
+    // Only allowed before the first submit(); returns false once the workers are running.
+    bool configure(const Options &options);
+
+    void submit(std::chrono::microseconds slack, Job job);
+
+    [[nodiscard]] const Options &config() const;
+
+    AdmissionControl &admission();
+
+    EngineStats &stats();
+
+    ResultCache &cache();
+
+    SearchPool &rlPool();
+
+    [[nodiscard]] unsigned threadCount() const;
+
+    [[nodiscard]] size_t queueDepth() const;
+
+   private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        Clock::time_point deadline;
+        Clock::time_point latest;  // tope del plazo al volver a la cola: llegada + 2 × slack
+        uint64_t sequence;
+        std::chrono::microseconds slack;
+        Job job;
+
+        bool operator>(const Entry &other) const {
+            return deadline != other.deadline ? deadline > other.deadline : sequence > other.sequence;
+        }
+    };
+
+    void start();
+
+    void workerLoop(unsigned index);
+
+    static void pinCurrentThread(unsigned index);
+
+    Options options;
+    AdmissionControl admissionControl;
+    EngineStats engineStats;
+    ResultCache resultCache;
+    SearchPool rlSearchPool;
+    mutable std::mutex mutex;
+    std::condition_variable wakeUp;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<>> queue;
+    std::vector<std::thread> workers;
+    uint64_t nextSequence{0};
+    bool stopping{false};
+};
@@ -0,0 +1,114 @@
+/**
+ * Authors:
+ * Rigoberto Leander Salgado Reyes <rlsalgado2006@gmail.com>
+ *
+ * Copyright 2025 by Rigoberto Leander Salgado Reyes.
+ *
+ * This program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "EngineStats.h"
+#include "FullMove.h"
+
+#if defined(ENGINE_WITH_RL)
+#include "neutron_rl/agent.hpp"
+#endif
+
+/**
+ * State of one engine process speaking the line protocol (UCI-like) on stdin/stdout:
+ *
+ *   neutron                         → id/option lines, then "neutronok"
+ *   isready                         → "readyok"
+ *   setoption name <id> value <x>   SliceNodes, MaxDepth, Model (RL builds)
+ *   newgame                         back to the initial position
+ *   position startpos|board <25 digits> [moves <m>...]
+ *   go [depth N] [movetime ms] [infinite]       minimax (iterative deepening)
+ *   go rl easy|medium|hard | go simulations N   RL agent
+ *   stop | stats | d | quit
+ *
+ * Boards are the addon's column-major digits (1=BLACK, 2=WHITE, 3=NEUTRON, 4=CELL). A move is
+ * four squares, neutron from/to then pawn from/to, e.g. "c3b4b1b3" (column a-e, row 5 is the
+ * black home row). The engine always answers with black's move, like the addons.
+ */
+class EngineSession {
+   public:
+    explicit EngineSession(std::ostream &out);
+    ~EngineSession();
+
+    EngineSession(const EngineSession &) = delete;
+    EngineSession &operator=(const EngineSession &) = delete;
+
+    // Returns false after "quit".
+    bool handle(const std::string &line);
+
+    // Loads the RL model (same as "setoption name Model value <path>").
+    void loadModel(const std::string &path);
+
+   private:
+    using Clock = std::chrono::steady_clock;
+
+    struct GoLimits {
+        int depth = 0;
+        std::chrono::milliseconds movetime{0};
+        bool infinite = false;
+        std::string rlDifficulty;
+        int simulations = 0;
+    };
+
+    void identify();
+    void setOption(std::istringstream &args);
+    void setPosition(std::istringstream &args);
+    void go(std::istringstream &args);
+    void stop();
+    void printStats();
+    void printBoard();
+
+    void searchMinimax(std::array<uint8_t, 25> position, GoLimits limits);
+#if defined(ENGINE_WITH_RL)
+    void searchRl(std::array<uint8_t, 25> position, GoLimits limits);
+#endif
+
+    bool shouldStop(Clock::time_point deadline) const;
+    void record(const std::string &key, Clock::time_point started, uint64_t units, bool stopped);
+    void say(const std::string &line);
+
+    static std::string formatMove(const FullMove &fullMove);
+    static int squareIndex(const std::string &square);
+
+    std::ostream &out;
+    std::mutex outMutex;
+
+    std::array<uint8_t, 25> position{};
+    unsigned sliceNodes{20000};
+    int maxDepth{12};
+    EngineStats stats;
+
+    std::thread searcher;
+    std::atomic<bool> stopRequested{false};
+
+#if defined(ENGINE_WITH_RL)
+    unsigned sliceSimulations{16};
+    int leafBatch{1};
+    size_t evalCacheEntries{65536};  // se aplica al cargar el modelo
+    neutron_rl::InferencePrecision precision{neutron_rl::InferencePrecision::Float32};  // ídem
+    std::shared_ptr<neutron_rl::NeutronAgent> agent;
+    neutron_rl::SearchTree tree;  // reutilizado entre "go rl" hasta newgame o un modelo nuevo
+#endif
+};
@@ -0,0 +1,105 @@
+/**
+ * Authors:
+ * Rigoberto Leander Salgado Reyes <rlsalgado2006@gmail.com>
+ *
+ * Copyright 2025 by Rigoberto Leander Salgado Reyes.
+ *
+ * This program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+/**
+ * HDR-style histogram: log-linear buckets (8 per power of two, <= 12.5% relative error) over the
+ * whole uint64_t range. record() is a few relaxed atomic adds, cheap enough to leave always on.
+ */
+class Histogram {
+   public:
+    struct Summary {
+        uint64_t count;
+        uint64_t max;
+        double mean;
+        uint64_t p50;
+        uint64_t p90;
+        uint64_t p99;
+        uint64_t p999;
+    };
+
+    void record(uint64_t value);
+
+    [[nodiscard]] Summary summary() const;
+
+   private:
+    static constexpr unsigned kSubBits = 3;
+    static constexpr unsigned kSubBuckets = 1u << kSubBits;
+    static constexpr unsigned kBuckets = (64 - kSubBits + 1) * kSubBuckets;
+
+    static unsigned bucketOf(uint64_t value);
+    static uint64_t highestIn(unsigned bucket);
+
+    std::array<std::atomic<uint64_t>, kBuckets> buckets{};
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> sum{0};
+    std::atomic<uint64_t> max{0};
+};
+
+// Counters of one cost class ("minimax:4", "rl:hard", ...); see AdmissionControl for the keys.
+struct ClassStats {
+    std::atomic<uint64_t> requests{0};
+    std::atomic<uint64_t> completed{0};
+    std::atomic<uint64_t> failed{0};
+    std::atomic<uint64_t> rejected{0};
+    std::atomic<uint64_t> downgraded{0};  // pedidas en esta clase y servidas en una más barata
+    std::atomic<uint64_t> cancelled{0};   // resultado descartado: el entorno JS ya no existía
+    std::atomic<uint64_t> cacheHits{0};   // servidas desde ResultCache sin buscar
+    std::atomic<uint64_t> coalesced{0};   // unidas a una búsqueda idéntica en curso
+    std::atomic<uint64_t> units{0};       // nodos minimax o simulaciones MCTS
+    std::atomic<uint64_t> busyMicros{0};
+    std::atomic<uint64_t> ttProbes{0};
+    std::atomic<uint64_t> ttHits{0};
+    std::atomic<uint64_t> inferences{0};
+    std::atomic<uint64_t> inferredPositions{0};
+    std::atomic<uint64_t> reusedVisits{0};  // visitas MCTS heredadas del árbol de la jugada anterior
+    std::atomic<uint64_t> evalProbes{0};    // hojas MCTS buscadas en la caché de evaluaciones del modelo
+    std::atomic<uint64_t> evalHits{0};      // ... y servidas desde ella sin pasar por la red
+
+    Histogram poolWaitMicros;  // esperando hueco en el SearchPool, antes de la cola
+    Histogram queueWaitMicros;
+    Histogram executionMicros;
+    Histogram unitsPerSearch;
+    Histogram predictionErrorPct;  // |real / previsto - 1| del CostModel, en %
+    Histogram inferenceMicros;
+    Histogram batchSize;
+
+    // Class of the search running on this thread, for code that cannot see the worker (NN calls).
+    static ClassStats *current();
+    static void setCurrent(ClassStats *stats);
+};
+
+/**
+ * Registry of ClassStats, owned by the EngineScheduler so both addons report into the same place.
+ * Lookups take a mutex and happen once per request on the main thread; recording is lock-free.
+ */
+class EngineStats {
+   public:
+    ClassStats &forClass(const std::string &key);
+
+    void forEach(const std::function<void(const std::string &, const ClassStats &)> &visit) const;
+
+   private:
+    mutable std::mutex mutex;
+    std::map<std::string, std::unique_ptr<ClassStats>> classes;
+};
@@ -0,0 +1,89 @@
+/**
+ * Authors:
+ * Rigoberto Leander Salgado Reyes <rlsalgado2006@gmail.com>
+ *
+ * Copyright 2025 by Rigoberto Leander Salgado Reyes.
+ *
+ * This program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ */
+
+#pragma once
+
+#include <Rules.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+/**
+ * Binary form of positions and game records, for storage and event logs.
+ *
+ * A position (5 BLACK, 5 WHITE, 1 NEUTRON) is ranked combinatorially: neutron cell, then the
+ * BLACK cells among the 24 left, then the WHITE cells among the 19 left, times 4 for the phase.
+ * The key stays below 2^36 and is stored in 5 bytes.
+ *
+ * A full move takes 16 bits: neutron destination, pawn origin and pawn destination (5 bits
+ * each). The neutron origin and the pawn kind come from replaying the game from its start.
+ *
+ * A game record is:
+ *
+ *   kFormat, flags, start key (5), board key (5), zigzag version, difficulty,
+ *   [selected], [neutronFrom], [neutronTo], move count, moves (2 each), [zigzag scores]
+ *
+ * where integers are LEB128 varints and optional cells are one byte each. Highlighted cells are
+ * not stored: decode() highlights the selected piece and its targets again, as engine.ts does.
+ */
+namespace codec {
+
+using Cells = rules::Cells;
+
+constexpr int kNone = rules::kNone;
+constexpr size_t kPositionBytes = 5;
+
+// First byte of every record; a stored JSON state starts with '{' instead.
+constexpr uint8_t kFormat = 0xB1;
+
+// One full move as engine.ts records it, cells as col * 5 + row.
+struct PlayedMove {
+    int neutronFrom;
+    int neutronTo;
+    int pawnFrom;
+    int pawnTo;
+    uint8_t pawnKind;
+};
+
+struct Game {
+    Cells start{};
+    Cells board{};  // current board, highlights included
+    int phase{0};   // GameState.whoMove
+    int64_t version{0};
+    uint32_t difficulty{0};
+    int selected{kNone};
+    int neutronFrom{kNone};
+    int neutronTo{kNone};
+    std::vector<PlayedMove> moves;
+    std::vector<double> scores;  // one per move
+};
+
+// Key of a position, or nullopt when it does not hold 5 BLACK, 5 WHITE and 1 NEUTRON or phase is not 0-3.
+std::optional<uint64_t> rank(const Cells &board, int phase);
+
+// Position of a key; throws std::invalid_argument when the key is out of range.
+Cells unrank(uint64_t key, int &phase);
+
+// Record of a game, or nullopt when it cannot be stored exactly (non-standard position, moves that
+// do not replay from `start`, non-integer scores, highlights that engine.ts would not produce).
+std::optional<std::vector<uint8_t>> encode(const Game &game);
+
+// Throws std::invalid_argument on a malformed record.
+Game decode(const uint8_t *data, size_t size);
+
+// Plain board after the first `plies` moves of a decoded game.
+Cells replay(const Game &game, size_t plies);
+
+}  // namespace codec
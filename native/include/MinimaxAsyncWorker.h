@@ -18,22 +18,76 @@
 
 #include <array>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
 
+#include "Board.h"
+#include "CostModel.h"
+#include "EngineAsyncWorker.h"
 #include "FullMove.h"
+#include "PackedResult.h"
+#include "SearchTask.h"
 
-class MinimaxAsyncWorker : public Napi::AsyncWorker {
+class MinimaxAsyncWorker : public EngineAsyncWorker {
    public:
-    MinimaxAsyncWorker(Napi::Env env, std::array<uint8_t, 25> pboard, int pdepth, Napi::Promise::Deferred pdeferred)
-        : Napi::AsyncWorker(env), inputBoard(pboard), depth(pdepth), deferred(std::move(pdeferred)) {
+    MinimaxAsyncWorker(Napi::Env env, std::array<uint8_t, 25> pboard, int pdepth, PackedResult ppacked, Napi::Promise::Deferred pdeferred)
+        : EngineAsyncWorker(env), inputBoard(pboard), depth(pdepth), packed(std::move(ppacked)), deferred(std::move(pdeferred)) {
     }
 
-    void Execute() override;  // hilo worker → llama a tu minimax existente
-    void OnOK() override;     // resuelve promesa
+    // holgura de planificación: las búsquedas poco profundas adelantan a las profundas.
+    static std::chrono::microseconds slackFor(int depth);
+
+    // Niveles de admisión: la profundidad pedida y cada profundidad menor hasta 1 (depth 0 no se degrada),
+    // con el coste que el CostModel prevé para `features` mientras la clase no tenga mediciones (sin
+    // features, con admisión desactivada, la holgura).
+    static std::vector<AdmissionControl::Level> levelsFor(int depth, const std::optional<CostModel::Features>& features);
+
+    // Profundidad finalmente asignada por el control de admisión.
+    void SetDepth(const int pdepth) {
+        depth = static_cast<uint8_t>(pdepth);
+    }
+
+    // Ramificación ya calculada en el hilo principal; si no, Completed() la calcula en el del scheduler.
+    void SetFeatures(const CostModel::Features& pfeatures) {
+        features = pfeatures;
+    }
+
+    // Búsqueda elegida por el CostModel: al terminar se mide el error de la predicción.
+    void SetPrediction(const CostModel::Prediction& pprediction) {
+        prediction = pprediction;
+    }
+
+    // Clave de ResultCache: mismo tablero y profundidad dan la misma jugada.
+    static ResultCache::Key cacheKey(const std::array<uint8_t, 25>& board, int depth);
+
+    bool ExecuteSlice() override;  // hilo worker → avanza la búsqueda un slice
+    [[nodiscard]] uint64_t WorkUnits() const override;
+    [[nodiscard]] ResultCache::Value CacheValue() const override;
+    void Adopt(const ResultCache::Value& value) override;
+    void Completed(ClassStats* stats, uint64_t units, std::chrono::microseconds busy) override;
+    void OnOK() override;          // resuelve promesa
     void OnError(const Napi::Error& e) override;
+    void DropHandles() override;
+    void OnProgress(Napi::Env env, Napi::Function callback) override;
 
    private:
+    void ReportProgress();
+
     std::array<uint8_t, 25> inputBoard;
     uint8_t depth;
-    std::unique_ptr<FullMove> result;
+    std::unique_ptr<Board> board;
+    SearchSlice slice{EngineScheduler::instance().config().sliceNodes};
+    std::optional<SearchTask<std::unique_ptr<FullMove>>> search;
+    int searching{0};             // profundidad en curso (con onProgress se profundiza de 1 en 1)
+    ResultCache::Value best{};    // última profundidad completa
+    ResultCache::Value result{};
+    std::mutex progressMutex;
+    ResultCache::Value progress{};
+    uint64_t progressNodes{0};
+    std::optional<CostModel::Features> features;
+    std::optional<CostModel::Prediction> prediction;
+    std::optional<double> predictionError;  // real / previsto - 1
+    PackedResult packed;
     Napi::Promise::Deferred deferred;
 };
@@ -0,0 +1,70 @@
+/**
+ * Authors:
+ * Rigoberto Leander Salgado Reyes <rlsalgado2006@gmail.com>
+ *
+ * Copyright 2025 by Rigoberto Leander Salgado Reyes.
+ *
+ * This program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ */
+
+#pragma once
+#include <napi.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "Board.h"
+#include "EngineAsyncWorker.h"
+#include "FullMove.h"
+#include "SearchTask.h"
+#include "TranspositionTable.h"
+
+/**
+ * Minimax over many positions for offline analysis: one lane per scheduler thread pulls the next
+ * position from a shared counter, and all lanes share one TranspositionTable. Results are packed
+ * per position with the PackedResult layout (kLength int32 each) into a single Int32Array.
+ */
+class MinimaxBatchWorker : public EngineAsyncWorker {
+   public:
+    MinimaxBatchWorker(Napi::Env env,
+                       std::vector<std::array<uint8_t, 25>> pboards,
+                       int pdepth,
+                       size_t ttEntries,
+                       Napi::Reference<Napi::Int32Array> pout,
+                       Napi::Promise::Deferred pdeferred);
+
+    [[nodiscard]] unsigned Lanes() const override;
+    bool ExecuteLane(unsigned lane) override;  // hilo del scheduler
+    [[nodiscard]] uint64_t WorkUnits() const override;
+    void OnOK() override;
+    void OnError(const Napi::Error& e) override;
+    void DropHandles() override;
+
+   private:
+    struct Lane {
+        explicit Lane(TranspositionTable& table) : tt(table.cursor()) {
+        }
+
+        size_t position{0};
+        std::unique_ptr<Board> board;
+        SearchSlice slice{EngineScheduler::instance().config().sliceNodes};
+        std::optional<SearchTask<std::unique_ptr<FullMove>>> search;
+        TranspositionTable::Cursor tt;
+    };
+
+    std::vector<std::array<uint8_t, 25>> boards;
+    uint8_t depth;
+    TranspositionTable table;
+    std::vector<std::unique_ptr<Lane>> lanes;
+    std::atomic<size_t> next{0};
+    std::vector<int32_t> results;
+    Napi::Reference<Napi::Int32Array> out;
+    Napi::Promise::Deferred deferred;
+};
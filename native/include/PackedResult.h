@@ -0,0 +1,60 @@
+/**
+ * Authors:
+ * Rigoberto Leander Salgado Reyes <rlsalgado2006@gmail.com>
+ *
+ * Copyright 2025 by Rigoberto Leander Salgado Reyes.
+ *
+ * This program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ */
+
+#pragma once
+#include <napi.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Compact search result, filled on the scheduler thread and copied into one Int32Array in OnOK():
+ *
+ *   [score, count, row0, col0, kind0, ..., row3, col3, kind3, level]
+ *
+ * `level` is the depth or simulation count the search actually ran with (see AdmissionControl).
+ * Requested with {packed: true} or {out: Int32Array}; with `out` the caller's buffer is reused and
+ * no JS object is allocated for the result at all.
+ */
+class PackedResult {
+   public:
+    static constexpr size_t kMaxMoves = 4;
+    static constexpr size_t kHeader = 2;
+    static constexpr size_t kLevel = kHeader + 3 * kMaxMoves;
+    static constexpr size_t kLength = kLevel + 1;
+
+    PackedResult() = default;
+
+    // Reads {packed?, out?} from the request object; throws TypeError on a short `out`.
+    static PackedResult FromInput(Napi::Env env, const Napi::Object& input);
+
+    [[nodiscard]] bool Enabled() const;
+
+    void SetScore(int32_t score);
+
+    void Push(int32_t row, int32_t col, int32_t kind);
+
+    void SetLevel(int32_t level);
+
+    // Main thread: writes into the caller's buffer (or a new one) and returns it.
+    [[nodiscard]] Napi::Value ToValue(Napi::Env env) const;
+
+    // Lets go of the caller's buffer without freeing the reference (see EngineAsyncWorker::DropHandles).
+    void DropHandles();
+
+   private:
+    bool enabled{false};
+    Napi::Reference<Napi::Int32Array> out;
+    std::array<int32_t, kLength> values{};
+};
@@ -0,0 +1,104 @@
+/**
+ * Authors:
+ * Rigoberto Leander Salgado Reyes <rlsalgado2006@gmail.com>
+ *
+ * Copyright 2025 by Rigoberto Leander Salgado Reyes.
+ *
+ * This program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Bounded LRU of finished searches, with coalescing of identical in-flight requests.
+ *
+ * Many games sit in the same opening position at the same difficulty, so a deterministic search
+ * (minimax, or MCTS at temperature 0) is answered once: later requests hit the LRU, and requests
+ * that arrive while it still runs wait for that search instead of starting their own.
+ */
+class ResultCache {
+   public:
+    // `klass` is the cost class ("minimax:4", "rl:hard"); `model` tells RL models apart (0 for minimax).
+    struct Key {
+        std::array<uint8_t, 25> board;
+        uint8_t side;
+        std::string klass;
+        uint64_t model;
+
+        bool operator==(const Key &other) const = default;
+    };
+
+    struct Move {
+        int row;
+        int col;
+        int kind;
+    };
+
+    struct Value {
+        double score;
+        int level;  // profundidad o simulaciones con que se jugó
+        std::vector<Move> moves;
+    };
+
+    // Called once when the search being waited for ends: `value` is null and `error` set on failure.
+    using Waiter = std::function<void(const Value *value, const std::string &error)>;
+
+    enum class Outcome { Hit, Joined, Miss };
+
+    struct Summary {
+        size_t entries;
+        size_t capacity;
+        size_t inflight;
+        uint64_t hits;
+        uint64_t coalesced;
+        uint64_t misses;
+        uint64_t evictions;
+    };
+
+    // 0 disables the cache (and coalescing).
+    void configure(size_t capacity);
+
+    // Hit copies the cached value into `out`; Joined keeps `waiter` until publish(); Miss ignores it
+    // and the caller is expected to run the search, announcing it with begin().
+    Outcome find(const Key &key, Value &out, Waiter waiter);
+
+    // Marks `key` as being searched so identical requests join it.
+    void begin(const Key &key);
+
+    // Ends the search started with begin(): caches `value` (unless null) and wakes its waiters.
+    void publish(const Key &key, const Value *value, const std::string &error);
+
+    [[nodiscard]] Summary summary() const;
+
+   private:
+    struct KeyHash {
+        size_t operator()(const Key &key) const;
+    };
+
+    using Lru = std::list<std::pair<Key, Value>>;
+
+    mutable std::mutex mutex;
+    size_t capacity{4096};
+    Lru lru;  // más reciente al frente
+    std::unordered_map<Key, Lru::iterator, KeyHash> entries;
+    std::unordered_map<Key, std::vector<Waiter>, KeyHash> inflight;
+
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> coalesced{0};
+    std::atomic<uint64_t> misses{0};
+    std::atomic<uint64_t> evictions{0};
+};
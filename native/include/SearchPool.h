@@ -0,0 +1,57 @@
+/**
+ * Authors:
+ * Rigoberto Leander Salgado Reyes <rlsalgado2006@gmail.com>
+ *
+ * Copyright 2025 by Rigoberto Leander Salgado Reyes.
+ *
+ * This program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+/**
+ * Bound on the RL searches running at once on the EngineScheduler.
+ *
+ * Time slicing starts every admitted search right away and shares the threads between all of
+ * them, so with many games in flight each move takes as long as all of them together, and each
+ * one keeps its tree in memory meanwhile. With a size, searches past it wait here in arrival
+ * order and start when a running one ends. Searches share the agent and its model (read-only),
+ * so a slot is only the right to run, not a copy of the network.
+ */
+class SearchPool {
+   public:
+    using Start = std::function<void()>;
+
+    struct Summary {
+        unsigned size;  // 0 = sin límite
+        unsigned active;
+        size_t waiting;
+    };
+
+    void configure(unsigned size);
+
+    // Runs `start` now when a slot is free; otherwise leave() of a running search runs it, on
+    // that search's thread.
+    void enter(Start start);
+
+    // Hands the slot of a finished search to the oldest waiting one.
+    void leave();
+
+    [[nodiscard]] Summary summary() const;
+
+   private:
+    mutable std::mutex mutex;
+    unsigned size{0};
+    unsigned active{0};
+    std::deque<Start> waiting;
+};
@@ -0,0 +1,267 @@
+/**
+ * Authors:
+ * Rigoberto Leander Salgado Reyes <rlsalgado2006@gmail.com>
+ *
+ * Copyright 2025 by Rigoberto Leander Salgado Reyes.
+ *
+ * This program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ */
+
+#pragma once
+
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <optional>
+#include <utility>
+
+/**
+ * Work budget of one time slice. A search calls `co_await slice.checkpoint()` once per node (or
+ * simulation); after `budget` of them the whole coroutine chain suspends and step() returns.
+ * A budget of 0 never yields.
+ *
+ * Control transfers between parent and child searches bounce through step() (a trampoline)
+ * instead of symmetric transfer, which GCC only turns into tail calls when optimizing.
+ */
+struct SearchSlice {
+    explicit SearchSlice(const uint64_t pbudget = 0) : budget(pbudget), nextYield(pbudget) {
+    }
+
+    struct Checkpoint {
+        SearchSlice &slice;
+
+        [[nodiscard]] bool await_ready() const noexcept {
+            return !slice.budget || slice.units < slice.nextYield;
+        }
+
+        void await_suspend(const std::coroutine_handle<> handle) noexcept {
+            slice.resumePoint = handle;
+            slice.yielded = true;
+            slice.nextYield = slice.units + slice.budget;
+        }
+
+        void await_resume() const noexcept {
+        }
+    };
+
+    Checkpoint checkpoint() {
+        ++units;
+        return Checkpoint{*this};
+    }
+
+    // Ends the slice now without counting a unit: for a search waiting on other threads.
+    Checkpoint pause() {
+        nextYield = units;
+        return Checkpoint{*this};
+    }
+
+    // Resumes `root` (or wherever the search last stopped); returns false if the slice ran out.
+    bool drive(const std::coroutine_handle<> root) {
+        if (!resumePoint)
+            resumePoint = root;
+
+        while (const auto next = std::exchange(resumePoint, {})) {
+            next.resume();
+            if (yielded) {
+                yielded = false;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    uint64_t budget;
+    uint64_t nextYield;
+    uint64_t units{0};
+    std::coroutine_handle<> resumePoint;
+    bool yielded{false};
+};
+
+namespace detail {
+
+template <typename Promise>
+struct FinalAwaiter {
+    [[nodiscard]] bool await_ready() const noexcept {
+        return false;
+    }
+
+    // el padre se reanuda desde SearchSlice::drive(); la raíz no tiene a quién volver.
+    void await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+        auto &promise = handle.promise();
+        if (promise.continuation)
+            promise.slice->resumePoint = promise.continuation;
+    }
+
+    void await_resume() const noexcept {
+    }
+};
+
+struct SearchPromiseBase {
+    std::suspend_always initial_suspend() const noexcept {
+        return {};
+    }
+
+    void unhandled_exception() {
+        error = std::current_exception();
+    }
+
+    SearchSlice *slice{nullptr};
+    std::coroutine_handle<> continuation;
+    std::exception_ptr error;
+};
+
+}  // namespace detail
+
+/**
+ * Lazily started, awaitable search coroutine. Children are awaited with `co_await`; the root is
+ * driven with step() until it reports completion.
+ */
+template <typename T>
+class [[nodiscard]] SearchTask {
+   public:
+    struct promise_type : detail::SearchPromiseBase {
+        SearchTask get_return_object() {
+            return SearchTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        detail::FinalAwaiter<promise_type> final_suspend() const noexcept {
+            return {};
+        }
+
+        template <typename U>
+        void return_value(U &&value) {
+            result.emplace(std::forward<U>(value));
+        }
+
+        std::optional<T> result;
+    };
+
+    SearchTask(SearchTask &&other) noexcept : handle(std::exchange(other.handle, {})) {
+    }
+
+    SearchTask &operator=(SearchTask &&other) noexcept {
+        if (this != &other) {
+            if (handle)
+                handle.destroy();
+            handle = std::exchange(other.handle, {});
+        }
+        return *this;
+    }
+
+    ~SearchTask() {
+        if (handle)
+            handle.destroy();
+    }
+
+    [[nodiscard]] bool await_ready() const noexcept {
+        return false;
+    }
+
+    template <typename ParentPromise>
+    void await_suspend(const std::coroutine_handle<ParentPromise> parent) noexcept {
+        auto &promise = handle.promise();
+        promise.continuation = parent;
+        promise.slice = parent.promise().slice;
+        promise.slice->resumePoint = handle;
+    }
+
+    T await_resume() {
+        return take();
+    }
+
+    // Runs until the slice budget is spent or the search finishes; returns true when done.
+    bool step(SearchSlice &slice) {
+        handle.promise().slice = &slice;
+        return slice.drive(handle) && handle.done();
+    }
+
+    // Runs the whole search on the calling thread, resuming across slice boundaries.
+    T run(SearchSlice &slice) {
+        while (!step(slice)) {
+        }
+        return take();
+    }
+
+    T take() {
+        auto &promise = handle.promise();
+        if (promise.error)
+            std::rethrow_exception(promise.error);
+        return std::move(*promise.result);
+    }
+
+   private:
+    explicit SearchTask(std::coroutine_handle<promise_type> phandle) : handle(phandle) {
+    }
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+template <>
+class [[nodiscard]] SearchTask<void> {
+   public:
+    struct promise_type : detail::SearchPromiseBase {
+        SearchTask get_return_object() {
+            return SearchTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        detail::FinalAwaiter<promise_type> final_suspend() const noexcept {
+            return {};
+        }
+
+        void return_void() const noexcept {
+        }
+    };
+
+    SearchTask(SearchTask &&other) noexcept : handle(std::exchange(other.handle, {})) {
+    }
+
+    SearchTask &operator=(SearchTask &&other) noexcept {
+        if (this != &other) {
+            if (handle)
+                handle.destroy();
+            handle = std::exchange(other.handle, {});
+        }
+        return *this;
+    }
+
+    ~SearchTask() {
+        if (handle)
+            handle.destroy();
+    }
+
+    [[nodiscard]] bool await_ready() const noexcept {
+        return false;
+    }
+
+    template <typename ParentPromise>
+    void await_suspend(const std::coroutine_handle<ParentPromise> parent) noexcept {
+        auto &promise = handle.promise();
+        promise.continuation = parent;
+        promise.slice = parent.promise().slice;
+        promise.slice->resumePoint = handle;
+    }
+
+    void await_resume() const {
+        take();
+    }
+
+    bool step(SearchSlice &slice) {
+        handle.promise().slice = &slice;
+        return slice.drive(handle) && handle.done();
+    }
+
+    void take() const {
+        if (handle.promise().error)
+            std::rethrow_exception(handle.promise().error);
+    }
+
+   private:
+    explicit SearchTask(std::coroutine_handle<promise_type> phandle) : handle(phandle) {
+    }
+
+    std::coroutine_handle<promise_type> handle;
+};
@@ -0,0 +1,66 @@
+/**
+ * Authors:
+ * Rigoberto Leander Salgado Reyes <rlsalgado2006@gmail.com>
+ *
+ * Copyright 2025 by Rigoberto Leander Salgado Reyes.
+ *
+ * This program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ */
+
+#pragma once
+
+#include <PieceKind.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * Lock-free table of minimax results shared by every thread of a search batch.
+ *
+ * maxValue()/minValue() fall back to the static heuristic when no move beats the window, so the
+ * score of a node depends on (alpha, beta) and is not a plain bound. Entries therefore memoize
+ * the exact result of (position, side, depth, alpha, beta): a hit returns what the search would
+ * have returned, and batch results match minimaxAsync() move for move.
+ *
+ * Each slot stores key ^ data next to data (Hyatt's lockless hashing): a slot torn by a
+ * concurrent write fails the check and counts as a miss.
+ */
+class TranspositionTable {
+   public:
+    // Per-thread handle: counts probes without touching shared cache lines.
+    struct Cursor {
+        TranspositionTable &table;
+        uint64_t probes{0};
+        uint64_t hits{0};
+
+        bool probe(uint64_t key, int &score);
+        void store(uint64_t key, int score);
+    };
+
+    // Rounded up to a power of two.
+    explicit TranspositionTable(size_t entries);
+
+    Cursor cursor();
+
+    // Zobrist hash of a column-major board (1=BLACK, 2=WHITE, 3=NEUTRON, 4=CELL); see rules::hash().
+    static uint64_t hash(const std::array<uint8_t, 25> &board);
+
+    // Key of a node: the position plus everything else its score depends on.
+    static uint64_t key(uint64_t position, PieceKind player, int depth, int alpha, int beta);
+
+   private:
+    struct Slot {
+        std::atomic<uint64_t> check{0};
+        std::atomic<uint64_t> data{0};
+    };
+
+    size_t mask;
+    std::unique_ptr<Slot[]> slots;
+};
@@ -15,7 +15,18 @@
 
 #include <FullMove.h>
 #include <Board.h>
+#include <SearchTask.h>
+#include <TranspositionTable.h>
 
+// Resumable alpha-beta: suspends every `slice.budget` nodes so the scheduler can interleave searches.
+// With `tt`, inner nodes are memoized in a table shared with other searches (see TranspositionTable).
+SearchTask<std::unique_ptr<FullMove>> maxValue(SearchSlice &slice, std::unique_ptr<Board> &board, int depth, int alpha, int beta, PieceKind player,
+                                               TranspositionTable::Cursor *tt = nullptr);
+
+SearchTask<std::unique_ptr<FullMove>> minValue(SearchSlice &slice, std::unique_ptr<Board> &board, int depth, int alpha, int beta, PieceKind player,
+                                               TranspositionTable::Cursor *tt = nullptr);
+
+// Blocking variants: run the coroutine search to completion on the calling thread.
 std::unique_ptr<FullMove> maxValue(std::unique_ptr<Board> &board, int depth, int alpha, int beta, PieceKind player);
 
 std::unique_ptr<FullMove> minValue(std::unique_ptr<Board> &board, int depth, int alpha, int beta, PieceKind player);
@@ -1,44 +1,106 @@
 #include <napi.h>
 
+#include <algorithm>
 #include <array>
+#include <chrono>
 #include <cstdint>
 #include <cstring>
+#include <list>
 #include <memory>
-#include <mutex>
 #include <stdexcept>
 #include <string>
+#include <utility>
 
 #include "RlAsyncWorker.h"
-
-std::unique_ptr<neutron_rl::NeutronAgent> g_agent;
-std::mutex g_agent_mutex;
+#include "RlEngine.h"
 
 namespace {
 
+// Games per environment whose search tree is kept between turns; past this the least recently
+// played one loses its tree (a hard tree keeps a few MB).
+constexpr size_t kMaxGames = 64;
+
+// Runs on the scheduler thread inside the search's slice, so ClassStats::current() is its class. With
+// inference batching `batchSize` is the whole shared forward pass, not only this search's positions.
+void RecordInference(const size_t batchSize, const std::chrono::microseconds elapsed) {
+    auto* stats = ClassStats::current();
+    if (!stats) {
+        return;
+    }
+
+    stats->inferences.fetch_add(1, std::memory_order_relaxed);
+    stats->inferredPositions.fetch_add(batchSize, std::memory_order_relaxed);
+    stats->inferenceMicros.record(elapsed.count());
+    stats->batchSize.record(batchSize);
+}
+
+// Same thread as RecordInference: one call per leaf looked up in the model's evaluation cache.
+void RecordEvalLookup(const bool hit) {
+    auto* stats = ClassStats::current();
+    if (!stats) {
+        return;
+    }
+
+    stats->evalProbes.fetch_add(1, std::memory_order_relaxed);
+    if (hit) {
+        stats->evalHits.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * Per-environment state: the main thread and every worker_thread that loads this addon get their
+ * own instance. Only the loaded model is shared (read-only, through ModelRegistry), so searches of
+ * different environments never wait on each other.
+ */
+class RlAddon : public Napi::Addon<RlAddon> {
+   public:
+    RlAddon(Napi::Env env, Napi::Object exports);
+
+    // Replaces the agent of this environment; in-flight searches keep the previous one alive.
+    // Trees of the previous model are dropped with it.
+    void SetAgent(std::shared_ptr<RlAgent> pagent) {
+        agent = std::move(pagent);
+        games.clear();
+    }
+
+   private:
+    Napi::Value LoadModel(const Napi::CallbackInfo& info);
+    Napi::Value MoveAsync(const Napi::CallbackInfo& info);
+    Napi::Value EndGame(const Napi::CallbackInfo& info);
+
+    // Search tree of game `id`, created on its first move.
+    std::shared_ptr<RlGame> GameFor(const std::string& id);
+
+    // solo se tocan en el hilo JS de este entorno
+    std::shared_ptr<RlAgent> agent;
+    std::list<std::pair<std::string, std::shared_ptr<RlGame>>> games;  // la más reciente primero
+};
+
 class RlLoadModelWorker : public Napi::AsyncWorker {
    public:
-    RlLoadModelWorker(Napi::Env env, std::string pmodelPath, Napi::Promise::Deferred pdeferred)
-        : Napi::AsyncWorker(env), modelPath(std::move(pmodelPath)), deferred(std::move(pdeferred)) {
+    RlLoadModelWorker(Napi::Env env, RlAddon* paddon, std::string pmodelPath, Napi::Promise::Deferred pdeferred)
+        : Napi::AsyncWorker(env), addon(paddon), modelPath(std::move(pmodelPath)), deferred(std::move(pdeferred)) {
     }
 
     void Execute() override {
         try {
-            std::lock_guard<std::mutex> lock(g_agent_mutex);
-            if (!g_agent) {
-                g_agent = std::make_unique<neutron_rl::NeutronAgent>("cpu");
-            }
-
-            if (!g_agent->load_model(modelPath)) {
-                throw std::runtime_error("Failed to load RL model: " + g_agent->get_error_message());
-            }
+            // The first load maps libtorch (seconds, hundreds of MB), here off the event loop.
+            // Environments loading the same file share one model; loading only happens once.
+            const auto& config = EngineScheduler::instance().config();
+            const neutron_rl::InferenceBatching batching{config.inferenceBatch, config.inferenceWait};
+            const auto precision =
+                config.int8Inference ? neutron_rl::InferencePrecision::Int8 : neutron_rl::InferencePrecision::Float32;
+            agent = LoadRlEngine().load_agent(modelPath, RecordInference, batching, config.evalCacheEntries,
+                                              RecordEvalLookup, precision);
         } catch (const std::exception& ex) {
-            SetError(ex.what());
+            SetError(std::string("Failed to load RL model: ") + ex.what());
         } catch (...) {
             SetError("Unknown error loading RL model");
         }
     }
 
     void OnOK() override {
+        addon->SetAgent(std::move(agent));
         deferred.Resolve(Env().Undefined());
     }
 
@@ -47,11 +109,32 @@ class RlLoadModelWorker : public Napi::AsyncWorker {
     }
 
    private:
+    RlAddon* addon;
     std::string modelPath;
+    std::shared_ptr<RlAgent> agent;
     Napi::Promise::Deferred deferred;
 };
 
-Napi::Value LoadModel(const Napi::CallbackInfo& info) {
+// JS: engineLoaded(): boolean, whether libtorch has been mapped into this process.
+Napi::Value EngineLoaded(const Napi::CallbackInfo& info) {
+    return Napi::Boolean::New(info.Env(), RlEngineLoaded());
+}
+
+}  // namespace
+
+RlAddon::RlAddon(Napi::Env env, Napi::Object exports) {
+    EngineAsyncWorker::Attach(env);
+    DefineAddon(exports, {
+        InstanceMethod("loadModel", &RlAddon::LoadModel),
+        InstanceMethod("moveAsync", &RlAddon::MoveAsync),
+        InstanceMethod("endGame", &RlAddon::EndGame),
+    });
+    exports.Set("engineLoaded", Napi::Function::New(env, EngineLoaded));
+    exports.Set("configureEngine", Napi::Function::New(env, EngineAsyncWorker::Configure));
+    exports.Set("getStats", Napi::Function::New(env, EngineAsyncWorker::Stats));
+}
+
+Napi::Value RlAddon::LoadModel(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     if (info.Length() < 1 || !info[0].IsString()) {
         throw Napi::TypeError::New(env, "loadModel(path) expects a model path string");
@@ -59,14 +142,40 @@ Napi::Value LoadModel(const Napi::CallbackInfo& info) {
 
     const auto modelPath = info[0].As<Napi::String>().Utf8Value();
     auto deferred = Napi::Promise::Deferred::New(env);
-    (new RlLoadModelWorker(env, modelPath, deferred))->Queue();
+    (new RlLoadModelWorker(env, this, modelPath, deferred))->Queue();
     return deferred.Promise();
 }
 
-Napi::Value MoveAsync(const Napi::CallbackInfo& info) {
+std::shared_ptr<RlGame> RlAddon::GameFor(const std::string& id) {
+    auto it = std::find_if(games.begin(), games.end(), [&](const auto& entry) { return entry.first == id; });
+    if (it != games.end()) {
+        games.splice(games.begin(), games, it);
+        return games.front().second;
+    }
+
+    if (games.size() >= kMaxGames) {
+        games.pop_back();
+    }
+    games.emplace_front(id, agent->new_game());
+    return games.front().second;
+}
+
+// JS: endGame(id), drops the search tree of a finished or abandoned game.
+Napi::Value RlAddon::EndGame(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsString()) {
+        throw Napi::TypeError::New(env, "endGame(id) expects a game id string");
+    }
+
+    const auto id = info[0].As<Napi::String>().Utf8Value();
+    games.remove_if([&](const auto& entry) { return entry.first == id; });
+    return env.Undefined();
+}
+
+Napi::Value RlAddon::MoveAsync(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     if (info.Length() < 1 || !info[0].IsObject()) {
-        throw Napi::TypeError::New(env, "moveAsync(input) expects {board, difficulty}");
+        throw Napi::TypeError::New(env, "moveAsync(input) expects {board, difficulty, game?}");
     }
 
     const auto input = info[0].As<Napi::Object>();
@@ -87,17 +196,55 @@ Napi::Value MoveAsync(const Napi::CallbackInfo& info) {
         difficulty = input.Get("difficulty").As<Napi::String>().Utf8Value();
     }
 
+    // Moves of the same game reuse the search tree of the previous one.
+    std::shared_ptr<RlGame> game;
+    if (agent && input.Has("game") && input.Get("game").IsString()) {
+        game = GameFor(input.Get("game").As<Napi::String>().Utf8Value());
+    }
+
+    auto packed = PackedResult::FromInput(env, input);
+
     auto deferred = Napi::Promise::Deferred::New(env);
-    (new RlAsyncWorker(env, board, difficulty, deferred))->Queue();
-    return deferred.Promise();
-}
 
-}  // namespace
+    auto& scheduler = EngineScheduler::instance();
+    const auto levels = RlAsyncWorker::levelsFor(difficulty);
+    auto& requested = scheduler.stats().forClass(levels.front().key);
+    requested.requests.fetch_add(1, std::memory_order_relaxed);
+
+    // Deterministic presets of the same model are answered from the cache or a running search.
+    const auto model = agent ? agent->model_id() : 0;
+    auto worker = new RlAsyncWorker(env, agent, std::move(game), board, difficulty, std::move(packed), deferred);
+    try {
+        worker->SetProgress(input);
+    } catch (...) {
+        delete worker;
+        throw;
+    }
+    if (const auto key = RlAsyncWorker::cacheKey(board, difficulty, model); key && worker->Serve(*key, requested)) {
+        return deferred.Promise();
+    }
+
+    auto ticket = scheduler.admission().admit(levels);
+    if (!ticket) {
+        requested.rejected.fetch_add(1, std::memory_order_relaxed);
+        delete worker;
+        deferred.Reject(EngineAsyncWorker::Overloaded(env).Value());
+        return deferred.Promise();
+    }
+    if (ticket->level) {
+        requested.downgraded.fetch_add(1, std::memory_order_relaxed);
+    }
 
-Napi::Object Init(Napi::Env env, Napi::Object exports) {
-    exports.Set("loadModel", Napi::Function::New(env, LoadModel));
-    exports.Set("moveAsync", Napi::Function::New(env, MoveAsync));
-    return exports;
+    // Under load admission control may serve a cheaper preset than the one requested.
+    difficulty = RlAsyncWorker::difficultyOf(levels[ticket->level]);
+    worker->SetDifficulty(difficulty);
+    if (auto key = RlAsyncWorker::cacheKey(board, difficulty, model)) {
+        worker->Lead(std::move(*key));
+    }
+    worker->SetTicket(std::move(*ticket));
+    worker->SetPool(scheduler.rlPool());
+    worker->Queue(RlAsyncWorker::slackFor(difficulty));
+    return deferred.Promise();
 }
 
-NODE_API_MODULE(neutron_rl_addon, Init)
+NODE_API_ADDON(RlAddon)
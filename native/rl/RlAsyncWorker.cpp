@@ -2,134 +2,222 @@
 
 #include <napi.h>
 
+#include <algorithm>
 #include <array>
 #include <stdexcept>
+#include <string_view>
 #include <utility>
 
 namespace {
 
-constexpr int kBoardSize = 5;
-constexpr int kCellValue = 4;
-constexpr int kBlackValue = 1;
-constexpr int kWhiteValue = 2;
-
-int8_t to_rl_piece(int8_t backend_piece) {
-    // Backend: BLACK=1, WHITE=2, NEUTRON=3, CELL=4.
-    // RL: Player1=1 (home row 4), Player2=2 (home row 0), Neutron=3, Empty=0.
-    // In backend, BLACK starts on row 0, so BLACK maps to RL Player2.
-    if (backend_piece == kCellValue) return 0;
-    if (backend_piece == kBlackValue) return 2;
-    if (backend_piece == kWhiteValue) return 1;
-    return backend_piece;
-}
+constexpr std::string_view kLevelPrefix = "rl:";
+
+}  // namespace
 
-std::array<int8_t, 25> to_rl_board(const std::array<uint8_t, 25>& js_board) {
-    std::array<int8_t, 25> rl_board{};
+std::chrono::microseconds RlAsyncWorker::slackFor(const std::string& difficulty) {
+    // Roughly 250us per simulation on CPU (one batch-1 forward each).
+    constexpr int kMicrosPerSimulation = 250;
 
-    for (int r = 0; r < kBoardSize; ++r) {
-        for (int c = 0; c < kBoardSize; ++c) {
-            int8_t val = static_cast<int8_t>(js_board[c * kBoardSize + r]);
-            rl_board[r * kBoardSize + c] = to_rl_piece(val);
-        }
+    int simulations = neutron_rl::DifficultyConfig::from_preset(neutron_rl::Difficulty::Hard).simulations;
+    if (difficulty == "easy") {
+        simulations = neutron_rl::DifficultyConfig::from_preset(neutron_rl::Difficulty::Easy).simulations;
+    } else if (difficulty == "medium") {
+        simulations = neutron_rl::DifficultyConfig::from_preset(neutron_rl::Difficulty::Medium).simulations;
     }
 
-    return rl_board;
+    return std::chrono::microseconds(simulations * kMicrosPerSimulation);
 }
 
-RlMove make_move(int row, int col, int kind) {
-    return RlMove{row, col, kind};
-}
+std::vector<AdmissionControl::Level> RlAsyncWorker::levelsFor(const std::string& difficulty) {
+    static constexpr std::array<const char*, 3> kPresets = {"hard", "medium", "easy"};
 
-void append_action_moves(int action, int piece_kind, std::vector<RlMove>& out) {
-    auto [cell, direction, distance] = neutron_rl::GameState::decode_action(action);
-    auto [from_row, from_col] = neutron_rl::GameState::cell_to_rowcol(cell);
+    const auto requested = std::find(kPresets.begin(), kPresets.end(), difficulty);
+    if (requested == kPresets.end()) {
+        // Unknown names fail in ExecuteSlice(); there is nothing cheaper to fall back to.
+        return {{std::string(kLevelPrefix) + difficulty, slackFor(difficulty)}};
+    }
 
-    static constexpr std::array<std::pair<int, int>, 8> kDirectionDeltas = {{
-        {-1, 0}, {-1, 1}, {0, 1}, {1, 1},
-        {1, 0},  {1, -1}, {0, -1}, {-1, -1}
-    }};
+    std::vector<AdmissionControl::Level> levels;
+    for (auto it = requested; it != kPresets.end(); ++it) {
+        levels.push_back({std::string(kLevelPrefix) + *it, slackFor(*it)});
+    }
+    return levels;
+}
 
-    const auto [dr, dc] = kDirectionDeltas.at(direction);
-    const int to_row = from_row + dr * distance;
-    const int to_col = from_col + dc * distance;
+std::string RlAsyncWorker::difficultyOf(const AdmissionControl::Level& level) {
+    return level.key.substr(kLevelPrefix.size());
+}
 
-    out.push_back(make_move(from_row, from_col, piece_kind));
-    out.push_back(make_move(to_row, to_col, piece_kind));
+std::optional<ResultCache::Key> RlAsyncWorker::cacheKey(const std::array<uint8_t, 25>& board,
+                                                       const std::string& difficulty,
+                                                       const uint64_t model) {
+    const auto config = neutron_rl::DifficultyConfig::from_name(difficulty);
+    if (!config || config->temperature > 0.0f) {
+        return std::nullopt;
+    }
+    // The engine always plays black (side 1), like play_black().
+    return ResultCache::Key{board, 1, std::string(kLevelPrefix) + difficulty, model};
 }
 
-RlMove fallback_black_pawn_move(const std::array<int8_t, 25>& board) {
-    for (int cell = 0; cell < static_cast<int>(board.size()); ++cell) {
-        if (board[cell] == 2) {
-            auto [row, col] = neutron_rl::GameState::cell_to_rowcol(cell);
-            return make_move(row, col, 1);
+bool RlAsyncWorker::ExecuteSlice() {
+    // No lock: searches only read the agent and its model, so they run in parallel.
+    if (!agent) {
+        throw std::runtime_error("RL model not loaded");
+    }
+
+    if (!search) {
+        auto difficulty = neutron_rl::DifficultyConfig::from_name(difficultyName);
+        if (!difficulty) {
+            throw std::runtime_error("Invalid RL difficulty: " + difficultyName);
         }
+        difficulty->leaf_batch = static_cast<int>(EngineScheduler::instance().config().leafBatch);
+        difficulty->threads = static_cast<int>(lanes);
+        result.level = difficulty->simulations;
+        search = agent->play_black(inputBoard, *difficulty, slice, WantsProgress() ? &playProgress : nullptr, game.get());
+        searching.store(true, std::memory_order_release);
     }
 
-    return make_move(4, 0, 1);
-}
+    if (!search->step(slice)) {
+        ReportProgress();
+        return false;
+    }
 
-}  // namespace
+    const auto played = search->take();
+    reusedVisits = played.reused_visits;
+    if (auto* stats = ClassStats::current()) {
+        stats->reusedVisits.fetch_add(reusedVisits, std::memory_order_relaxed);
+    }
 
-void RlAsyncWorker::Execute() {
-    try {
-        const auto rl_board = to_rl_board(inputBoard);
+    ResultCache::Value value{played.score, result.level, {}};
+    for (const auto& move : played.moves) {
+        value.moves.push_back({move.row, move.col, move.kind});
+    }
+    Adopt(value);
+    return true;
+}
 
-        std::lock_guard<std::mutex> lock(g_agent_mutex);
+unsigned RlAsyncWorker::Lanes() const {
+    return lanes;
+}
 
-        if (!g_agent || !g_agent->is_ready()) {
-            throw std::runtime_error("RL model not loaded");
+bool RlAsyncWorker::ExecuteLane(const unsigned lane) {
+    if (lane == 0) {
+        bool done = true;
+        try {
+            done = ExecuteSlice();
+        } catch (...) {
+            leaderDone.store(true, std::memory_order_release);
+            throw;
         }
-
-        if (!g_agent->set_difficulty(difficultyName)) {
-            throw std::runtime_error("Invalid RL difficulty: " + difficultyName);
+        if (done) {
+            leaderDone.store(true, std::memory_order_release);
         }
+        return done;
+    }
 
-        neutron_rl::GameState state(rl_board, 2, neutron_rl::Phase::MoveNeutron);
+    // Lanes de ayuda: simulan en el árbol de la lane 0 mientras su búsqueda dure.
+    if (leaderDone.load(std::memory_order_acquire)) {
+        return true;
+    }
+    if (!searching.load(std::memory_order_acquire)) {
+        return false;
+    }
+    return search->help(lane, helperSlices[lane - 1]);
+}
 
-        const int neutron_action = g_agent->get_move(state);
-        append_action_moves(neutron_action, 3, resultMoves);
+void RlAsyncWorker::ReportProgress() {
+    if (playProgress.search.best_action < 0 || !ProgressDue()) {
+        return;
+    }
 
-        state = state.apply_action(neutron_action);
+    {
+        std::lock_guard lock(progressMutex);
+        progress = playProgress;
+    }
+    EmitProgress();
+}
 
-        if (state.is_terminal()) {
-            const auto fallback = fallback_black_pawn_move(state.board());
-            resultMoves.push_back(fallback);
-            resultMoves.push_back(fallback);
-            score = 1.0;
-            return;
-        }
+ResultCache::Value RlAsyncWorker::CacheValue() const {
+    return result;
+}
 
-        const int pawn_action = g_agent->get_move(state);
-        append_action_moves(pawn_action, 1, resultMoves);
+void RlAsyncWorker::Adopt(const ResultCache::Value& value) {
+    result = value;
 
-        score = 1.0;
-    } catch (const std::exception& ex) {
-        SetError(ex.what());
-    } catch (...) {
-        SetError("Unknown error in RlAsyncWorker");
+    if (packed.Enabled()) {
+        packed.SetScore(static_cast<int32_t>(value.score));
+        packed.SetLevel(value.level);
+        for (const auto& move : value.moves) {
+            packed.Push(move.row, move.col, move.kind);
+        }
     }
 }
 
+uint64_t RlAsyncWorker::WorkUnits() const {
+    uint64_t units = slice.units;
+    for (const auto& helper : helperSlices) units += helper.units;
+    return units;
+}
+
 void RlAsyncWorker::OnOK() {
     Napi::Env env = Env();
 
+    if (packed.Enabled()) {
+        deferred.Resolve(packed.ToValue(env));
+        return;
+    }
+
     Napi::Object out = Napi::Object::New(env);
     Napi::Array moves = Napi::Array::New(env);
 
-    for (uint32_t i = 0; i < resultMoves.size(); ++i) {
+    for (uint32_t i = 0; i < result.moves.size(); ++i) {
         auto jm = Napi::Object::New(env);
-        jm.Set("row", Napi::Number::New(env, resultMoves[i].row));
-        jm.Set("col", Napi::Number::New(env, resultMoves[i].col));
-        jm.Set("kind", Napi::Number::New(env, resultMoves[i].kind));
+        jm.Set("row", Napi::Number::New(env, result.moves[i].row));
+        jm.Set("col", Napi::Number::New(env, result.moves[i].col));
+        jm.Set("kind", Napi::Number::New(env, result.moves[i].kind));
         moves.Set(i, jm);
     }
 
     out.Set("moves", moves);
-    out.Set("score", Napi::Number::New(env, score));
+    out.Set("score", Napi::Number::New(env, result.score));
+    out.Set("difficulty", Napi::String::New(env, difficultyName));
+    out.Set("simulations", Napi::Number::New(env, result.level));
+    out.Set("reusedVisits", Napi::Number::New(env, reusedVisits));
 
     deferred.Resolve(out);
 }
 
+void RlAsyncWorker::OnProgress(Napi::Env env, Napi::Function callback) {
+    RlPlayProgress snapshot;
+    {
+        std::lock_guard lock(progressMutex);
+        snapshot = progress;
+    }
+
+    // hay agente, así que el motor ya está cargado.
+    const auto played = LoadRlEngine().progress_moves(snapshot);
+    Napi::Array moves = Napi::Array::New(env);
+    for (uint32_t i = 0; i < played.size(); ++i) {
+        auto jm = Napi::Object::New(env);
+        jm.Set("row", Napi::Number::New(env, played[i].row));
+        jm.Set("col", Napi::Number::New(env, played[i].col));
+        jm.Set("kind", Napi::Number::New(env, played[i].kind));
+        moves.Set(i, jm);
+    }
+
+    Napi::Object out = Napi::Object::New(env);
+    out.Set("simulations", Napi::Number::New(env, snapshot.finished_simulations + snapshot.search.simulations));
+    out.Set("visitShare", Napi::Number::New(env, snapshot.search.best_share));
+    out.Set("value", Napi::Number::New(env, snapshot.search.value));
+    out.Set("moves", moves);
+    callback.Call({out});
+}
+
 void RlAsyncWorker::OnError(const Napi::Error& e) {
     deferred.Reject(e.Value());
 }
+
+void RlAsyncWorker::DropHandles() {
+    EngineAsyncWorker::DropHandles();
+    packed.DropHandles();
+}
@@ -2,44 +2,90 @@
 
 #include <napi.h>
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
 #include <vector>
 
-#include "neutron_rl/agent.hpp"
+#include "EngineAsyncWorker.h"
+#include "PackedResult.h"
+#include "RlEngine.h"
+#include "RlPlay.h"
+#include "SearchTask.h"
 
-struct RlMove {
-    int row;
-    int col;
-    int kind;
-};
-
-class RlAsyncWorker : public Napi::AsyncWorker {
+class RlAsyncWorker : public EngineAsyncWorker {
    public:
     RlAsyncWorker(Napi::Env env,
+                  std::shared_ptr<RlAgent> pagent,
+                  std::shared_ptr<RlGame> pgame,
                   std::array<uint8_t, 25> pboard,
                   std::string pdifficulty,
+                  PackedResult ppacked,
                   Napi::Promise::Deferred pdeferred)
-        : Napi::AsyncWorker(env),
+        : EngineAsyncWorker(env),
+          agent(std::move(pagent)),
+          game(std::move(pgame)),
           inputBoard(pboard),
           difficultyName(std::move(pdifficulty)),
+          packed(std::move(ppacked)),
           deferred(std::move(pdeferred)) {
     }
 
-    void Execute() override;
+    // Scheduling slack proportional to the preset's simulation budget.
+    static std::chrono::microseconds slackFor(const std::string& difficulty);
+
+    // Admission levels: the requested preset followed by every cheaper one.
+    static std::vector<AdmissionControl::Level> levelsFor(const std::string& difficulty);
+
+    // Preset name of a level returned by levelsFor().
+    static std::string difficultyOf(const AdmissionControl::Level& level);
+
+    // ResultCache key, or nullopt for presets that sample moves (temperature > 0).
+    static std::optional<ResultCache::Key> cacheKey(const std::array<uint8_t, 25>& board,
+                                                    const std::string& difficulty,
+                                                    uint64_t model);
+
+    void SetDifficulty(std::string pdifficulty) {
+        difficultyName = std::move(pdifficulty);
+    }
+
+    bool ExecuteSlice() override;
+    [[nodiscard]] unsigned Lanes() const override;
+    bool ExecuteLane(unsigned lane) override;
+    [[nodiscard]] uint64_t WorkUnits() const override;
+    [[nodiscard]] ResultCache::Value CacheValue() const override;
+    void Adopt(const ResultCache::Value& value) override;
     void OnOK() override;
     void OnError(const Napi::Error& e) override;
+    void DropHandles() override;
+    void OnProgress(Napi::Env env, Napi::Function callback) override;
 
    private:
+    void ReportProgress();
+
+    // Agent of the requesting environment, pinned until the search ends.
+    std::shared_ptr<RlAgent> agent;
+    // Search tree of the game ({game} in the request), or null; must outlive `search`.
+    std::shared_ptr<RlGame> game;
     std::array<uint8_t, 25> inputBoard;
     std::string difficultyName;
-    std::vector<RlMove> resultMoves;
-    double score = 0.0;
+    SearchSlice slice{EngineScheduler::instance().config().sliceSimulations};
+    // Lane 0 runs the search; the others help it on the same tree (searchThreads).
+    unsigned lanes{std::max(1u, EngineScheduler::instance().config().searchThreads)};
+    std::vector<SearchSlice> helperSlices = std::vector<SearchSlice>(lanes - 1, slice);
+    std::unique_ptr<RlSearch> search;
+    std::atomic<bool> searching{false};   // `search` created, helpers may use it
+    std::atomic<bool> leaderDone{false};  // lane 0 finished or failed
+    RlPlayProgress playProgress;  // scheduler thread only
+    ResultCache::Value result{};
+    int reusedVisits{0};
+    std::mutex progressMutex;
+    RlPlayProgress progress;
+    PackedResult packed;
     Napi::Promise::Deferred deferred;
 };
-
-extern std::unique_ptr<neutron_rl::NeutronAgent> g_agent;
-extern std::mutex g_agent_mutex;
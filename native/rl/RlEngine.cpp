@@ -0,0 +1,149 @@
+#include "RlEngine.h"
+
+#include <algorithm>
+#include <atomic>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "neutron_rl/agent.hpp"
+#include "neutron_rl/mcts.hpp"
+#include "neutron_rl/model_registry.hpp"
+
+// Engine side of RlEngine.h: built into neutron_rl_engine.so together with libtorch.
+
+namespace {
+
+class Game final : public RlGame {
+   public:
+    neutron_rl::SearchTree tree;
+    std::atomic<bool> busy{false};  // una búsqueda usa el árbol
+};
+
+// Exclusive use of a game's tree by one search; none when another search holds it.
+class Claim {
+   public:
+    explicit Claim(RlGame* pgame) : game(static_cast<Game*>(pgame)) {
+        if (game && game->busy.exchange(true, std::memory_order_acquire)) {
+            game = nullptr;
+        }
+    }
+
+    ~Claim() {
+        if (game) {
+            game->busy.store(false, std::memory_order_release);
+        }
+    }
+
+    Claim(const Claim&) = delete;
+    Claim& operator=(const Claim&) = delete;
+
+    [[nodiscard]] neutron_rl::SearchTree* tree() const {
+        return game ? &game->tree : nullptr;
+    }
+
+   private:
+    Game* game;
+};
+
+class Search final : public RlSearch {
+   public:
+    Search(const neutron_rl::ModelLoader& pmodel,
+           neutron_rl::NeutronAgent& agent,
+           const std::array<uint8_t, 25>& board,
+           const neutron_rl::DifficultyConfig& difficulty,
+           SearchSlice& slice,
+           RlPlayProgress* progress,
+           RlGame* game)
+        : model(pmodel),
+          crew(difficulty.threads > 1 ? std::make_unique<neutron_rl::SearchCrew>() : nullptr),
+          helpers(static_cast<size_t>(std::max(difficulty.threads - 1, 0))),
+          claim(game),
+          task(::play_black(agent, board, difficulty, slice, progress, claim.tree(), crew.get())) {
+    }
+
+    bool step(SearchSlice& slice) override {
+        // Mientras dure el slice, el hilo de inferencia espera también nuestras peticiones.
+        const auto active = model.activity();
+        if (!task.step(slice)) {
+            return false;
+        }
+        if (crew) {
+            crew->close();
+        }
+        return true;
+    }
+
+    bool help(const unsigned lane, SearchSlice& slice) override {
+        if (!crew || lane == 0 || lane > helpers.size()) {
+            return true;
+        }
+
+        auto& helper = helpers[lane - 1];
+        if (!helper) {
+            helper.emplace(crew->help(slice));
+        }
+        const auto active = model.activity();
+        if (!helper->step(slice)) {
+            return false;
+        }
+        helper->take();
+        return true;
+    }
+
+    RlPlayResult take() override {
+        return task.take();
+    }
+
+   private:
+    const neutron_rl::ModelLoader& model;
+    std::unique_ptr<neutron_rl::SearchCrew> crew;          // con difficulty.threads > 1
+    std::vector<std::optional<SearchTask<void>>> helpers;  // uno por lane de ayuda
+    Claim claim;  // declarado antes que task: se suelta cuando el task ya no usa el árbol
+    SearchTask<RlPlayResult> task;
+};
+
+class Agent final : public RlAgent {
+   public:
+    explicit Agent(std::shared_ptr<const neutron_rl::ModelLoader> pmodel) : model(pmodel), agent(std::move(pmodel)) {
+    }
+
+    [[nodiscard]] uint64_t model_id() const override {
+        return agent.model_id();
+    }
+
+    [[nodiscard]] std::unique_ptr<RlGame> new_game() const override {
+        return std::make_unique<Game>();
+    }
+
+    std::unique_ptr<RlSearch> play_black(const std::array<uint8_t, 25>& board,
+                                         const neutron_rl::DifficultyConfig& difficulty,
+                                         SearchSlice& slice,
+                                         RlPlayProgress* progress,
+                                         RlGame* game) override {
+        return std::make_unique<Search>(*model, agent, board, difficulty, slice, progress, game);
+    }
+
+   private:
+    std::shared_ptr<const neutron_rl::ModelLoader> model;
+    neutron_rl::NeutronAgent agent;
+};
+
+std::shared_ptr<RlAgent> LoadAgent(const std::string& model_path,
+                                   const RlInferenceObserver observer,
+                                   const neutron_rl::InferenceBatching& batching,
+                                   const size_t eval_cache_entries,
+                                   const RlEvalCacheObserver cache_observer,
+                                   const neutron_rl::InferencePrecision precision) {
+    auto model = neutron_rl::ModelRegistry::acquire(model_path, "cpu", observer, batching, eval_cache_entries,
+                                                    cache_observer, precision);
+    return std::make_shared<Agent>(std::move(model));
+}
+
+constexpr RlEngineApi kApi{kRlEngineApiVersion, LoadAgent, progress_moves};
+
+}  // namespace
+
+extern "C" const RlEngineApi* neutron_rl_engine_api() {
+    return &kApi;
+}
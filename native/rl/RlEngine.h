@@ -0,0 +1,94 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "RlPlay.h"
+#include "SearchTask.h"
+#include "neutron_rl/search_config.hpp"
+
+/**
+ * Boundary between the RL addon and its libtorch-backed engine, neutron_rl_engine.so, built
+ * next to neutron_rl_addon.node. The addon only sees the interfaces below and dlopen()s the
+ * engine on the first loadModel(), so a process that never plays RL does not map libtorch.
+ *
+ * Both libraries come from the same CMake project with the same compiler and flags (including
+ * libtorch's _GLIBCXX_USE_CXX11_ABI), so standard library types cross the boundary as they are.
+ */
+
+// One play_black() in progress; same contract as SearchTask::step()/take().
+class RlSearch {
+   public:
+    virtual ~RlSearch() = default;
+
+    virtual bool step(SearchSlice& slice) = 0;
+
+    // Helper `lane` (1 .. difficulty.threads - 1), each on its own thread and slice: runs
+    // simulations on the tree step() is searching. True once the search is over; throws the
+    // helper's own errors.
+    virtual bool help(unsigned lane, SearchSlice& slice) = 0;
+
+    virtual RlPlayResult take() = 0;
+};
+
+// Search tree of one game, kept between its turns (see play_black() in RlPlay.h); opaque to the addon.
+class RlGame {
+   public:
+    virtual ~RlGame() = default;
+};
+
+// A NeutronAgent on a loaded model. Searches only read it, so they can run in parallel.
+class RlAgent {
+   public:
+    virtual ~RlAgent() = default;
+
+    [[nodiscard]] virtual uint64_t model_id() const = 0;
+
+    [[nodiscard]] virtual std::unique_ptr<RlGame> new_game() const = 0;
+
+    // The agent and `game` (optional, from new_game() of this agent) must outlive the returned
+    // search. A game busy with another search is ignored: that search starts from scratch.
+    virtual std::unique_ptr<RlSearch> play_black(const std::array<uint8_t, 25>& board,
+                                                 const neutron_rl::DifficultyConfig& difficulty,
+                                                 SearchSlice& slice,
+                                                 RlPlayProgress* progress,
+                                                 RlGame* game) = 0;
+};
+
+using RlInferenceObserver = void (*)(size_t batch_size, std::chrono::microseconds elapsed);
+using RlEvalCacheObserver = void (*)(bool hit);
+
+struct RlEngineApi {
+    uint32_t version;
+
+    // Loads (or shares, see ModelRegistry) the model at `model_path` with the given precision; throws
+    // on failure. `batching` and the evaluation cache (0 entries = off) only apply when this call
+    // loads the model.
+    std::shared_ptr<RlAgent> (*load_agent)(const std::string& model_path,
+                                           RlInferenceObserver observer,
+                                           const neutron_rl::InferenceBatching& batching,
+                                           size_t eval_cache_entries,
+                                           RlEvalCacheObserver cache_observer,
+                                           neutron_rl::InferencePrecision precision);
+
+    // See progress_moves() in RlPlay.h.
+    std::vector<RlMove> (*progress_moves)(const RlPlayProgress& progress);
+};
+
+// Bumped whenever RlEngineApi, the classes above or the types they pass (DifficultyConfig) change.
+constexpr uint32_t kRlEngineApiVersion = 7;
+
+// Engine side: the only symbol the addon looks up.
+extern "C" const RlEngineApi* neutron_rl_engine_api();
+
+// Addon side: the engine, loaded on the first call (thread-safe). Throws std::runtime_error when
+// the library cannot be loaded; a later call tries again. NEUTRON_RL_ENGINE overrides the path.
+const RlEngineApi& LoadRlEngine();
+
+// True once LoadRlEngine() has succeeded.
+bool RlEngineLoaded();
@@ -0,0 +1,70 @@
+#include <dlfcn.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+#include "RlEngine.h"
+
+// Addon side of RlEngine.h: finds neutron_rl_engine.so and loads it once per process.
+
+namespace {
+
+constexpr const char* kEngineFile = "neutron_rl_engine.so";
+
+std::mutex loadMutex;
+std::atomic<const RlEngineApi*> engine{nullptr};
+
+// Same directory as this addon, whatever the cwd of the server.
+std::string EnginePath() {
+    if (const char* path = std::getenv("NEUTRON_RL_ENGINE")) {
+        return path;
+    }
+
+    Dl_info info{};
+    if (!dladdr(reinterpret_cast<const void*>(&EnginePath), &info) || !info.dli_fname) {
+        return kEngineFile;
+    }
+
+    const std::string self = info.dli_fname;
+    const auto slash = self.rfind('/');
+    return slash == std::string::npos ? kEngineFile : self.substr(0, slash + 1) + kEngineFile;
+}
+
+}  // namespace
+
+const RlEngineApi& LoadRlEngine() {
+    if (const auto* api = engine.load(std::memory_order_acquire)) {
+        return *api;
+    }
+
+    std::lock_guard lock(loadMutex);
+    if (const auto* api = engine.load(std::memory_order_relaxed)) {
+        return *api;
+    }
+
+    const auto path = EnginePath();
+    // RTLD_LOCAL: libtorch's symbols stay out of the global namespace of the process.
+    void* handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!handle) {
+        throw std::runtime_error(std::string("Failed to load RL engine: ") + dlerror());
+    }
+
+    using Entry = const RlEngineApi* (*)();
+    const auto entry = reinterpret_cast<Entry>(dlsym(handle, "neutron_rl_engine_api"));
+    const auto* api = entry ? entry() : nullptr;
+    if (!api || api->version != kRlEngineApiVersion) {
+        dlclose(handle);
+        throw std::runtime_error("RL engine " + path + " does not match this addon (rebuild native/rl)");
+    }
+
+    // Never unloaded: libtorch keeps its own threads and static state alive until exit.
+    engine.store(api, std::memory_order_release);
+    return *api;
+}
+
+bool RlEngineLoaded() {
+    return engine.load(std::memory_order_acquire) != nullptr;
+}
@@ -0,0 +1,91 @@
+#include "RlPlay.h"
+
+#include <array>
+#include <utility>
+
+#include "neutron_rl/agent.hpp"
+
+namespace {
+
+RlMove make_move(int row, int col, int kind) {
+    return RlMove{row, col, kind};
+}
+
+void append_action_moves(int action, int piece_kind, std::vector<RlMove>& out) {
+    auto [cell, direction, distance] = neutron_rl::GameState::decode_action(action);
+    auto [from_row, from_col] = neutron_rl::GameState::cell_to_rowcol(cell);
+
+    const int to_row = from_row + rules::kRowDelta.at(direction) * distance;
+    const int to_col = from_col + rules::kColDelta.at(direction) * distance;
+
+    out.push_back(make_move(from_row, from_col, piece_kind));
+    out.push_back(make_move(to_row, to_col, piece_kind));
+}
+
+RlMove fallback_black_pawn_move(const rules::Cells& cells) {
+    constexpr auto kBlack = static_cast<uint8_t>(PieceKind::BLACK);
+    if (const int index = rules::find(cells, kBlack); index != rules::kNone) {
+        return make_move(index % 5, index / 5, kBlack);
+    }
+
+    return make_move(4, 0, kBlack);
+}
+
+}  // namespace
+
+std::vector<RlMove> progress_moves(const RlPlayProgress& progress) {
+    std::vector<RlMove> moves;
+    if (progress.neutron_action >= 0) {
+        append_action_moves(progress.neutron_action, 3, moves);
+        if (progress.search.best_action >= 0) {
+            append_action_moves(progress.search.best_action, 1, moves);
+        }
+    } else if (progress.search.best_action >= 0) {
+        append_action_moves(progress.search.best_action, 3, moves);
+    }
+    return moves;
+}
+
+SearchTask<RlPlayResult> play_black(neutron_rl::NeutronAgent& agent,
+                                    const std::array<uint8_t, 25> board,
+                                    const neutron_rl::DifficultyConfig difficulty,
+                                    SearchSlice& slice,
+                                    RlPlayProgress* progress,
+                                    neutron_rl::SearchTree* tree,
+                                    neutron_rl::SearchCrew* crew) {
+    RlPlayResult result;
+    // Sin árbol de la partida, al menos el peón reutiliza la búsqueda del neutrón.
+    neutron_rl::SearchTree turn;
+    auto* kept = tree ? tree : &turn;
+
+    // El motor juega con BLACK: el jugador 2 del agente (casa en la fila 0).
+    neutron_rl::GameState state(board, 2, neutron_rl::Phase::MoveNeutron);
+
+    auto* search_progress = progress ? &progress->search : nullptr;
+    const int neutron_action = co_await agent.get_move_resumable(state, difficulty, slice, search_progress, kept, crew);
+    result.reused_visits = kept->reused_visits();
+    append_action_moves(neutron_action, 3, result.moves);
+    if (progress) {
+        progress->neutron_action = neutron_action;
+        progress->finished_simulations += progress->search.simulations;
+        progress->search = {};
+    }
+
+    state = state.apply_action(neutron_action);
+
+    if (state.is_terminal()) {
+        kept->clear();
+        const auto fallback = fallback_black_pawn_move(state.cells());
+        result.moves.push_back(fallback);
+        result.moves.push_back(fallback);
+        result.score = 1.0;
+        co_return std::move(result);
+    }
+
+    const int pawn_action = co_await agent.get_move_resumable(state, difficulty, slice, search_progress, kept, crew);
+    result.reused_visits += kept->reused_visits();
+    append_action_moves(pawn_action, 1, result.moves);
+
+    result.score = 1.0;
+    co_return std::move(result);
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "SearchTask.h"
+#include "neutron_rl/search_config.hpp"
+
+namespace neutron_rl {
+class NeutronAgent;
+class SearchCrew;
+class SearchTree;
+}
+
+struct RlMove {
+    int row;
+    int col;
+    int kind;
+};
+
+struct RlPlayResult {
+    std::vector<RlMove> moves;  // neutron from/to, then pawn from/to
+    double score = 0.0;
+    int reused_visits = 0;      // root visits both searches started with (see neutron_rl::SearchTree)
+};
+
+// Where play_black() stands: the neutron move once chosen, plus the search running now.
+struct RlPlayProgress {
+    int neutron_action = -1;
+    int finished_simulations = 0;  // simulations of searches already finished
+    neutron_rl::SearchProgress search;
+};
+
+// Current best guess of the turn (empty before the first visit), in the layout of RlPlayResult::moves.
+std::vector<RlMove> progress_moves(const RlPlayProgress& progress);
+
+/**
+ * Black's full turn (neutron move, then pawn move) chosen by the agent on a backend board
+ * (column-major, BLACK=1, WHITE=2, NEUTRON=3, CELL=4). Shared by the addon and the engine binary.
+ *
+ * The pawn search always starts from the subtree of the chosen neutron move. With a `tree` of the
+ * same game the neutron search also starts from the previous turn's tree, past the opponent's
+ * moves, and the tree keeps the subtree of the pawn move for the next turn.
+ *
+ * With a `crew` both searches are open to its helper threads (neutron_rl::SearchCrew); the caller
+ * closes it once the task is done.
+ */
+SearchTask<RlPlayResult> play_black(neutron_rl::NeutronAgent& agent,
+                                    std::array<uint8_t, 25> board,
+                                    neutron_rl::DifficultyConfig difficulty,
+                                    SearchSlice& slice,
+                                    RlPlayProgress* progress = nullptr,
+                                    neutron_rl::SearchTree* tree = nullptr,
+                                    neutron_rl::SearchCrew* crew = nullptr);
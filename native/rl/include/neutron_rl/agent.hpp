@@ -2,34 +2,16 @@
 
 #include <array>
 #include <memory>
+#include <optional>
 #include <string>
 
 #include "neutron_rl/game_state.hpp"
 #include "neutron_rl/mcts.hpp"
 #include "neutron_rl/model_loader.hpp"
+#include "neutron_rl/search_config.hpp"
 
 namespace neutron_rl {
 
-/**
- * @brief Difficulty presets for the AI agent.
- */
-enum class Difficulty {
-    Easy,    // ~100 MCTS simulations, some randomness
-    Medium,  // ~300 MCTS simulations
-    Hard     // ~800 MCTS simulations, deterministic
-};
-
-/**
- * @brief Configuration for a difficulty level.
- */
-struct DifficultyConfig {
-    int simulations;
-    float temperature;
-
-    static DifficultyConfig from_preset(Difficulty difficulty);
-    static DifficultyConfig from_simulations(int simulations, float temperature = 0.0f);
-};
-
 /**
  * @brief High-level AI agent for the Neutron game.
  *
@@ -62,6 +44,13 @@ public:
      */
     explicit NeutronAgent(const std::string& device = "cpu");
 
+    /**
+     * @brief Construct an agent on an already loaded, possibly shared, model.
+     *
+     * @param model Loaded model (see ModelRegistry::acquire()).
+     */
+    explicit NeutronAgent(std::shared_ptr<const ModelLoader> model);
+
     /**
      * @brief Destroy the Neutron Agent.
      */
@@ -76,12 +65,16 @@ public:
     NeutronAgent& operator=(NeutronAgent&&) noexcept;
 
     /**
-     * @brief Load a TorchScript model.
+     * @brief Load a TorchScript model or exported weights.
+     *
+     * Replaces the model and the MCTS instance; do not call while resumable
+     * searches of this agent are suspended.
      *
-     * @param model_path Path to the .pt model file.
+     * @param model_path Path to the .pt model file or exported weights.
+     * @param precision Arithmetic of the forward passes (see ModelLoader::load()).
      * @return true if loading succeeded.
      */
-    bool load_model(const std::string& model_path);
+    bool load_model(const std::string& model_path, InferencePrecision precision = InferencePrecision::Float32);
 
     /**
      * @brief Check if a model is loaded.
@@ -90,6 +83,11 @@ public:
      */
     bool is_ready() const;
 
+    /**
+     * @brief Id of the loaded model (ModelLoader::id()), 0 when none.
+     */
+    uint64_t model_id() const;
+
     /**
      * @brief Set difficulty by preset.
      *
@@ -142,6 +140,28 @@ public:
      */
     int get_move(const GameState& state);
 
+    /**
+     * @brief Resumable variant of get_move() with an explicit difficulty.
+     *
+     * Does not touch the agent's own difficulty, so concurrent requests with
+     * different presets can run on one agent, even from different threads.
+     *
+     * @param state Current game state.
+     * @param difficulty Simulations and temperature for this search.
+     * @param slice Time-slice budget (in simulations).
+     * @param progress Optional snapshot refreshed after every simulation.
+     * @param tree Optional tree reused between searches (MCTS::search_resumable()).
+     * @param crew Optional helper threads searching the same tree.
+     * @return Task yielding the action index.
+     * @throws std::runtime_error if no model is loaded.
+     */
+    SearchTask<int> get_move_resumable(const GameState& state,
+                                       const DifficultyConfig& difficulty,
+                                       SearchSlice& slice,
+                                       SearchProgress* progress = nullptr,
+                                       SearchTree* tree = nullptr,
+                                       SearchCrew* crew = nullptr);
+
     /**
      * @brief Get move with action probabilities.
      *
@@ -160,7 +180,8 @@ public:
     std::string get_error_message() const;
 
 private:
-    std::unique_ptr<ModelLoader> model_loader_;
+    std::string device_;
+    std::shared_ptr<const ModelLoader> model_loader_;
     std::unique_ptr<MCTS> mcts_;
     DifficultyConfig difficulty_config_;
     std::string error_message_;
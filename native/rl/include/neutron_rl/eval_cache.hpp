@@ -0,0 +1,108 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "neutron_rl/game_state.hpp"
+
+namespace neutron_rl {
+
+/**
+ * @brief Network evaluation of one position, restricted to its legal actions.
+ *
+ * What a search keeps of a forward pass: the softmax of the policy over the
+ * legal actions (absolute action space, in get_legal_actions() order) and
+ * the value from the player to move.
+ */
+struct Evaluation {
+    /**
+     * @brief Most legal actions of a position: 5 pawns x 8 directions.
+     */
+    static constexpr int kMaxActions = GameState::kMaxActions;
+
+    int num_actions = 0;
+    std::array<int16_t, kMaxActions> actions{};
+    std::array<float, kMaxActions> priors{};
+    float value = 0.0f;
+
+    /**
+     * @brief Evaluation of `state` from the network's raw output.
+     *
+     * @param state Evaluated position.
+     * @param policy_logits Policy logits in the absolute action space.
+     * @param value Value from the player to move.
+     */
+    static Evaluation from_logits(const GameState& state, const std::vector<float>& policy_logits, float value);
+};
+
+/**
+ * @brief Bounded cache of network evaluations, keyed by GameState::hash().
+ *
+ * Owned by a ModelLoader (its evaluations depend on the weights) and shared
+ * by every search on it, across games and environments, so positions that
+ * come up again (openings, transpositions, the opponent's replies already
+ * searched last turn) skip the forward pass.
+ *
+ * Direct-mapped: a position has one slot and a new one always replaces the
+ * old. Slots are guarded by a few striped mutexes, held only for the copy;
+ * a forward pass costs far more than the lock.
+ */
+class EvalCache {
+public:
+    /**
+     * @brief Callback invoked after every lookup with whether it hit.
+     *
+     * Runs on the searching thread, so it must be cheap and thread-safe.
+     */
+    using Observer = std::function<void(bool hit)>;
+
+    /**
+     * @brief Construct an empty cache.
+     *
+     * @param entries Most positions kept; rounded down to a power of two.
+     * @param observer Lookup callback (telemetry), or nullptr.
+     */
+    explicit EvalCache(size_t entries, Observer observer = nullptr);
+
+    /**
+     * @brief Look a position up.
+     *
+     * @param key GameState::hash() of the position.
+     * @param evaluation Set to the cached evaluation on a hit.
+     * @return true on a hit.
+     */
+    bool find(uint64_t key, Evaluation& evaluation) const;
+
+    /**
+     * @brief Keep an evaluation, replacing whatever held its slot.
+     *
+     * Evaluations without legal actions are not kept.
+     */
+    void store(uint64_t key, const Evaluation& evaluation);
+
+    /**
+     * @brief Most positions kept.
+     */
+    size_t capacity() const;
+
+private:
+    struct Slot {
+        uint64_t key = 0;
+        Evaluation evaluation;  // num_actions 0: empty
+    };
+
+    static constexpr size_t kStripes = 64;
+
+    std::mutex& stripe(size_t index) const;
+
+    std::vector<Slot> slots_;
+    size_t mask_;
+    Observer observer_;
+    mutable std::array<std::mutex, kStripes> stripes_;
+};
+
+}  // namespace neutron_rl
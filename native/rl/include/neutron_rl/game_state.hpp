@@ -3,9 +3,14 @@
 #include <array>
 #include <cstdint>
 #include <optional>
+#include <span>
 #include <string>
+#include <tuple>
+#include <utility>
 #include <vector>
 
+#include <Rules.h>
+
 namespace neutron_rl {
 
 /**
@@ -49,6 +54,9 @@ enum class Phase : int8_t {
  * opposite sides. The neutron starts in the center. Players alternate
  * moving the neutron then one of their pawns. Win by getting the neutron
  * to your home row.
+ *
+ * Legal actions, terminal status and winner are computed once per position,
+ * when it is built, so the search can ask for them as often as it likes.
  */
 class GameState {
 public:
@@ -57,6 +65,7 @@ public:
     static constexpr int kNumDirections = 8;
     static constexpr int kMaxDistance = 4;
     static constexpr int kActionSize = 800;  // 25 cells × 8 dirs × 4 distances
+    static constexpr int kMaxActions = 40;   // 5 pawns × 8 dirs
 
     /**
      * @brief Construct the initial game state.
@@ -69,11 +78,26 @@ public:
      * @param board 25-element array of piece values (0-3).
      * @param current_player Current player (1 or 2).
      * @param phase Current phase (move neutron or pawn).
+     * @throws std::invalid_argument if a player has more than 5 pawns.
      */
     GameState(const std::array<int8_t, kNumCells>& board,
               int current_player,
               Phase phase);
 
+    /**
+     * @brief Construct from the game's own board.
+     *
+     * Player 1 plays WHITE and player 2 BLACK; highlighted cells count as plain ones.
+     *
+     * @param cells Column-major cells as in rules::Cells.
+     * @param current_player Current player (1 or 2).
+     * @param phase Current phase (move neutron or pawn).
+     * @throws std::invalid_argument if a player has more than 5 pawns.
+     */
+    GameState(const rules::Cells& cells,
+              int current_player,
+              Phase phase);
+
     /**
      * @brief Get all legal actions for the current state.
      *
@@ -81,6 +105,11 @@ public:
      */
     std::vector<int> get_legal_actions() const;
 
+    /**
+     * @brief Legal actions, as get_legal_actions() but without allocating.
+     */
+    std::span<const int16_t> legal_actions() const { return {legal_.data(), num_legal_}; }
+
     /**
      * @brief Apply an action and return the resulting state.
      *
@@ -95,7 +124,7 @@ public:
      *
      * @return true if the game has ended.
      */
-    bool is_terminal() const;
+    bool is_terminal() const { return terminal_; }
 
     /**
      * @brief Get the winner of a terminal state.
@@ -132,11 +161,19 @@ public:
     std::vector<float> encode() const;
 
     /**
-     * @brief Get the raw board array.
+     * @brief Zobrist hash of the board, player to move and phase.
      *
-     * @return Reference to the 25-element board array.
+     * Keys everything encode() sees, so equal hashes mean (up to collisions)
+     * equal network input.
      */
-    const std::array<int8_t, kNumCells>& board() const { return board_; }
+    uint64_t hash() const;
+
+    /**
+     * @brief Get the board in the rules core representation.
+     *
+     * @return Column-major cells (PieceKind values, never highlighted).
+     */
+    const rules::Cells& cells() const { return cells_; }
 
     /**
      * @brief Get piece at a cell.
@@ -204,46 +241,48 @@ public:
      */
     std::string to_string() const;
 
+    /**
+     * @brief Same board, player to move and phase.
+     */
+    bool operator==(const GameState&) const = default;
+
 private:
-    std::array<int8_t, kNumCells> board_;
+    // Same board as the minimax engine; cells and actions here stay row-major (row * 5 + col).
+    rules::Cells cells_;
     int current_player_;
     Phase phase_;
 
-    // Direction deltas (row, col) for each direction
-    static constexpr std::array<std::pair<int, int>, kNumDirections> kDirectionDeltas = {{
-        {-1, 0},   // North
-        {-1, 1},   // NorthEast
-        {0, 1},    // East
-        {1, 1},    // SouthEast
-        {1, 0},    // South
-        {1, -1},   // SouthWest
-        {0, -1},   // West
-        {-1, -1}   // NorthWest
-    }};
+    // Derived from the above: hash, occupancy and neutron kept by apply_action(), the rest by update()
+    uint64_t board_hash_ = 0;  // rules::hash(cells_)
+    uint32_t occupied_ = 0;    // bit per column-major index
+    int8_t neutron_ = -1;    // column-major index, -1 if none
+    bool terminal_ = false;
+    int8_t winner_ = 0;  // 0 = none (not terminal, or no neutron)
+    uint8_t num_legal_ = 0;
+    std::array<int16_t, kMaxActions> legal_{};
 
     /**
-     * @brief Find the neutron's position.
+     * @brief Generate the legal actions and settle terminal status and winner.
      *
-     * @return Cell index of the neutron.
+     * @param reset Recompute hash, occupancy and neutron from the cells first.
      */
-    int find_neutron() const;
+    void update(bool reset);
 
     /**
-     * @brief Get legal moves for a specific piece.
+     * @brief Index in cells_ of a row-major cell.
      *
-     * @param cell Cell containing the piece.
-     * @return Vector of (direction, distance) pairs.
+     * @param cell Cell index (0-24).
+     * @return Column-major index (0-24).
      */
-    std::vector<std::pair<int, int>> get_piece_moves(int cell) const;
+    static int to_index(int cell);
 
     /**
-     * @brief Calculate maximum slide distance in a direction.
+     * @brief Pawn kind of a player.
      *
-     * @param cell Starting cell.
-     * @param direction Direction index.
-     * @return Maximum distance (0 if blocked immediately).
+     * @param player 1 or 2.
+     * @return PieceKind::WHITE for player 1, PieceKind::BLACK for player 2.
      */
-    int max_slide_distance(int cell, int direction) const;
+    static uint8_t pawn_of(int player);
 };
 
 }  // namespace neutron_rl
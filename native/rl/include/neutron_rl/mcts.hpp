@@ -1,11 +1,16 @@
 #pragma once
 
-#include <memory>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <unordered_map>
 #include <vector>
 
+#include "SearchTask.h"
+#include "neutron_rl/eval_cache.hpp"
 #include "neutron_rl/game_state.hpp"
 #include "neutron_rl/model_loader.hpp"
+#include "neutron_rl/search_config.hpp"
 
 namespace neutron_rl {
 
@@ -18,107 +23,319 @@ struct MCTSConfig {
     float temperature = 0.0f;     // Temperature for action selection (0 = greedy)
     float dirichlet_alpha = 0.3f; // Dirichlet noise alpha for root
     float dirichlet_epsilon = 0.0f; // Dirichlet noise weight (0 = no noise)
+    int leaf_batch = 1;           // Leaves per infer_batch call (1 = one infer per simulation), per thread
+    float virtual_loss = 1.0f;    // Loss charged per pending visit while a leaf awaits the network
 };
 
 /**
- * @brief Node in the MCTS tree.
+ * @brief MCTS tree stored in an arena (node pool), kept from one search to
+ * the next (subtree reuse).
+ *
+ * Nodes are indices into one vector and hold the position. Edges are
+ * indices into parallel arrays (action, prior, visits, value sum, pending
+ * visits, child), so select_child() scans a node's edges in contiguous
+ * memory. expand() only writes edges: the child node and its position are
+ * created the first time selection goes through the edge. Storage only
+ * grows during a search and clear() drops it all at once.
+ *
+ * An edge holds the statistics of the node it leads to: visits, value sum
+ * from that node's player's view, and pending visits of leaves awaiting
+ * the network (virtual loss). Edge 0 holds the root's.
+ *
+ * After a search MCTS keeps the subtree of the action it chose. The next
+ * search looks for its own position in that subtree, a few plies down
+ * (the pawn phase right after the neutron phase, or the opponent's turn),
+ * and starts from that node with its visits instead of from scratch.
+ *
+ * One search at a time per tree. While shared (see share()) several threads
+ * may run simulations of that search at once: statistics are updated
+ * atomically, a leaf is evaluated by the one thread that claims it, and
+ * edges and children are published with release stores, so a thread
+ * never sees half of an expansion.
  */
-class MCTSNode {
+class SearchTree {
 public:
+    using Index = uint32_t;
+
+    static constexpr Index kNone = ~Index{0};
+
+    /**
+     * @brief Most legal actions of a position: 5 pawns x 8 directions.
+     */
+    static constexpr Index kMaxEdges = Evaluation::kMaxActions;
+
     /**
-     * @brief Construct a new MCTS Node.
+     * @brief Root the tree at `state`, reusing the kept subtree if it holds it.
      *
-     * @param state Game state at this node.
-     * @param prior Prior probability from policy network.
-     * @param parent Parent node (nullptr for root).
-     * @param action Action that led to this node (-1 for root).
+     * Looks for `state` at most `max_depth` plies below the kept root. A
+     * found node with children becomes the root and its subtree is moved
+     * to fresh storage; otherwise the tree restarts with an unexpanded root.
+     *
+     * @param state Position of the next search.
+     * @param max_depth Plies below the kept root to look at.
+     * @return Visits of the new root (0 when starting from scratch).
+     */
+    int reuse(const GameState& state, int max_depth);
+
+    /**
+     * @brief Keep the subtree of the root's child reached by `action` for
+     * the next search and free the rest.
+     */
+    void keep(int action);
+
+    /**
+     * @brief Drop every node (new game, new model).
+     */
+    void clear();
+
+    /**
+     * @brief Visits of the root the last reuse() kept (0 if none).
+     */
+    int reused_visits() const { return reused_visits_; }
+
+    /**
+     * @brief Reserve room for the nodes of `simulations` more simulations.
      */
-    MCTSNode(const GameState& state, float prior,
-             MCTSNode* parent = nullptr, int action = -1);
+    void reserve(int simulations);
 
     /**
-     * @brief Check if this node is a leaf (unexpanded).
+     * @brief Let several threads run simulations of the current search.
+     *
+     * The arena cannot grow while shared, so it is sized up front for the
+     * nodes and edges `simulations` more simulations may add. Call unshare()
+     * once the other threads are done, before reuse() or keep().
      */
-    bool is_leaf() const { return children_.empty() && !state_.is_terminal(); }
+    void share(int simulations);
 
     /**
-     * @brief Check if this node is terminal.
+     * @brief Back to single-threaded use; drops the room share() left unused.
      */
-    bool is_terminal() const { return state_.is_terminal(); }
+    void unshare();
 
     /**
-     * @brief Get the Q-value (average value) for this node.
+     * @brief Bytes held by the arena (capacity of every array).
      */
-    float q_value() const;
+    size_t memory_bytes() const;
+
+    Index root() const { return root_; }
+    const GameState& state(Index node) const { return states_[node]; }
+    bool is_terminal(Index node) const { return nodes_[node].terminal; }
 
     /**
-     * @brief Get the visit count.
+     * @brief Unexpanded and not terminal: the network must evaluate it.
      */
-    int visit_count() const { return visit_count_; }
+    bool is_leaf(Index node) const {
+        return load(nodes_[node].num_edges, std::memory_order_acquire) == 0 && !nodes_[node].terminal;
+    }
+
+    int visit_count(Index node) const { return load(visits_[nodes_[node].edge]); }
 
     /**
-     * @brief Get the prior probability.
+     * @brief Reserve a leaf for evaluation by the calling thread.
+     *
+     * @return false if another thread holds it, or expanded it meanwhile.
      */
-    float prior() const { return prior_; }
+    bool try_claim(Index node);
 
     /**
-     * @brief Get the action that led to this node.
+     * @brief Give back a leaf reserved by try_claim().
      */
-    int action() const { return action_; }
+    void release(Index node);
 
     /**
-     * @brief Get the game state.
+     * @brief Average value of the node, from its player's view (0 unvisited).
      */
-    const GameState& state() const { return state_; }
+    float q_value(Index node) const;
 
     /**
-     * @brief Get children nodes.
+     * @brief Create the edges of a leaf, one per legal action with its
+     * prior; the children themselves are created lazily.
+     *
+     * @param node Leaf to expand.
+     * @param evaluation Network evaluation of the leaf's position.
      */
-    const std::vector<std::unique_ptr<MCTSNode>>& children() const { return children_; }
+    void expand(Index node, const Evaluation& evaluation);
 
     /**
-     * @brief Select the best child using PUCT.
+     * @brief Child with the best PUCT score, created if it did not exist yet.
+     *
+     * Pending visits (see add_virtual_loss()) count as visits that lost
+     * `virtual_loss` each, so leaves of the same batch, or of other
+     * threads, spread out.
      *
+     * @param node Expanded node.
      * @param c_puct Exploration constant.
-     * @return Pointer to the best child.
+     * @param virtual_loss Value of one pending visit.
+     * @return Index of the child node.
      */
-    MCTSNode* select_child(float c_puct);
+    Index select_child(Index node, float c_puct, float virtual_loss = 1.0f);
 
     /**
-     * @brief Expand this node with policy priors.
+     * @brief Backpropagate a value from `node` up to the root.
      *
-     * @param policy_logits Policy logits from the neural network.
+     * @param node Evaluated node.
+     * @param value Value from the view of the player to move at `node`.
      */
-    void expand(const std::vector<float>& policy_logits);
+    void backpropagate(Index node, float value);
 
     /**
-     * @brief Backpropagate a value through the tree.
+     * @brief Mark a pending visit on `node` and its ancestors.
      *
-     * @param value Value to backpropagate (from current player's perspective).
+     * Called on a leaf queued for batched evaluation; undone by
+     * revert_virtual_loss() before the real value is backpropagated.
      */
-    void backpropagate(float value);
+    void add_virtual_loss(Index node);
 
     /**
-     * @brief Get visit counts for all children.
+     * @brief Undo add_virtual_loss() on `node` and its ancestors.
+     */
+    void revert_virtual_loss(Index node);
+
+    /**
+     * @brief Get visit counts for all children of `node`.
      *
      * @return Map from action to visit count.
      */
-    std::unordered_map<int, int> get_visit_counts() const;
+    std::unordered_map<int, int> visit_counts(Index node) const;
 
     /**
-     * @brief Get the parent node.
+     * @brief Call visit(action, visits) for every edge of `node`, in order.
      */
-    MCTSNode* parent() const { return parent_; }
+    template <typename Visit>
+    void for_each_child(Index node, Visit&& visit) const {
+        const Node& n = nodes_[node];
+        const Index last = n.first_edge + load(n.num_edges, std::memory_order_acquire);
+        for (Index e = n.first_edge; e < last; ++e) {
+            visit(static_cast<int>(actions_[e]), load(visits_[e]));
+        }
+    }
 
 private:
-    GameState state_;
-    float prior_;
-    MCTSNode* parent_;
-    int action_;
-
-    std::vector<std::unique_ptr<MCTSNode>> children_;
-    int visit_count_ = 0;
-    float value_sum_ = 0.0f;
+    struct Node {
+        Index parent;      // kNone for the root
+        Index edge;        // Edge leading here (0 for the root)
+        Index first_edge;  // Edges of the children, contiguous
+        uint16_t num_edges;
+        Phase phase;       // Of the state, for selection and backpropagation
+        bool terminal;
+        bool claimed;      // A thread is evaluating this leaf
+    };
+
+    // Child being created by another thread (shared trees only)
+    static constexpr Index kBusy = kNone - 1;
+
+    Index root_ = kNone;
+    int reused_visits_ = 0;
+    std::vector<Node> nodes_;
+    std::vector<GameState> states_;  // [node]; apart, so walking the tree does not load them
+
+    // While shared, the arrays are sized by share() and these count the used part
+    bool shared_ = false;
+    Index used_nodes_ = 0;
+    Index used_edges_ = 0;
+
+    // Edges, structure of arrays
+    std::vector<int16_t> actions_;
+    std::vector<float> priors_;
+    std::vector<int32_t> visits_;
+    std::vector<float> value_sums_;
+    std::vector<int32_t> virtual_losses_;
+    std::vector<Index> children_;
+
+    /**
+     * @brief Start over with a single unexpanded root.
+     */
+    void reset(const GameState& state);
+
+    Index add_edge(int action, float prior);
+    Index add_node(const GameState& state, Index parent, Index edge);
+
+    /**
+     * @brief Room for `count` contiguous edges; returns the first.
+     */
+    Index add_edges(Index count);
+
+    /**
+     * @brief Read a field other threads may update (a plain load on x86).
+     */
+    template <typename T>
+    static T load(const T& field, std::memory_order order = std::memory_order_relaxed) {
+        return std::atomic_ref(const_cast<T&>(field)).load(order);
+    }
+
+    /**
+     * @brief Add to a statistic, atomically while shared.
+     */
+    template <typename T>
+    void add(T& field, T delta) const {
+        if (shared_) {
+            std::atomic_ref(field).fetch_add(delta, std::memory_order_relaxed);
+        } else {
+            field += delta;
+        }
+    }
+
+    /**
+     * @brief Move the subtree of `node` to fresh storage, `node` as root.
+     */
+    void compact(Index node);
+};
+
+/**
+ * @brief Threads that share the searches of one caller (tree parallelism).
+ *
+ * MCTS::search_resumable() with a crew opens its tree to the crew: helper
+ * threads running help() take simulations from the same budget as the
+ * caller until it is spent, then wait for the next search. All of them
+ * descend the one tree; virtual loss spreads them over different leaves,
+ * and their network calls share forward passes when the model batches
+ * (ModelLoader::enable_batching()).
+ *
+ * close() when the caller runs no more searches: help() then finishes.
+ */
+class SearchCrew {
+public:
+    /**
+     * @brief Run simulations of the searches opened on the crew.
+     *
+     * Suspends at slice checkpoints, and ends the slice whenever no search
+     * is open (with an unlimited slice it yields the thread instead).
+     *
+     * @param slice Time-slice budget of this helper.
+     * @return Task that finishes after close().
+     */
+    SearchTask<void> help(SearchSlice& slice);
+
+    /**
+     * @brief No more searches: running help() tasks finish.
+     */
+    void close() { closed_.store(true, std::memory_order_release); }
+
+private:
+    friend class MCTS;
+
+    // The open search (budget and counters), see mcts.cpp
+    struct Search;
+
+    std::atomic<Search*> open_{nullptr};
+    std::atomic<int> inside_{0};  // Helpers using open_
+    std::atomic<bool> closed_{false};
+
+    /**
+     * @brief Keeps `search` open to the helpers while it lives, also when
+     * the search throws; afterwards no helper uses it or its tree.
+     */
+    class Opening {
+    public:
+        Opening(SearchCrew& crew, Search& search);
+        ~Opening();
+        Opening(const Opening&) = delete;
+        Opening& operator=(const Opening&) = delete;
+
+    private:
+        SearchCrew& crew_;
+        Search& search_;
+    };
 };
 
 /**
@@ -134,7 +351,7 @@ public:
      * @param model Reference to the model loader.
      * @param config MCTS configuration.
      */
-    MCTS(ModelLoader& model, const MCTSConfig& config = MCTSConfig{});
+    MCTS(const ModelLoader& model, const MCTSConfig& config = MCTSConfig{});
 
     /**
      * @brief Run MCTS search and return the best action.
@@ -144,6 +361,43 @@ public:
      */
     int search(const GameState& state);
 
+    /**
+     * @brief Resumable search that suspends every `slice.budget` simulations.
+     *
+     * Takes its own copy of the state and configuration, so the MCTS object
+     * may be reconfigured by other requests while this search is suspended.
+     *
+     * With a `tree` the search starts from the node of `state` it holds, if
+     * any, and config.num_simulations counts the visits already there: only
+     * the rest are simulated. The chosen action's subtree is kept in `tree`
+     * when the search finishes.
+     *
+     * @param state Current game state.
+     * @param config Configuration for this search.
+     * @param slice Time-slice budget shared with the caller's driver.
+     * With a `crew` its helpers run simulations on the same tree; the search
+     * finishes once every simulation of the budget has, whichever thread
+     * ran it.
+     *
+     * @param state Current game state.
+     * @param config Configuration for this search.
+     * @param slice Time-slice budget shared with the caller's driver.
+     * @param progress Optional snapshot updated after each simulation.
+     * @param tree Optional tree to reuse; must outlive the task.
+     * @param crew Optional helper threads; must outlive the task.
+     * @return Task yielding the best action index.
+     */
+    SearchTask<int> search_resumable(GameState state, MCTSConfig config, SearchSlice& slice,
+                                     SearchProgress* progress = nullptr,
+                                     SearchTree* tree = nullptr,
+                                     SearchCrew* crew = nullptr);
+
+    /**
+     * @brief Plies below a kept root where search_resumable() looks for its
+     * position: the opponent's neutron and pawn moves.
+     */
+    static constexpr int kReuseDepth = 2;
+
     /**
      * @brief Run MCTS search and return action probabilities.
      *
@@ -173,15 +427,76 @@ public:
     void set_temperature(float temp) { config_.temperature = temp; }
 
 private:
-    ModelLoader& model_;
+    friend class SearchCrew;
+
+    const ModelLoader& model_;
     MCTSConfig config_;
 
     /**
      * @brief Run one simulation (selection, expansion, evaluation, backprop).
      *
-     * @param root Root node of the search tree.
+     * @param tree Search tree, root expanded.
+     * @param c_puct Exploration constant.
      */
-    void simulate(MCTSNode* root);
+    void simulate(SearchTree& tree, float c_puct);
+
+    /**
+     * @brief Run up to `limit` simulations, evaluating their leaves in batches.
+     *
+     * Selects up to config.leaf_batch leaves under virtual loss, evaluates
+     * them with one infer_batch call, then expands and backpropagates each.
+     * Stops early when selection returns to a leaf already in the batch.
+     * Leaves found in the evaluation cache are expanded on the spot.
+     * With leaf_batch <= 1 it is exactly one simulate() call.
+     *
+     * @param tree Search tree, root expanded.
+     * @param config Search configuration (c_puct, leaf_batch, virtual_loss).
+     * @param limit Simulations left in the search (at least 1).
+     * @return Simulations run (at least 1).
+     */
+    int simulate_batch(SearchTree& tree, const MCTSConfig& config, int limit);
+
+    /**
+     * @brief simulate_batch() on a tree other threads search too.
+     *
+     * Every leaf goes under virtual loss, whatever the batch size, and is
+     * claimed first; the batch stops at a leaf another thread (or this
+     * batch) holds, so it may run no simulation at all.
+     *
+     * @param tree Shared search tree, root expanded.
+     * @param config Search configuration (c_puct, leaf_batch, virtual_loss).
+     * @param limit Most simulations to run (at least 1).
+     * @return Simulations run.
+     */
+    int simulate_shared(SearchTree& tree, const MCTSConfig& config, int limit);
+
+    /**
+     * @brief Look a leaf up in the model's evaluation cache, if it has one.
+     *
+     * @return true when `evaluation` was set from the cache.
+     */
+    bool cached(const GameState& state, Evaluation& evaluation) const;
+
+    /**
+     * @brief Evaluation of a leaf from its forward pass, kept in the model's
+     * evaluation cache (consumes result.policy_logits).
+     */
+    Evaluation evaluated(const GameState& state, InferenceResult& result) const;
+
+    /**
+     * @brief Value of a terminal position for the player to move there.
+     */
+    static float terminal_value(const GameState& state);
+
+    /**
+     * @brief Refresh a progress snapshot from the root's children.
+     */
+    static void update_progress(const SearchTree& tree, int simulations, SearchProgress& progress);
+
+    /**
+     * @brief Expand a fresh (unexpanded) root with the network policy.
+     */
+    void expand_root(SearchTree& tree);
 
     /**
      * @brief Select action from visit counts.
@@ -191,6 +506,11 @@ private:
      */
     int select_action(const std::unordered_map<int, int>& visit_counts);
 
+    /**
+     * @brief Select action from visit counts with an explicit temperature.
+     */
+    int select_action(const std::unordered_map<int, int>& visit_counts, float temperature);
+
     /**
      * @brief Convert visit counts to probabilities.
      *
@@ -203,9 +523,9 @@ private:
     /**
      * @brief Add Dirichlet noise to root priors.
      *
-     * @param root Root node.
+     * @param tree Search tree, root expanded.
      */
-    void add_dirichlet_noise(MCTSNode* root);
+    void add_dirichlet_noise(SearchTree& tree);
 };
 
 }  // namespace neutron_rl
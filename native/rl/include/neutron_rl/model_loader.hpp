@@ -1,12 +1,21 @@
 #pragma once
 
+#include <chrono>
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
 #include <tuple>
 #include <vector>
 
+#ifndef NEUTRON_RL_NO_TORCH
 #include <torch/script.h>
 #include <torch/torch.h>
+#endif
+
+#include "neutron_rl/eval_cache.hpp"
+#include "neutron_rl/native_network.hpp"
+#include "neutron_rl/search_config.hpp"
 
 namespace neutron_rl {
 
@@ -26,6 +35,9 @@ struct InferenceResult {
  *
  * This class handles loading exported TorchScript models (.pt files)
  * and running forward inference for the Neutron game neural network.
+ * Weights exported with `neutron_rl_weights export` run on NativeNetwork
+ * instead, on the CPU without libtorch; a build with NEUTRON_RL_NO_TORCH
+ * loads only those.
  *
  * Example usage:
  * @code
@@ -39,7 +51,19 @@ struct InferenceResult {
  * @endcode
  */
 class ModelLoader {
+    class Batcher;  // Inference thread of enable_batching()
+
 public:
+    /**
+     * @brief Callback invoked after every forward pass.
+     *
+     * Receives the batch size and the wall time of the forward call. Runs
+     * on the inferring thread, so it must be cheap and thread-safe. With
+     * batching it runs on each calling thread once its answer arrives, with
+     * the size of the shared forward pass.
+     */
+    using InferenceObserver = std::function<void(size_t batch_size, std::chrono::microseconds elapsed)>;
+
     /**
      * @brief Construct a new Model Loader.
      *
@@ -51,23 +75,37 @@ public:
 
     /**
      * @brief Destroy the Model Loader.
+     *
+     * Stops the inference thread, if any, after answering queued requests.
      */
-    ~ModelLoader() = default;
+    ~ModelLoader();
 
-    // Non-copyable but movable
+    // Neither copyable nor movable: the inference thread points back to it
     ModelLoader(const ModelLoader&) = delete;
     ModelLoader& operator=(const ModelLoader&) = delete;
-    ModelLoader(ModelLoader&&) = default;
-    ModelLoader& operator=(ModelLoader&&) = default;
+    ModelLoader(ModelLoader&&) = delete;
+    ModelLoader& operator=(ModelLoader&&) = delete;
 
     /**
-     * @brief Load a TorchScript model from file.
+     * @brief Load a TorchScript model or exported weights from file.
+     *
+     * With InferencePrecision::Int8 the weights are quantized on load,
+     * calibrated on positions of a few games the network plays against
+     * itself (moves drawn from its policy); that takes some
+     * milliseconds. TorchScript models only run in FP32.
      *
-     * @param model_path Path to the .pt TorchScript model file.
+     * @param model_path Path to the .pt TorchScript model file, or to a
+     *                   weights file (NativeNetwork::is_weights_file()).
+     * @param precision Arithmetic of the forward passes.
      * @return true if loading succeeded.
      * @return false if loading failed (check get_error_message()).
      */
-    bool load(const std::string& model_path);
+    bool load(const std::string& model_path, InferencePrecision precision = InferencePrecision::Float32);
+
+    /**
+     * @brief Arithmetic of the loaded model's forward passes.
+     */
+    InferencePrecision precision() const;
 
     /**
      * @brief Check if a model is loaded and ready.
@@ -84,8 +122,10 @@ public:
      *                     (4 channels × 5 × 5 board).
      * @return InferenceResult with policy logits and value.
      * @throws std::runtime_error if no model is loaded.
+     *
+     * Safe to call from several threads at once on a loaded model.
      */
-    InferenceResult infer(const std::vector<float>& board_tensor);
+    InferenceResult infer(const std::vector<float>& board_tensor) const;
 
     /**
      * @brief Run batched inference on multiple board states.
@@ -95,7 +135,70 @@ public:
      * @throws std::runtime_error if no model is loaded.
      */
     std::vector<InferenceResult> infer_batch(
-        const std::vector<std::vector<float>>& board_tensors);
+        const std::vector<std::vector<float>>& board_tensors) const;
+
+    /**
+     * @brief Run infer() and infer_batch() calls of all searches on one inference thread.
+     *
+     * Concurrent calls are queued and answered by one forward pass of up to
+     * `batching.max_batch` positions, through futures. A pass starts once
+     * every thread inside an activity() is waiting, the batch is full, or the
+     * oldest request has waited `batching.max_wait`; a lone search is thus
+     * answered at once. Call before sharing the loader; max_batch <= 1 keeps
+     * every call on its own thread, as without batching.
+     *
+     * @param batching Batch size and wait limits.
+     */
+    void enable_batching(const InferenceBatching& batching);
+
+    /**
+     * @brief Scope of a thread that may call infer() at any moment.
+     *
+     * The inference thread waits for such threads (up to max_wait) before
+     * starting a forward pass, so their requests share it. No effect
+     * without batching.
+     */
+    class Activity {
+    public:
+        ~Activity();
+        Activity(const Activity&) = delete;
+        Activity& operator=(const Activity&) = delete;
+
+    private:
+        friend class ModelLoader;
+        explicit Activity(Batcher* batcher);
+
+        Batcher* batcher_;
+    };
+
+    /**
+     * @brief Mark the calling thread as searching until the result is destroyed.
+     */
+    Activity activity() const;
+
+    /**
+     * @brief Keep the evaluations of this model's searches for later ones.
+     *
+     * Call before sharing the loader; 0 entries turns the cache off.
+     *
+     * @param entries Most positions kept (see EvalCache).
+     * @param observer Lookup callback (telemetry), or nullptr.
+     */
+    void enable_eval_cache(size_t entries, EvalCache::Observer observer = nullptr);
+
+    /**
+     * @brief Evaluation cache shared by every search on this model.
+     *
+     * @return The cache, or nullptr when off. Thread-safe.
+     */
+    EvalCache* eval_cache() const;
+
+    /**
+     * @brief Install a callback to observe inference calls (telemetry).
+     *
+     * @param observer Callback, or nullptr to disable.
+     */
+    void set_inference_observer(InferenceObserver observer);
 
     /**
      * @brief Get the last error message.
@@ -107,10 +210,19 @@ public:
     /**
      * @brief Get the current device string.
      *
-     * @return Device string ("cpu" or "cuda:N").
+     * @return Device string ("cpu" or "cuda:N"); always "cpu" for
+     *         exported weights.
      */
     std::string get_device() const;
 
+    /**
+     * @brief Process-unique id of this loader.
+     *
+     * Unlike the address, never reused by a later model, so it can key
+     * cached search results.
+     */
+    uint64_t id() const;
+
     /**
      * @brief Check if CUDA is available.
      *
@@ -119,10 +231,28 @@ public:
     static bool cuda_available();
 
 private:
-    torch::jit::script::Module model_;
+    void notify_observer(size_t batch_size, std::chrono::steady_clock::time_point started) const;
+
+    /**
+     * @brief One forward pass over `board_tensors` (no observer call).
+     */
+    std::vector<InferenceResult> forward_batch(
+        const std::vector<const std::vector<float>*>& board_tensors) const;
+
+#ifndef NEUTRON_RL_NO_TORCH
+    // forward() is not const in the TorchScript API, but inference does not
+    // change the module.
+    mutable torch::jit::script::Module model_;
     torch::Device device_;
+#endif
+    // Set when exported weights are loaded; runs instead of model_
+    std::unique_ptr<NativeNetwork> native_;
     bool loaded_ = false;
     std::string error_message_;
+    InferenceObserver observer_;
+    uint64_t id_;
+    std::unique_ptr<Batcher> batcher_;
+    std::unique_ptr<EvalCache> eval_cache_;
 
     // Expected tensor dimensions
     static constexpr int kInputChannels = 4;
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "neutron_rl/model_loader.hpp"
+
+namespace neutron_rl {
+
+/**
+ * @brief Process-wide cache of loaded models, shared between agents.
+ *
+ * Agents created in different Node environments (the main thread and each
+ * worker_thread) that load the same file share one ModelLoader. A shared
+ * loader is never modified after it is published, so concurrent infer()
+ * calls need no locking. The cache only holds weak references: a model is
+ * freed when the last agent using it goes away. With batching, searches of
+ * every environment share the model's inference thread and forward passes;
+ * with an evaluation cache, also the positions any of them evaluated.
+ */
+class ModelRegistry {
+public:
+    /**
+     * @brief Get the loaded model for a path, loading it on first use.
+     *
+     * @param model_path Path to the .pt TorchScript model file or exported
+     *                   weights.
+     * @param device Device for inference ("cpu" or "cuda").
+     * @param observer Installed before the model is shared; ignored when the
+     *                 model is already cached.
+     * @param batching Batching of the model's inference calls (see
+     *                 ModelLoader::enable_batching()); also only used on load.
+     * @param eval_cache_entries Size of the model's evaluation cache (see
+     *                           ModelLoader::enable_eval_cache()); 0 = off,
+     *                           only used on load.
+     * @param cache_observer Lookup callback of that cache; only used on load.
+     * @param precision Arithmetic of the forward passes (see
+     *                  ModelLoader::load()); FP32 and INT8 of one file are
+     *                  different models.
+     * @return Shared, read-only model.
+     * @throws std::runtime_error if loading fails.
+     */
+    static std::shared_ptr<const ModelLoader> acquire(
+        const std::string& model_path,
+        const std::string& device,
+        ModelLoader::InferenceObserver observer = nullptr,
+        const InferenceBatching& batching = {},
+        size_t eval_cache_entries = 0,
+        EvalCache::Observer cache_observer = nullptr,
+        InferencePrecision precision = InferencePrecision::Float32);
+
+private:
+    static std::mutex mutex_;
+    static std::map<std::string, std::weak_ptr<const ModelLoader>> models_;
+};
+
+}  // namespace neutron_rl
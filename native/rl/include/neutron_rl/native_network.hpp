@@ -0,0 +1,171 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace neutron_rl {
+
+/**
+ * @brief The policy/value network, evaluated without libtorch.
+ *
+ * Runs the same network as data/model.pt (input convolution, residual
+ * blocks, policy and value heads) from a flat weights file written by
+ * `neutron_rl_weights export`. Batch norms are folded into the preceding
+ * convolutions on load. Activations are kept cell-major (cells x
+ * channels, the trunk's with a zero border), so every 3x3 or 1x1
+ * convolution and every dense layer is the same fused kernel: a sum of
+ * vector-matrix products plus bias, residual and ReLU, vectorized over
+ * output channels with AVX-512 or AVX2 when the CPU has them and plain C++
+ * otherwise. Convolutions run a board row at a time, so each weight load
+ * serves five cells.
+ *
+ * quantize() switches the residual trunk, nearly all the arithmetic, to
+ * INT8: 7-bit activations times 8-bit weights summed in 32 bits (AVX-512
+ * VNNI, AVX2 or C++), rescaled to FP32 for bias, residual and ReLU. The
+ * heads stay FP32.
+ *
+ * Weights file (little-endian): "NRLW", uint32 version, uint32 tensor
+ * count, then per tensor uint32 name length, name, uint32 rank, uint32
+ * sizes, float32 values. Names are the TorchScript ones
+ * ("res_blocks.0.conv1.weight").
+ *
+ * Read-only once loaded: forward() may run on several threads at once.
+ */
+class NativeNetwork {
+public:
+    /**
+     * @brief Instruction set of the kernels.
+     */
+    enum class Isa { Scalar, Avx2, Avx512 };
+
+    static constexpr int kInputChannels = 4;
+    static constexpr int kBoardSize = 5;
+    static constexpr int kCells = kBoardSize * kBoardSize;
+    static constexpr int kActionSize = 800;
+
+    /**
+     * @brief Check whether a file starts like a weights file.
+     */
+    static bool is_weights_file(const std::string& path);
+
+    /**
+     * @brief Load exported weights.
+     *
+     * @param path Weights file.
+     * @param isa Kernels to run; lowered to what the CPU supports.
+     * @throws std::runtime_error if the file is missing, malformed or does
+     *         not hold the expected layers.
+     */
+    static std::unique_ptr<NativeNetwork> load(const std::string& path, Isa isa = preferred_isa());
+
+    /**
+     * @brief Best instruction set of this CPU, or NEUTRON_RL_ISA (scalar,
+     * avx2, avx512) when set to a supported one.
+     */
+    static Isa preferred_isa();
+
+    static const char* isa_name(Isa isa);
+
+    Isa isa() const;
+
+    /**
+     * @brief Switch the trunk to INT8 (post-training quantization).
+     *
+     * Weights get one scale per output channel and the input of each
+     * convolution one scale, the largest value it takes over the FP32
+     * forward passes of `calibration`. Call before sharing the network.
+     *
+     * @param calibration count x 4 x 5 x 5 floats, as GameState::encode().
+     * @param count Positions.
+     */
+    void quantize(const float* calibration, size_t count);
+
+    bool quantized() const;
+
+    /**
+     * @brief Forward pass over `batch` positions.
+     *
+     * @param input batch x 4 x 5 x 5 floats, as GameState::encode().
+     * @param batch Positions.
+     * @param policy batch x 800 policy logits (output).
+     * @param value batch values in [-1, 1] (output).
+     */
+    void forward(const float* input, size_t batch, float* policy, float* value) const;
+
+    /**
+     * @brief Weights of one layer: a matrix of in x out per kernel tap (9
+     * for a 3x3 convolution, 1 otherwise), batch norm folded in.
+     */
+    struct Layer {
+        int in = 0;
+        int out = 0;
+        std::vector<float> weights;  // [tap][in][out]
+        std::vector<float> bias;     // [out]
+    };
+
+    /**
+     * @brief A convolution after quantize(): input code x weight code, times
+     * `scale`, is the FP32 product.
+     */
+    struct QuantizedLayer {
+        int in = 0;
+        int out = 0;
+        float input_scale = 1.0f;     // input = code * input_scale, codes 0..127
+        std::vector<int8_t> weights;  // [tap][in / 4][out][4]
+        std::vector<float> scale;     // [out] input_scale * weight scale
+        std::vector<float> bias;      // [out]
+    };
+
+private:
+    struct Block {
+        Layer conv1;
+        Layer conv2;
+    };
+
+    struct QuantizedBlock {
+        QuantizedLayer conv1;
+        QuantizedLayer conv2;
+    };
+
+    NativeNetwork() = default;
+
+    // Board with a zero border, the layout of the trunk's activations
+    static constexpr int kPaddedSize = kBoardSize + 2;
+    static constexpr int kPaddedCells = kPaddedSize * kPaddedSize;
+
+    // Index of a board cell in the padded layout
+    static int padded(int cell);
+
+    // One position; `scratch` holds scratch_size_ floats and `codes` kPaddedCells x channels bytes, zero
+    // at the borders. `inputs`, when set, gets the largest input of each trunk convolution (calibration).
+    void forward_one(const float* input, float* policy, float* value, float* scratch, uint8_t* codes,
+                     std::vector<float>* inputs = nullptr) const;
+    void heads(const float* trunk, float* policy, float* value, float* scratch) const;
+
+    // ReLU(conv(in) [+ residual]), padded in, residual and out
+    void conv3x3(const Layer& layer, const float* in, const float* residual, float* out) const;
+    // ReLU(conv(in)), padded in, unpadded out
+    void conv1x1(const Layer& layer, const float* in, float* out) const;
+    // conv3x3() of quantize(`in`), through `codes`
+    void conv3x3(const QuantizedLayer& layer, const float* in, uint8_t* codes, const float* residual, float* out) const;
+    void dense(const Layer& layer, const float* in, bool relu, float* out) const;
+
+    Isa isa_ = Isa::Scalar;
+    size_t scratch_size_ = 0;
+    Layer input_conv_;
+    std::vector<Block> blocks_;
+    Layer policy_conv_;
+    Layer policy_fc_;
+    Layer value_conv_;
+    Layer value_fc1_;
+    Layer value_fc2_;
+    bool quantized_ = false;
+    Isa quantized_isa_ = Isa::Scalar;
+    QuantizedLayer quantized_input_conv_;
+    std::vector<QuantizedBlock> quantized_blocks_;
+};
+
+}  // namespace neutron_rl
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <string>
+
+namespace neutron_rl {
+
+/**
+ * Search types that do not depend on libtorch, so the RL addon front can use
+ * them without loading the engine (see RlEngine.h).
+ */
+
+/**
+ * @brief Difficulty presets for the AI agent.
+ */
+enum class Difficulty {
+    Easy,    // ~100 MCTS simulations, some randomness
+    Medium,  // ~300 MCTS simulations
+    Hard     // ~800 MCTS simulations, deterministic
+};
+
+/**
+ * @brief Configuration for a difficulty level.
+ */
+struct DifficultyConfig {
+    int simulations;
+    float temperature;
+    int leaf_batch = 1;  // Leaves per network call (MCTSConfig::leaf_batch)
+    int threads = 1;     // Threads searching one tree (SearchCrew); 1 = no crew
+
+    static DifficultyConfig from_preset(Difficulty difficulty);
+    static DifficultyConfig from_simulations(int simulations, float temperature = 0.0f);
+
+    /**
+     * @brief Parse a preset name ("easy", "medium", "hard", case-insensitive).
+     *
+     * @return The preset's configuration, or std::nullopt for unknown names.
+     */
+    static std::optional<DifficultyConfig> from_name(const std::string& difficulty_name);
+};
+
+/**
+ * @brief Sharing of network calls between searches (see ModelLoader::enable_batching()).
+ */
+struct InferenceBatching {
+    size_t max_batch = 1;                      // Positions per forward pass (<= 1 = off)
+    std::chrono::microseconds max_wait{1000};  // Longest a request waits for others to join
+};
+
+/**
+ * @brief Arithmetic of the network's forward passes, chosen when the model is loaded.
+ */
+enum class InferencePrecision {
+    Float32,
+    Int8  // Exported weights only, calibrated on load (NativeNetwork::quantize())
+};
+
+/**
+ * @brief Snapshot of a running search, refreshed after every simulation.
+ */
+struct SearchProgress {
+    int simulations = 0;     // Simulations completed so far
+    int best_action = -1;    // Most visited root action (-1 before the first visit)
+    float best_share = 0.0f; // Share of root child visits held by best_action
+    float value = 0.0f;      // Root Q-value, from the side to move
+};
+
+}  // namespace neutron_rl
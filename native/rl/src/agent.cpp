@@ -2,32 +2,26 @@
 
 #include <algorithm>
 #include <stdexcept>
+#include <utility>
 
 namespace neutron_rl {
 
-// DifficultyConfig implementation
-
-DifficultyConfig DifficultyConfig::from_preset(Difficulty difficulty) {
-    switch (difficulty) {
-        case Difficulty::Easy:
-            return {100, 0.5f};
-        case Difficulty::Medium:
-            return {300, 0.2f};
-        case Difficulty::Hard:
-        default:
-            return {800, 0.0f};
-    }
-}
-
-DifficultyConfig DifficultyConfig::from_simulations(int simulations, float temperature) {
-    return {simulations, temperature};
-}
-
 // NeutronAgent implementation
 
 NeutronAgent::NeutronAgent(const std::string& device)
-    : difficulty_config_(DifficultyConfig::from_preset(Difficulty::Hard)) {
-    model_loader_ = std::make_unique<ModelLoader>(device);
+    : device_(device),
+      difficulty_config_(DifficultyConfig::from_preset(Difficulty::Hard)) {}
+
+NeutronAgent::NeutronAgent(std::shared_ptr<const ModelLoader> model)
+    : model_loader_(std::move(model)),
+      difficulty_config_(DifficultyConfig::from_preset(Difficulty::Hard)) {
+    if (model_loader_) {
+        device_ = model_loader_->get_device();
+        MCTSConfig config;
+        config.num_simulations = difficulty_config_.simulations;
+        config.temperature = difficulty_config_.temperature;
+        mcts_ = std::make_unique<MCTS>(*model_loader_, config);
+    }
 }
 
 NeutronAgent::~NeutronAgent() = default;
@@ -35,17 +29,21 @@ NeutronAgent::~NeutronAgent() = default;
 NeutronAgent::NeutronAgent(NeutronAgent&&) noexcept = default;
 NeutronAgent& NeutronAgent::operator=(NeutronAgent&&) noexcept = default;
 
-bool NeutronAgent::load_model(const std::string& model_path) {
-    if (!model_loader_->load(model_path)) {
-        error_message_ = model_loader_->get_error_message();
+bool NeutronAgent::load_model(const std::string& model_path, InferencePrecision precision) {
+    auto loader = std::make_shared<ModelLoader>(device_);
+    if (!loader->load(model_path, precision)) {
+        error_message_ = loader->get_error_message();
         return false;
     }
 
-    // Create MCTS instance
     MCTSConfig config;
     config.num_simulations = difficulty_config_.simulations;
     config.temperature = difficulty_config_.temperature;
-    mcts_ = std::make_unique<MCTS>(*model_loader_, config);
+
+    // Build the new MCTS before dropping the old loader it may reference.
+    auto mcts = std::make_unique<MCTS>(*loader, config);
+    mcts_ = std::move(mcts);
+    model_loader_ = std::move(loader);
 
     error_message_.clear();
     return true;
@@ -55,6 +53,10 @@ bool NeutronAgent::is_ready() const {
     return model_loader_ && model_loader_->is_loaded() && mcts_;
 }
 
+uint64_t NeutronAgent::model_id() const {
+    return model_loader_ ? model_loader_->id() : 0;
+}
+
 void NeutronAgent::set_difficulty(Difficulty difficulty) {
     difficulty_config_ = DifficultyConfig::from_preset(difficulty);
     if (mcts_) {
@@ -72,23 +74,14 @@ void NeutronAgent::set_difficulty(int simulations, float temperature) {
 }
 
 bool NeutronAgent::set_difficulty(const std::string& difficulty_name) {
-    std::string lower_name = difficulty_name;
-    std::transform(lower_name.begin(), lower_name.end(), lower_name.begin(),
-                   [](unsigned char c) { return std::tolower(c); });
-
-    if (lower_name == "easy") {
-        set_difficulty(Difficulty::Easy);
-        return true;
-    } else if (lower_name == "medium") {
-        set_difficulty(Difficulty::Medium);
-        return true;
-    } else if (lower_name == "hard") {
-        set_difficulty(Difficulty::Hard);
-        return true;
+    const auto config = DifficultyConfig::from_name(difficulty_name);
+    if (!config) {
+        error_message_ = "Unknown difficulty: " + difficulty_name;
+        return false;
     }
 
-    error_message_ = "Unknown difficulty: " + difficulty_name;
-    return false;
+    set_difficulty(config->simulations, config->temperature);
+    return true;
 }
 
 DifficultyConfig NeutronAgent::get_difficulty_config() const {
@@ -114,6 +107,27 @@ int NeutronAgent::get_move(const GameState& state) {
     return mcts_->search(state);
 }
 
+SearchTask<int> NeutronAgent::get_move_resumable(const GameState& state,
+                                                 const DifficultyConfig& difficulty,
+                                                 SearchSlice& slice,
+                                                 SearchProgress* progress,
+                                                 SearchTree* tree,
+                                                 SearchCrew* crew) {
+    if (!is_ready()) {
+        throw std::runtime_error("Agent not ready - load a model first");
+    }
+
+    if (state.is_terminal()) {
+        throw std::runtime_error("Cannot get move for terminal state");
+    }
+
+    MCTSConfig config = mcts_->config();
+    config.num_simulations = difficulty.simulations;
+    config.temperature = difficulty.temperature;
+    config.leaf_batch = difficulty.leaf_batch;
+    return mcts_->search_resumable(state, config, slice, progress, tree, crew);
+}
+
 std::pair<int, std::vector<std::pair<int, float>>>
 NeutronAgent::get_move_with_probs(const GameState& state) {
     if (!is_ready()) {
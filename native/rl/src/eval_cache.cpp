@@ -0,0 +1,81 @@
+#include "neutron_rl/eval_cache.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+namespace neutron_rl {
+
+Evaluation Evaluation::from_logits(const GameState& state, const std::vector<float>& policy_logits, float value) {
+    Evaluation evaluation;
+    evaluation.value = value;
+
+    const auto legal_actions = state.legal_actions();
+    if (legal_actions.empty()) {
+        return evaluation;
+    }
+
+    // Softmax over legal actions
+    float max_logit = -std::numeric_limits<float>::infinity();
+    for (int action : legal_actions) {
+        max_logit = std::max(max_logit, policy_logits[action]);
+    }
+
+    float sum_exp = 0.0f;
+    for (int action : legal_actions) {
+        float exp_logit = std::exp(policy_logits[action] - max_logit);
+        evaluation.actions[evaluation.num_actions] = static_cast<int16_t>(action);
+        evaluation.priors[evaluation.num_actions] = exp_logit;
+        ++evaluation.num_actions;
+        sum_exp += exp_logit;
+    }
+
+    for (int i = 0; i < evaluation.num_actions; ++i) {
+        evaluation.priors[i] /= sum_exp;
+    }
+    return evaluation;
+}
+
+EvalCache::EvalCache(size_t entries, Observer observer)
+    : slots_(std::bit_floor(std::max<size_t>(entries, 1))),
+      mask_(slots_.size() - 1),
+      observer_(std::move(observer)) {}
+
+bool EvalCache::find(uint64_t key, Evaluation& evaluation) const {
+    const size_t index = key & mask_;
+    bool hit;
+    {
+        std::lock_guard<std::mutex> lock(stripe(index));
+        const Slot& slot = slots_[index];
+        hit = slot.evaluation.num_actions > 0 && slot.key == key;
+        if (hit) {
+            evaluation = slot.evaluation;
+        }
+    }
+
+    if (observer_) {
+        observer_(hit);
+    }
+    return hit;
+}
+
+void EvalCache::store(uint64_t key, const Evaluation& evaluation) {
+    if (evaluation.num_actions == 0) {
+        return;
+    }
+
+    const size_t index = key & mask_;
+    std::lock_guard<std::mutex> lock(stripe(index));
+    slots_[index] = Slot{key, evaluation};
+}
+
+size_t EvalCache::capacity() const {
+    return slots_.size();
+}
+
+std::mutex& EvalCache::stripe(size_t index) const {
+    return stripes_[index % kStripes];
+}
+
+}  // namespace neutron_rl
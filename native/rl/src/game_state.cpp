@@ -1,35 +1,75 @@
 #include "neutron_rl/game_state.hpp"
 
+#include <algorithm>
+#include <bit>
 #include <sstream>
 #include <stdexcept>
 
 namespace neutron_rl {
 
+namespace {
+
+constexpr auto kBlack = static_cast<uint8_t>(PieceKind::BLACK);
+constexpr auto kWhite = static_cast<uint8_t>(PieceKind::WHITE);
+
+// Column-major indices of row 0
+constexpr uint32_t kRow = 0b00001'00001'00001'00001'00001;
+
+// Key of `kind` on column-major `index` in rules::hash()
+uint64_t zobrist(int index, uint8_t kind) {
+    return rules::kZobrist[index * rules::kKinds + kind % rules::kKinds];
+}
+
+}  // namespace
+
 GameState::GameState() : current_player_(1), phase_(Phase::MoveNeutron) {
     // Initial board setup:
     // Row 0: Player 2 pawns (top)
     // Row 2: Neutron (center)
     // Row 4: Player 1 pawns (bottom)
-    board_.fill(static_cast<int8_t>(Piece::Empty));
+    cells_.fill(rules::kCell);
 
-    // Player 2 pawns on top row
     for (int col = 0; col < kBoardSize; ++col) {
-        board_[col] = static_cast<int8_t>(Piece::Player2Pawn);
+        cells_[to_index(rowcol_to_cell(0, col))] = pawn_of(2);
+        cells_[to_index(rowcol_to_cell(kBoardSize - 1, col))] = pawn_of(1);
     }
 
-    // Neutron in center
-    board_[12] = static_cast<int8_t>(Piece::Neutron);
+    cells_[to_index(rowcol_to_cell(2, 2))] = rules::kNeutron;
+    update(true);
+}
 
-    // Player 1 pawns on bottom row
-    for (int col = 0; col < kBoardSize; ++col) {
-        board_[20 + col] = static_cast<int8_t>(Piece::Player1Pawn);
+GameState::GameState(const std::array<int8_t, kNumCells>& board,
+                     int current_player,
+                     Phase phase)
+    : current_player_(current_player), phase_(phase) {
+    for (int cell = 0; cell < kNumCells; ++cell) {
+        uint8_t kind = rules::kCell;
+        switch (static_cast<Piece>(board[cell])) {
+            case Piece::Player1Pawn: kind = pawn_of(1); break;
+            case Piece::Player2Pawn: kind = pawn_of(2); break;
+            case Piece::Neutron: kind = rules::kNeutron; break;
+            default: break;
+        }
+        cells_[to_index(cell)] = kind;
     }
+    update(true);
 }
 
-GameState::GameState(const std::array<int8_t, kNumCells>& board,
+GameState::GameState(const rules::Cells& cells,
                      int current_player,
                      Phase phase)
-    : board_(board), current_player_(current_player), phase_(phase) {}
+    : cells_(rules::plainCells(cells)), current_player_(current_player), phase_(phase) {
+    update(true);
+}
+
+int GameState::to_index(int cell) {
+    auto [row, col] = cell_to_rowcol(cell);
+    return col * kBoardSize + row;
+}
+
+uint8_t GameState::pawn_of(int player) {
+    return player == 1 ? kWhite : kBlack;
+}
 
 std::pair<int, int> GameState::cell_to_rowcol(int cell) {
     return {cell / kBoardSize, cell % kBoardSize};
@@ -52,105 +92,101 @@ int GameState::encode_action(int cell, int direction, int distance) {
 }
 
 Piece GameState::get_piece(int cell) const {
-    return static_cast<Piece>(board_[cell]);
-}
-
-int GameState::find_neutron() const {
-    for (int i = 0; i < kNumCells; ++i) {
-        if (board_[i] == static_cast<int8_t>(Piece::Neutron)) {
-            return i;
-        }
+    switch (cells_[to_index(cell)]) {
+        case kWhite: return Piece::Player1Pawn;
+        case kBlack: return Piece::Player2Pawn;
+        case rules::kNeutron: return Piece::Neutron;
+        default: return Piece::Empty;
     }
-    return -1;  // Should never happen in valid game
 }
 
-int GameState::max_slide_distance(int cell, int direction) const {
-    auto [row, col] = cell_to_rowcol(cell);
-    auto [dr, dc] = kDirectionDeltas[direction];
-
-    int distance = 0;
-    int new_row = row + dr;
-    int new_col = col + dc;
+void GameState::update(bool reset) {
+    if (reset) {
+        board_hash_ = rules::hash(cells_);
+        occupied_ = rules::occupancy(cells_);
+        neutron_ = static_cast<int8_t>(rules::find(cells_, rules::kNeutron));
 
-    while (new_row >= 0 && new_row < kBoardSize &&
-           new_col >= 0 && new_col < kBoardSize) {
-        int new_cell = rowcol_to_cell(new_row, new_col);
-        if (board_[new_cell] != static_cast<int8_t>(Piece::Empty)) {
-            break;
+        // Bounds the legal actions to kMaxActions
+        for (const uint8_t pawn : {kWhite, kBlack}) {
+            if (std::count(cells_.begin(), cells_.end(), pawn) > kBoardSize) {
+                throw std::invalid_argument("More than 5 pawns of a player");
+            }
         }
-        distance++;
-        new_row += dr;
-        new_col += dc;
     }
 
-    return distance;
-}
-
-std::vector<std::pair<int, int>> GameState::get_piece_moves(int cell) const {
-    std::vector<std::pair<int, int>> moves;
-
-    for (int dir = 0; dir < kNumDirections; ++dir) {
-        int max_dist = max_slide_distance(cell, dir);
-        for (int dist = 1; dist <= max_dist; ++dist) {
-            moves.emplace_back(dir, dist);
+    // Full slides only (standard Neutron rules): one action per open direction.
+    // Every direction is written and only the open ones kept, without branching.
+    num_legal_ = 0;
+    auto add_slides = [&](int index) {
+        const int cell = rowcol_to_cell(index % kBoardSize, index / kBoardSize);
+        for (int dir = 0; dir < kNumDirections; ++dir) {
+            const int length = rules::distance(occupied_, index, dir);
+            legal_[num_legal_] = static_cast<int16_t>(encode_action(cell, dir, std::max(length, 1)));
+            num_legal_ += length != 0;
         }
-    }
-
-    return moves;
-}
-
-std::vector<int> GameState::get_legal_actions() const {
-    std::vector<int> actions;
+    };
 
     if (phase_ == Phase::MoveNeutron) {
-        // Must move the neutron — full slide only (standard Neutron rules)
-        int neutron_cell = find_neutron();
-        for (int dir = 0; dir < kNumDirections; ++dir) {
-            int max_dist = max_slide_distance(neutron_cell, dir);
-            if (max_dist > 0) {
-                actions.push_back(encode_action(neutron_cell, dir, max_dist));
-            }
+        if (neutron_ != rules::kNone) {
+            add_slides(neutron_);
         }
     } else {
-        // Must move one of current player's pawns — full slide only
-        Piece my_pawn = (current_player_ == 1) ? Piece::Player1Pawn : Piece::Player2Pawn;
-
-        for (int cell = 0; cell < kNumCells; ++cell) {
-            if (board_[cell] == static_cast<int8_t>(my_pawn)) {
-                for (int dir = 0; dir < kNumDirections; ++dir) {
-                    int max_dist = max_slide_distance(cell, dir);
-                    if (max_dist > 0) {
-                        actions.push_back(encode_action(cell, dir, max_dist));
-                    }
-                }
+        const uint8_t my_pawn = pawn_of(current_player_);
+        uint32_t mine = 0;
+        for (int index = 0; index < kNumCells; ++index) {
+            mine |= uint32_t{cells_[index] == my_pawn} << index;
+        }
+        // Row by row, the order of the action space
+        for (int row = 0; row < kBoardSize; ++row) {
+            for (uint32_t rest = mine & (kRow << row); rest != 0; rest &= rest - 1) {
+                add_slides(std::countr_zero(rest));
             }
         }
     }
 
-    return actions;
+    winner_ = 0;
+    if (neutron_ == rules::kNone) {
+        terminal_ = true;  // Invalid state
+        return;
+    }
+
+    // Neutron on either home row (row 0 for player 2, row 4 for player 1),
+    // or the current player cannot move and loses
+    const int row = neutron_ % kBoardSize;
+    terminal_ = row == 0 || row == kBoardSize - 1 || num_legal_ == 0;
+    if (row == 0) {
+        winner_ = 2;
+    } else if (row == kBoardSize - 1) {
+        winner_ = 1;
+    } else if (num_legal_ == 0) {
+        winner_ = static_cast<int8_t>(current_player_ == 1 ? 2 : 1);
+    }
+}
+
+std::vector<int> GameState::get_legal_actions() const {
+    return {legal_.begin(), legal_.begin() + num_legal_};
 }
 
 GameState GameState::apply_action(int action) const {
+    if (action < 0 || action >= kActionSize) {
+        throw std::invalid_argument("Action out of range");
+    }
+
     auto [cell, direction, distance] = decode_action(action);
 
     // Validate the move
-    auto [row, col] = cell_to_rowcol(cell);
-    auto [dr, dc] = kDirectionDeltas[direction];
-
-    int new_row = row + dr * distance;
-    int new_col = col + dc * distance;
-
-    if (new_row < 0 || new_row >= kBoardSize ||
-        new_col < 0 || new_col >= kBoardSize) {
+    const int from = to_index(cell);
+    const auto& ray = rules::kRays[from][direction];
+    if (distance > ray.length) {
         throw std::invalid_argument("Action moves piece off board");
     }
 
-    int new_cell = rowcol_to_cell(new_row, new_col);
+    const int to = ray.cells[distance - 1];
 
     // Create new state
     GameState new_state = *this;
-    new_state.board_[new_cell] = new_state.board_[cell];
-    new_state.board_[cell] = static_cast<int8_t>(Piece::Empty);
+    new_state.cells_[to] = new_state.cells_[from];
+    new_state.cells_[from] = rules::kCell;
 
     // Update phase and player
     if (phase_ == Phase::MoveNeutron) {
@@ -160,50 +196,33 @@ GameState GameState::apply_action(int action) const {
         new_state.current_player_ = (current_player_ == 1) ? 2 : 1;
     }
 
+    // Occupancy and neutron follow the move, unless it is not a slide onto an empty cell
+    // (never a legal action, but not rejected either)
+    const bool slide = cells_[from] != rules::kCell && cells_[to] == rules::kCell;
+    if (slide) {
+        const uint8_t piece = cells_[from];
+        new_state.board_hash_ ^= zobrist(from, piece) ^ zobrist(from, rules::kCell) ^ zobrist(to, rules::kCell) ^
+                                 zobrist(to, piece);
+        new_state.occupied_ ^= (uint32_t{1} << from) | (uint32_t{1} << to);
+        if (from == neutron_) {
+            new_state.neutron_ = static_cast<int8_t>(to);
+        }
+    }
+    new_state.update(!slide);
     return new_state;
 }
 
-bool GameState::is_terminal() const {
-    int neutron_cell = find_neutron();
-    if (neutron_cell < 0) return true;  // Invalid state
-
-    int row = neutron_cell / kBoardSize;
-
-    // Neutron on player 1's home row (row 4)
-    if (row == kBoardSize - 1) return true;
-
-    // Neutron on player 2's home row (row 0)
-    if (row == 0) return true;
-
-    // Check if current player can move
-    auto legal = get_legal_actions();
-    return legal.empty();
-}
-
 std::optional<int> GameState::get_winner() const {
-    if (!is_terminal()) {
+    if (!terminal_ || winner_ == 0) {
         return std::nullopt;
     }
+    return winner_;
+}
 
-    int neutron_cell = find_neutron();
-    if (neutron_cell < 0) {
-        return std::nullopt;  // Invalid state
-    }
-
-    int row = neutron_cell / kBoardSize;
-
-    // Neutron on player 2's home row (row 0) - player 2 wins
-    if (row == 0) {
-        return 2;
-    }
-
-    // Neutron on player 1's home row (row 4) - player 1 wins
-    if (row == kBoardSize - 1) {
-        return 1;
-    }
-
-    // Current player couldn't move - they lose
-    return (current_player_ == 1) ? 2 : 1;
+uint64_t GameState::hash() const {
+    // Keys past the board's, one per (player, phase)
+    const auto side = static_cast<uint64_t>(current_player_ * 2 + static_cast<int>(phase_));
+    return board_hash_ ^ rules::splitmix64(rules::kZobrist.size() + side);
 }
 
 std::vector<float> GameState::encode() const {
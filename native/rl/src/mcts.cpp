@@ -4,152 +4,681 @@
 #include <cmath>
 #include <limits>
 #include <random>
+#include <stdexcept>
+#include <thread>
+#include <utility>
 
 namespace neutron_rl {
 
-// MCTSNode implementation
+namespace {
 
-MCTSNode::MCTSNode(const GameState& state, float prior,
-                   MCTSNode* parent, int action)
-    : state_(state), prior_(prior), parent_(parent), action_(action) {}
+// Leaves held by other threads a shared batch steps around before it gives up
+constexpr int kMaxCollisions = 8;
 
-float MCTSNode::q_value() const {
-    if (visit_count_ == 0) {
+// Wait for other threads: ends the slice, or yields the thread when the slice is unlimited
+SearchSlice::Checkpoint idle(SearchSlice& slice) {
+    if (!slice.budget) {
+        std::this_thread::yield();
+    }
+    return slice.pause();
+}
+
+}  // namespace
+
+// SearchTree implementation
+
+SearchTree::Index SearchTree::add_edge(int action, float prior) {
+    actions_.push_back(static_cast<int16_t>(action));
+    priors_.push_back(prior);
+    visits_.push_back(0);
+    value_sums_.push_back(0.0f);
+    virtual_losses_.push_back(0);
+    children_.push_back(kNone);
+    return static_cast<Index>(actions_.size() - 1);
+}
+
+SearchTree::Index SearchTree::add_node(const GameState& state, Index parent, Index edge) {
+    if (shared_) {
+        const Index index = std::atomic_ref(used_nodes_).fetch_add(1, std::memory_order_relaxed);
+        if (index >= nodes_.size()) {
+            throw std::length_error("SearchTree: shared arena is full");
+        }
+        nodes_[index] = Node{parent, edge, 0, 0, state.phase(), state.is_terminal(), false};
+        states_[index] = state;
+        return index;
+    }
+    nodes_.push_back(Node{parent, edge, 0, 0, state.phase(), state.is_terminal(), false});
+    states_.push_back(state);
+    return static_cast<Index>(nodes_.size() - 1);
+}
+
+SearchTree::Index SearchTree::add_edges(Index count) {
+    if (shared_) {
+        const Index first = std::atomic_ref(used_edges_).fetch_add(count, std::memory_order_relaxed);
+        if (first + count > actions_.size()) {
+            throw std::length_error("SearchTree: shared arena is full");
+        }
+        return first;
+    }
+    const auto first = static_cast<Index>(actions_.size());
+    const size_t size = first + count;
+    actions_.resize(size);
+    priors_.resize(size);
+    visits_.resize(size);
+    value_sums_.resize(size);
+    virtual_losses_.resize(size);
+    children_.resize(size, kNone);
+    return first;
+}
+
+void SearchTree::reset(const GameState& state) {
+    clear();
+    root_ = add_node(state, kNone, add_edge(-1, 1.0f));
+}
+
+void SearchTree::clear() {
+    root_ = kNone;
+    nodes_.clear();
+    states_.clear();
+    actions_.clear();
+    priors_.clear();
+    visits_.clear();
+    value_sums_.clear();
+    virtual_losses_.clear();
+    children_.clear();
+}
+
+void SearchTree::reserve(int simulations) {
+    // At most one new node per simulation
+    const size_t nodes = nodes_.size() + static_cast<size_t>(std::max(simulations, 0)) + 1;
+    nodes_.reserve(nodes);
+    states_.reserve(nodes);
+}
+
+void SearchTree::share(int simulations) {
+    // At most one new node per simulation, and one expansion
+    const size_t more = static_cast<size_t>(std::max(simulations, 0)) + 1;
+    used_nodes_ = static_cast<Index>(nodes_.size());
+    used_edges_ = static_cast<Index>(actions_.size());
+
+    nodes_.resize(used_nodes_ + more);
+    states_.resize(used_nodes_ + more);
+    const size_t edges = used_edges_ + more * kMaxEdges;
+    actions_.resize(edges);
+    priors_.resize(edges);
+    visits_.resize(edges);
+    value_sums_.resize(edges);
+    virtual_losses_.resize(edges);
+    children_.resize(edges, kNone);
+    shared_ = true;
+}
+
+void SearchTree::unshare() {
+    if (!shared_) {
+        return;
+    }
+    shared_ = false;
+
+    nodes_.resize(std::min<size_t>(used_nodes_, nodes_.size()));
+    states_.resize(nodes_.size());
+    const size_t edges = std::min<size_t>(used_edges_, actions_.size());
+    actions_.resize(edges);
+    priors_.resize(edges);
+    visits_.resize(edges);
+    value_sums_.resize(edges);
+    virtual_losses_.resize(edges);
+    children_.resize(edges);
+}
+
+size_t SearchTree::memory_bytes() const {
+    return nodes_.capacity() * sizeof(Node) + states_.capacity() * sizeof(GameState) +
+           actions_.capacity() * sizeof(int16_t) + priors_.capacity() * sizeof(float) +
+           visits_.capacity() * sizeof(int32_t) + value_sums_.capacity() * sizeof(float) +
+           virtual_losses_.capacity() * sizeof(int32_t) + children_.capacity() * sizeof(Index);
+}
+
+float SearchTree::q_value(Index node) const {
+    const Index edge = nodes_[node].edge;
+    const int32_t visits = load(visits_[edge]);
+    if (visits == 0) {
         return 0.0f;
     }
-    return value_sum_ / static_cast<float>(visit_count_);
+    return load(value_sums_[edge]) / static_cast<float>(visits);
 }
 
-MCTSNode* MCTSNode::select_child(float c_puct) {
-    float best_score = -std::numeric_limits<float>::infinity();
-    MCTSNode* best_child = nullptr;
+bool SearchTree::try_claim(Index node) {
+    Node& n = nodes_[node];
+    if (std::atomic_ref(n.claimed).exchange(true, std::memory_order_acquire)) {
+        return false;
+    }
+    // Expanded by the thread that held it until now
+    if (load(n.num_edges, std::memory_order_acquire) != 0) {
+        release(node);
+        return false;
+    }
+    return true;
+}
+
+void SearchTree::release(Index node) {
+    std::atomic_ref(nodes_[node].claimed).store(false, std::memory_order_release);
+}
+
+void SearchTree::expand(Index node, const Evaluation& evaluation) {
+    if (evaluation.num_actions == 0) {
+        return;
+    }
+
+    // Child states wait until selection reaches them
+    const auto count = static_cast<Index>(evaluation.num_actions);
+    const Index first = add_edges(count);
+    std::copy_n(evaluation.actions.begin(), count, actions_.begin() + first);
+    std::copy_n(evaluation.priors.begin(), count, priors_.begin() + first);
+
+    // Published last: other threads only read the edges once they see num_edges
+    nodes_[node].first_edge = first;
+    std::atomic_ref(nodes_[node].num_edges).store(static_cast<uint16_t>(count), std::memory_order_release);
+}
+
+SearchTree::Index SearchTree::select_child(Index node, float c_puct, float virtual_loss) {
+    const Node& parent = nodes_[node];
+    const Index first = parent.first_edge;
+    const Index last = first + load(parent.num_edges);
 
-    float sqrt_parent_visits = std::sqrt(static_cast<float>(visit_count_));
+    float sqrt_parent_visits =
+        std::sqrt(static_cast<float>(load(visits_[parent.edge]) + load(virtual_losses_[parent.edge])));
 
-    for (auto& child : children_) {
+    // Only negate Q when the child has a different player (opponent).
+    // In Neutron, neutron-phase -> pawn-phase keeps the same player:
+    // the player only changes after a pawn move.
+    const bool opponent = parent.phase == Phase::MovePawn;
+
+    float best_score = -std::numeric_limits<float>::infinity();
+    Index best = kNone;
+    for (Index e = first; e < last; ++e) {
         // PUCT formula: Q(s,a) + c_puct * P(s,a) * sqrt(N(s)) / (1 + N(s,a))
-        // Only negate Q when child has a different player (opponent).
-        // In Neutron, neutron-phase -> pawn-phase keeps the same player.
+        const int32_t visits = load(visits_[e]);
+        const int32_t losses = load(virtual_losses_[e]);
+        const float sum = load(value_sums_[e]);
         float q;
-        if (child->state().current_player() != state_.current_player()) {
-            q = -child->q_value();  // Opponent's node
+        if (losses == 0) {
+            const float child_q = visits == 0 ? 0.0f : sum / static_cast<float>(visits);
+            q = opponent ? -child_q : child_q;
         } else {
-            q = child->q_value();   // Same player's node
+            // Pending visits count as losses for the player choosing here.
+            const float pending = static_cast<float>(losses);
+            const float value_sum = opponent ? -sum : sum;
+            q = (value_sum - virtual_loss * pending) / (static_cast<float>(visits) + pending);
         }
-        float u = c_puct * child->prior_ * sqrt_parent_visits /
-                  (1.0f + static_cast<float>(child->visit_count_));
+        float u = c_puct * priors_[e] * sqrt_parent_visits / (1.0f + static_cast<float>(visits + losses));
         float score = q + u;
 
         if (score > best_score) {
             best_score = score;
-            best_child = child.get();
+            best = e;
+        }
+    }
+
+    // First visit through this edge: materialize the child
+    if (!shared_) {
+        if (children_[best] == kNone) {
+            const GameState state = states_[node].apply_action(actions_[best]);
+            children_[best] = add_node(state, node, best);
         }
+        return children_[best];
     }
 
-    return best_child;
+    // Shared: the thread that swaps in kBusy creates it, the others wait for it
+    std::atomic_ref child(children_[best]);
+    Index index = child.load(std::memory_order_acquire);
+    if (index == kNone && child.compare_exchange_strong(index, kBusy, std::memory_order_acquire)) {
+        index = add_node(states_[node].apply_action(actions_[best]), node, best);
+        child.store(index, std::memory_order_release);
+        return index;
+    }
+    while (index == kBusy) {
+        std::this_thread::yield();
+        index = child.load(std::memory_order_acquire);
+    }
+    return index;
 }
 
-void MCTSNode::expand(const std::vector<float>& policy_logits) {
-    auto legal_actions = state_.get_legal_actions();
-    if (legal_actions.empty()) {
-        return;
+void SearchTree::backpropagate(Index node, float value) {
+    float current_value = value;
+
+    for (Index n = node; n != kNone; n = nodes_[n].parent) {
+        const Index edge = nodes_[n].edge;
+        add(visits_[edge], 1);
+        add(value_sums_[edge], current_value);
+        // Only flip sign when the parent has a different current_player,
+        // i.e. when the parent moved a pawn; neutron-phase -> pawn-phase
+        // keeps the same player.
+        const Index parent = nodes_[n].parent;
+        if (parent != kNone && nodes_[parent].phase == Phase::MovePawn) {
+            current_value = -current_value;
+        }
     }
+}
 
-    // Compute softmax over legal actions
-    float max_logit = -std::numeric_limits<float>::infinity();
-    for (int action : legal_actions) {
-        max_logit = std::max(max_logit, policy_logits[action]);
+void SearchTree::add_virtual_loss(Index node) {
+    for (Index n = node; n != kNone; n = nodes_[n].parent) {
+        add(virtual_losses_[nodes_[n].edge], 1);
     }
+}
 
-    float sum_exp = 0.0f;
-    std::vector<float> probs;
-    probs.reserve(legal_actions.size());
-    for (int action : legal_actions) {
-        float exp_logit = std::exp(policy_logits[action] - max_logit);
-        probs.push_back(exp_logit);
-        sum_exp += exp_logit;
+void SearchTree::revert_virtual_loss(Index node) {
+    for (Index n = node; n != kNone; n = nodes_[n].parent) {
+        add(virtual_losses_[nodes_[n].edge], -1);
+    }
+}
+
+std::unordered_map<int, int> SearchTree::visit_counts(Index node) const {
+    std::unordered_map<int, int> counts;
+    for_each_child(node, [&](int action, int visits) { counts[action] = visits; });
+    return counts;
+}
+
+int SearchTree::reuse(const GameState& state, int max_depth) {
+    reused_visits_ = 0;
+
+    Index found = kNone;
+    if (root_ != kNone) {
+        // Level by level: a position appears at most once within a turn
+        std::vector<Index> level{root_};
+        for (int depth = 0; depth <= max_depth && !level.empty() && found == kNone; ++depth) {
+            std::vector<Index> next;
+            for (Index node : level) {
+                if (states_[node] == state) {
+                    found = node;
+                    break;
+                }
+                const Node& n = nodes_[node];
+                for (Index e = n.first_edge; e < n.first_edge + n.num_edges; ++e) {
+                    if (children_[e] != kNone) {
+                        next.push_back(children_[e]);
+                    }
+                }
+            }
+            level = std::move(next);
+        }
     }
 
-    // Normalize and create children
-    children_.reserve(legal_actions.size());
-    for (size_t i = 0; i < legal_actions.size(); ++i) {
-        float prior = probs[i] / sum_exp;
-        GameState child_state = state_.apply_action(legal_actions[i]);
-        children_.push_back(std::make_unique<MCTSNode>(
-            child_state, prior, this, legal_actions[i]));
+    // Unexpanded or terminal: nothing worth keeping
+    if (found == kNone || nodes_[found].num_edges == 0) {
+        reset(state);
+        return 0;
     }
+
+    if (found != root_) {
+        compact(found);
+    }
+    reused_visits_ = visit_count(root_);
+    return reused_visits_;
 }
 
-void MCTSNode::backpropagate(float value) {
-    MCTSNode* node = this;
-    float current_value = value;
+void SearchTree::keep(int action) {
+    if (root_ != kNone) {
+        const Node& root = nodes_[root_];
+        for (Index e = root.first_edge; e < root.first_edge + root.num_edges; ++e) {
+            if (actions_[e] == action && children_[e] != kNone) {
+                compact(children_[e]);
+                return;
+            }
+        }
+    }
+    clear();
+}
 
-    while (node != nullptr) {
-        node->visit_count_++;
-        node->value_sum_ += current_value;
-        // Only flip sign when parent has a different current_player.
-        // In Neutron, neutron-phase -> pawn-phase keeps the same player,
-        // so we must NOT flip between those consecutive tree levels.
-        if (node->parent_ != nullptr &&
-            node->state().current_player() != node->parent_->state().current_player()) {
-            current_value = -current_value;
+void SearchTree::compact(Index node) {
+    SearchTree kept;
+    const auto copy_edge = [&](Index e) {
+        const Index copy = kept.add_edge(actions_[e], priors_[e]);
+        kept.visits_[copy] = visits_[e];
+        kept.value_sums_[copy] = value_sums_[e];
+        kept.virtual_losses_[copy] = virtual_losses_[e];
+        return copy;
+    };
+
+    kept.nodes_.push_back(nodes_[node]);
+    kept.states_.push_back(states_[node]);
+    kept.nodes_[0].parent = kNone;
+    kept.nodes_[0].edge = copy_edge(nodes_[node].edge);
+    kept.root_ = 0;
+
+    // (old index, new index) of nodes whose edges are still to copy
+    std::vector<std::pair<Index, Index>> pending{{node, kept.root_}};
+    while (!pending.empty()) {
+        const auto [from, to] = pending.back();
+        pending.pop_back();
+
+        const Node& n = nodes_[from];
+        kept.nodes_[to].first_edge = static_cast<Index>(kept.actions_.size());
+        for (Index e = n.first_edge; e < n.first_edge + n.num_edges; ++e) {
+            copy_edge(e);
+        }
+        for (Index i = 0; i < n.num_edges; ++i) {
+            const Index child = children_[n.first_edge + i];
+            if (child == kNone) {
+                continue;
+            }
+            const Index copy = kept.nodes_[to].first_edge + i;
+            Node moved = nodes_[child];
+            moved.parent = to;
+            moved.edge = copy;
+            kept.nodes_.push_back(moved);
+            kept.states_.push_back(states_[child]);
+            kept.children_[copy] = static_cast<Index>(kept.nodes_.size() - 1);
+            pending.emplace_back(child, kept.children_[copy]);
         }
-        node = node->parent_;
     }
+
+    const int reused = reused_visits_;
+    *this = std::move(kept);
+    reused_visits_ = reused;
 }
 
-std::unordered_map<int, int> MCTSNode::get_visit_counts() const {
-    std::unordered_map<int, int> counts;
-    for (const auto& child : children_) {
-        counts[child->action()] = child->visit_count();
+// SearchCrew implementation
+
+struct SearchCrew::Search {
+    MCTS& mcts;
+    SearchTree& tree;
+    const MCTSConfig& config;
+    int total;                     // Simulations to run, reused visits aside
+    std::atomic<int> claimed{0};   // Taken by some thread, finished or not
+    std::atomic<int> finished{0};
+
+    /**
+     * @brief Take up to leaf_batch simulations of the budget and run them.
+     *
+     * @return Simulations run: 0 when the budget is all taken, or when every
+     * leaf this thread reached was held by another one.
+     */
+    int run() {
+        const int want = std::max(config.leaf_batch, 1);
+        int taken = claimed.load(std::memory_order_relaxed);
+        int count;
+        do {
+            count = std::min(want, total - taken);
+            if (count <= 0) {
+                return 0;
+            }
+        } while (!claimed.compare_exchange_weak(taken, taken + count, std::memory_order_relaxed));
+
+        int done = 0;
+        try {
+            done = mcts.simulate_shared(tree, config, count);
+        } catch (...) {
+            claimed.fetch_sub(count, std::memory_order_relaxed);
+            throw;
+        }
+
+        // Untried simulations go back to the budget
+        if (done < count) {
+            claimed.fetch_sub(count - done, std::memory_order_relaxed);
+        }
+        finished.fetch_add(done, std::memory_order_release);
+        return done;
+    }
+};
+
+SearchCrew::Opening::Opening(SearchCrew& crew, Search& search) : crew_(crew), search_(search) {
+    crew_.open_.store(&search_);
+}
+
+SearchCrew::Opening::~Opening() {
+    // Helpers enter only after raising inside_, so once it drops to 0 none can see search_
+    crew_.open_.store(nullptr);
+    while (crew_.inside_.load() != 0) {
+        std::this_thread::yield();
+    }
+    search_.tree.unshare();
+}
+
+SearchTask<void> SearchCrew::help(SearchSlice& slice) {
+    while (!closed_.load(std::memory_order_acquire)) {
+        int done = 0;
+        inside_.fetch_add(1);
+        try {
+            if (Search* search = open_.load()) {
+                done = search->run();
+            }
+        } catch (...) {
+            inside_.fetch_sub(1);
+            throw;
+        }
+        inside_.fetch_sub(1);
+
+        // Between searches, or every leaf in reach is being evaluated
+        if (done == 0) {
+            co_await idle(slice);
+            continue;
+        }
+        for (int i = 0; i < done; ++i) {
+            co_await slice.checkpoint();
+        }
     }
-    return counts;
 }
 
 // MCTS implementation
 
-MCTS::MCTS(ModelLoader& model, const MCTSConfig& config)
+MCTS::MCTS(const ModelLoader& model, const MCTSConfig& config)
     : model_(model), config_(config) {}
 
-void MCTS::simulate(MCTSNode* root) {
-    MCTSNode* node = root;
+void MCTS::simulate(SearchTree& tree, float c_puct) {
+    SearchTree::Index node = tree.root();
 
     // Selection: traverse tree using PUCT until leaf
-    while (!node->is_leaf() && !node->is_terminal()) {
-        node = node->select_child(config_.c_puct);
+    while (!tree.is_leaf(node) && !tree.is_terminal(node)) {
+        node = tree.select_child(node, c_puct);
     }
 
     // Handle terminal nodes
-    if (node->is_terminal()) {
-        auto winner = node->state().get_winner();
-        float value = 0.0f;
-        if (winner.has_value()) {
-            // Value from perspective of the player to move at this node
-            int node_player = node->state().current_player();
-            value = (winner.value() == node_player) ? 1.0f : -1.0f;
-        }
-        node->backpropagate(value);
+    if (tree.is_terminal(node)) {
+        tree.backpropagate(node, terminal_value(tree.state(node)));
         return;
     }
 
     // Expansion and evaluation
-    auto tensor = node->state().encode();
-    auto result = model_.infer(tensor);
+    const GameState& state = tree.state(node);
+    Evaluation evaluation;
+    if (!cached(state, evaluation)) {
+        auto result = model_.infer(state.encode());
+        evaluation = evaluated(state, result);
+    }
+
+    tree.expand(node, evaluation);
+
+    // Backpropagate value from current node player's perspective
+    tree.backpropagate(node, evaluation.value);
+}
+
+int MCTS::simulate_batch(SearchTree& tree, const MCTSConfig& config, int limit) {
+    if (config.leaf_batch <= 1) {
+        simulate(tree, config.c_puct);
+        return 1;
+    }
+
+    const int max_leaves = std::min(config.leaf_batch, limit);
+    std::vector<SearchTree::Index> leaves;
+    std::vector<std::vector<float>> tensors;
+    leaves.reserve(max_leaves);
+    tensors.reserve(max_leaves);
+    Evaluation evaluation;
+
+    int simulations = 0;
+    while (simulations < max_leaves) {
+        // Selection under the virtual losses of the leaves already queued
+        SearchTree::Index node = tree.root();
+        while (!tree.is_leaf(node) && !tree.is_terminal(node)) {
+            node = tree.select_child(node, config.c_puct, config.virtual_loss);
+        }
+
+        // Terminal nodes need no network: backpropagate right away
+        if (tree.is_terminal(node)) {
+            tree.backpropagate(node, terminal_value(tree.state(node)));
+            ++simulations;
+            continue;
+        }
+
+        // The search keeps coming back to a queued leaf: evaluate what we have
+        if (std::find(leaves.begin(), leaves.end(), node) != leaves.end()) {
+            break;
+        }
+
+        // Nor do positions the model has evaluated before
+        if (cached(tree.state(node), evaluation)) {
+            tree.expand(node, evaluation);
+            tree.backpropagate(node, evaluation.value);
+            ++simulations;
+            continue;
+        }
+
+        tree.add_virtual_loss(node);
+        leaves.push_back(node);
+        tensors.push_back(tree.state(node).encode());
+        ++simulations;
+    }
+
+    if (leaves.empty()) {
+        return simulations;
+    }
+
+    auto results = model_.infer_batch(tensors);
+    for (auto leaf : leaves) {
+        tree.revert_virtual_loss(leaf);
+    }
+
+    for (size_t i = 0; i < leaves.size(); ++i) {
+        evaluation = evaluated(tree.state(leaves[i]), results[i]);
+        tree.expand(leaves[i], evaluation);
+        tree.backpropagate(leaves[i], evaluation.value);
+    }
+
+    return simulations;
+}
+
+int MCTS::simulate_shared(SearchTree& tree, const MCTSConfig& config, int limit) {
+    const int max_leaves = std::min(std::max(config.leaf_batch, 1), limit);
+    std::vector<SearchTree::Index> leaves;
+    std::vector<SearchTree::Index> collisions;
+    std::vector<std::vector<float>> tensors;
+    leaves.reserve(max_leaves);
+    tensors.reserve(max_leaves);
+    Evaluation evaluation;
+
+    // Undo the virtual loss charged on leaves other threads hold
+    const auto step_back = [&] {
+        for (auto node : collisions) {
+            tree.revert_virtual_loss(node);
+        }
+    };
+
+    int simulations = 0;
+    while (simulations < max_leaves) {
+        // Selection under the virtual losses of every thread's pending leaves
+        SearchTree::Index node = tree.root();
+        while (!tree.is_leaf(node) && !tree.is_terminal(node)) {
+            node = tree.select_child(node, config.c_puct, config.virtual_loss);
+        }
+
+        if (tree.is_terminal(node)) {
+            tree.backpropagate(node, terminal_value(tree.state(node)));
+            ++simulations;
+            continue;
+        }
+
+        // Held by another thread, or already in this batch: one more pending
+        // visit there sends the next descent elsewhere
+        if (!tree.try_claim(node)) {
+            if (static_cast<int>(collisions.size()) == kMaxCollisions) {
+                break;
+            }
+            tree.add_virtual_loss(node);
+            collisions.push_back(node);
+            continue;
+        }
+
+        if (cached(tree.state(node), evaluation)) {
+            tree.expand(node, evaluation);
+            tree.backpropagate(node, evaluation.value);
+            tree.release(node);
+            ++simulations;
+            continue;
+        }
+
+        tree.add_virtual_loss(node);
+        leaves.push_back(node);
+        tensors.push_back(tree.state(node).encode());
+        ++simulations;
+    }
+
+    if (leaves.empty()) {
+        step_back();
+        return simulations;
+    }
+
+    std::vector<InferenceResult> results;
+    try {
+        if (leaves.size() == 1) {
+            results.push_back(model_.infer(tensors[0]));
+        } else {
+            results = model_.infer_batch(tensors);
+        }
+    } catch (...) {
+        // Leave the tree as if these leaves were never selected
+        for (auto leaf : leaves) {
+            tree.revert_virtual_loss(leaf);
+            tree.release(leaf);
+        }
+        step_back();
+        throw;
+    }
+    step_back();
+
+    for (size_t i = 0; i < leaves.size(); ++i) {
+        evaluation = evaluated(tree.state(leaves[i]), results[i]);
+        tree.expand(leaves[i], evaluation);
+        tree.revert_virtual_loss(leaves[i]);
+        tree.backpropagate(leaves[i], evaluation.value);
+        tree.release(leaves[i]);
+    }
+
+    return simulations;
+}
 
+bool MCTS::cached(const GameState& state, Evaluation& evaluation) const {
+    const auto* cache = model_.eval_cache();
+    return cache && cache->find(state.hash(), evaluation);
+}
+
+Evaluation MCTS::evaluated(const GameState& state, InferenceResult& result) const {
     // For P2, flip policy from player-relative to absolute action space
     auto& policy = result.policy_logits;
-    if (node->state().current_player() == 2) {
+    if (state.current_player() == 2) {
         policy = GameState::flip_policy(policy);
     }
 
-    node->expand(policy);
+    auto evaluation = Evaluation::from_logits(state, policy, result.value);
+    if (auto* cache = model_.eval_cache()) {
+        cache->store(state.hash(), evaluation);
+    }
+    return evaluation;
+}
 
-    // Backpropagate value from current node player's perspective
-    node->backpropagate(result.value);
+float MCTS::terminal_value(const GameState& state) {
+    auto winner = state.get_winner();
+    if (!winner.has_value()) {
+        return 0.0f;
+    }
+    // Value from perspective of the player to move at this node
+    return (winner.value() == state.current_player()) ? 1.0f : -1.0f;
 }
 
 int MCTS::select_action(const std::unordered_map<int, int>& visit_counts) {
-    if (config_.temperature == 0.0f) {
+    return select_action(visit_counts, config_.temperature);
+}
+
+int MCTS::select_action(const std::unordered_map<int, int>& visit_counts, float temperature) {
+    if (temperature == 0.0f) {
         // Greedy: select most visited
         int best_action = -1;
         int best_visits = -1;
@@ -169,7 +698,7 @@ int MCTS::select_action(const std::unordered_map<int, int>& visit_counts) {
 
     for (const auto& [action, visits] : visit_counts) {
         actions.push_back(action);
-        float prob = std::pow(static_cast<float>(visits), 1.0f / config_.temperature);
+        float prob = std::pow(static_cast<float>(visits), 1.0f / temperature);
         probs.push_back(prob);
         sum += prob;
     }
@@ -180,8 +709,8 @@ int MCTS::select_action(const std::unordered_map<int, int>& visit_counts) {
     }
 
     // Sample
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
+    // Per thread: searches from different requests run concurrently.
+    thread_local std::mt19937 gen(std::random_device{}());
     std::discrete_distribution<> dist(probs.begin(), probs.end());
     return actions[dist(gen)];
 }
@@ -204,70 +733,132 @@ std::vector<std::pair<int, float>> MCTS::visit_counts_to_probs(
     return probs;
 }
 
-void MCTS::add_dirichlet_noise(MCTSNode* root) {
+void MCTS::add_dirichlet_noise(SearchTree& tree) {
     if (config_.dirichlet_epsilon <= 0.0f) {
         return;
     }
 
     // This would add Dirichlet noise to root priors for exploration
     // Implementation omitted for simplicity - mainly needed during training
+    (void)tree;
 }
 
-int MCTS::search(const GameState& state) {
-    // Create root node
-    MCTSNode root(state, 1.0f);
+void MCTS::expand_root(SearchTree& tree) {
+    const GameState& state = tree.state(tree.root());
 
     // Initial expansion
-    auto tensor = state.encode();
-    auto result = model_.infer(tensor);
-
-    // For P2, flip policy from player-relative to absolute action space
-    auto& policy = result.policy_logits;
-    if (state.current_player() == 2) {
-        policy = GameState::flip_policy(policy);
+    Evaluation evaluation;
+    if (!cached(state, evaluation)) {
+        auto result = model_.infer(state.encode());
+        evaluation = evaluated(state, result);
     }
 
-    root.expand(policy);
+    tree.expand(tree.root(), evaluation);
 
     // Add noise if configured
-    add_dirichlet_noise(&root);
-
-    // Run simulations
-    for (int i = 0; i < config_.num_simulations; ++i) {
-        simulate(&root);
-    }
+    add_dirichlet_noise(tree);
+}
 
-    // Select action
-    auto visit_counts = root.get_visit_counts();
-    return select_action(visit_counts);
+int MCTS::search(const GameState& state) {
+    SearchSlice unlimited;
+    return search_resumable(state, config_, unlimited).run(unlimited);
 }
 
-std::vector<std::pair<int, float>> MCTS::search_with_probs(const GameState& state) {
-    // Create root node
-    MCTSNode root(state, 1.0f);
+SearchTask<int> MCTS::search_resumable(GameState state, MCTSConfig config, SearchSlice& slice,
+                                       SearchProgress* progress, SearchTree* kept, SearchCrew* crew) {
+    // Without a tree to keep, the search uses its own arena and frees it at the end
+    SearchTree own;
+    SearchTree& tree = kept ? *kept : own;
 
-    // Initial expansion
-    auto tensor = state.encode();
-    auto result = model_.infer(tensor);
+    // Visits carried over from the previous search count towards the budget
+    const int reused = tree.reuse(state, kReuseDepth);
+    if (reused == 0) {
+        expand_root(tree);
+    }
+    if (progress && reused > 0) {
+        update_progress(tree, 0, *progress);
+    }
 
-    // For P2, flip policy from player-relative to absolute action space
-    auto& policy = result.policy_logits;
-    if (state.current_player() == 2) {
-        policy = GameState::flip_policy(policy);
+    if (crew) {
+        // The crew's helpers take simulations from the same budget
+        tree.share(config.num_simulations - reused);
+        SearchCrew::Search search{*this, tree, config, std::max(config.num_simulations - reused, 0)};
+        const SearchCrew::Opening opening(*crew, search);
+
+        while (search.finished.load(std::memory_order_acquire) < search.total) {
+            const int done = search.run();
+            if (done == 0) {
+                // The rest is running on other threads
+                co_await idle(slice);
+                continue;
+            }
+            if (progress) {
+                update_progress(tree, search.finished.load(std::memory_order_relaxed), *progress);
+            }
+            for (int j = 0; j < done; ++j) {
+                co_await slice.checkpoint();
+            }
+        }
+        if (progress) {
+            update_progress(tree, search.total, *progress);
+        }
+    } else {
+        tree.reserve(config.num_simulations - reused);
+
+        // Run simulations, yielding to the scheduler between slices
+        for (int i = reused; i < config.num_simulations;) {
+            const int done = simulate_batch(tree, config, config.num_simulations - i);
+            i += done;
+            if (progress) {
+                update_progress(tree, i - reused, *progress);
+            }
+            // One slice unit per simulation, batched or not
+            for (int j = 0; j < done; ++j) {
+                co_await slice.checkpoint();
+            }
+        }
     }
 
-    root.expand(policy);
+    // Select action
+    auto visit_counts = tree.visit_counts(tree.root());
+    const int action = select_action(visit_counts, config.temperature);
+    if (kept) {
+        kept->keep(action);
+    }
+    co_return action;
+}
 
-    // Add noise if configured
-    add_dirichlet_noise(&root);
+void MCTS::update_progress(const SearchTree& tree, int simulations, SearchProgress& progress) {
+    int total = 0;
+    int best_visits = 0;
+    progress.best_action = -1;
+    tree.for_each_child(tree.root(), [&](int action, int visits) {
+        total += visits;
+        if (visits > best_visits) {
+            best_visits = visits;
+            progress.best_action = action;
+        }
+    });
+
+    progress.simulations = simulations;
+    progress.best_share = total > 0 ? static_cast<float>(best_visits) / static_cast<float>(total) : 0.0f;
+    progress.value = tree.q_value(tree.root());
+}
+
+std::vector<std::pair<int, float>> MCTS::search_with_probs(const GameState& state) {
+    // Create and expand the root
+    SearchTree tree;
+    tree.reuse(state, 0);
+    expand_root(tree);
+    tree.reserve(config_.num_simulations);
 
     // Run simulations
-    for (int i = 0; i < config_.num_simulations; ++i) {
-        simulate(&root);
+    for (int i = 0; i < config_.num_simulations;) {
+        i += simulate_batch(tree, config_, config_.num_simulations - i);
     }
 
     // Return visit probabilities
-    auto visit_counts = root.get_visit_counts();
+    auto visit_counts = tree.visit_counts(tree.root());
     return visit_counts_to_probs(visit_counts);
 }
 
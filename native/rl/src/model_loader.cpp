@@ -1,11 +1,195 @@
 #include "neutron_rl/model_loader.hpp"
 
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <future>
+#include <iterator>
+#include <mutex>
+#include <random>
 #include <stdexcept>
+#include <thread>
+#include <utility>
 
 namespace neutron_rl {
 
+namespace {
+
+std::atomic<uint64_t> next_loader_id{1};
+
+// INT8 calibration: positions of self-play games, moves drawn from the raw policy
+constexpr size_t kCalibrationPositions = 512;
+constexpr int kCalibrationMaxPlies = 120;
+constexpr uint32_t kCalibrationSeed = 20261018;
+
+// Encoded positions of games `network` plays against itself: the kind of positions its searches evaluate
+std::vector<float> self_play_positions(const NativeNetwork& network, size_t count) {
+    std::mt19937 rng(kCalibrationSeed);
+    std::vector<float> positions;
+    std::vector<float> logits(NativeNetwork::kActionSize);
+    float value;
+    size_t played = 0;
+    while (played < count) {
+        GameState state;
+        for (int ply = 0; ply < kCalibrationMaxPlies && !state.is_terminal() && played < count; ++ply, ++played) {
+            const auto encoded = state.encode();
+            positions.insert(positions.end(), encoded.begin(), encoded.end());
+
+            network.forward(encoded.data(), 1, logits.data(), &value);
+            const auto evaluation = Evaluation::from_logits(state, logits, value);
+            std::discrete_distribution<int> pick(evaluation.priors.begin(),
+                                                 evaluation.priors.begin() + evaluation.num_actions);
+            state = state.apply_action(evaluation.actions[pick(rng)]);
+        }
+    }
+    return positions;
+}
+
+}  // namespace
+
+/**
+ * @brief Inference thread behind enable_batching().
+ *
+ * Requests live on the stacks of their callers, which block on the future
+ * until the thread has answered them.
+ */
+class ModelLoader::Batcher {
+public:
+    struct Answer {
+        std::vector<InferenceResult> results;
+        size_t batch_size;
+        std::chrono::microseconds elapsed;
+    };
+
+    Batcher(const ModelLoader& loader, const InferenceBatching& batching)
+        : loader_(loader), batching_(batching), thread_([this] { run(); }) {}
+
+    ~Batcher() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_one();
+        thread_.join();
+    }
+
+    Answer submit(const std::vector<std::vector<float>>& tensors) {
+        Request request{&tensors, std::chrono::steady_clock::now(), {}};
+        auto answer = request.answer.get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.push_back(&request);
+            queued_positions_ += tensors.size();
+        }
+        wake_.notify_one();
+        return answer.get();
+    }
+
+    void enter() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++active_;
+    }
+
+    void leave() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --active_;
+        }
+        // One searcher fewer may mean everybody left is now waiting.
+        wake_.notify_one();
+    }
+
+private:
+    struct Request {
+        const std::vector<std::vector<float>>* tensors;
+        std::chrono::steady_clock::time_point queued;
+        std::promise<Answer> answer;
+    };
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            wake_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+            if (queue_.empty()) {
+                return;
+            }
+
+            // Wait for the other searching threads, but not past the oldest request's deadline.
+            wake_.wait_until(lock, queue_.front()->queued + batching_.max_wait, [this] {
+                return stopping_ || queued_positions_ >= batching_.max_batch ||
+                       static_cast<int>(queue_.size()) >= active_;
+            });
+
+            std::vector<Request*> batch;
+            size_t positions = 0;
+            while (!queue_.empty() &&
+                   (batch.empty() || positions + queue_.front()->tensors->size() <= batching_.max_batch)) {
+                positions += queue_.front()->tensors->size();
+                batch.push_back(queue_.front());
+                queue_.pop_front();
+            }
+            queued_positions_ -= positions;
+
+            lock.unlock();
+            answer(batch, positions);
+            lock.lock();
+        }
+    }
+
+    void answer(const std::vector<Request*>& batch, size_t positions) {
+        std::vector<const std::vector<float>*> tensors;
+        tensors.reserve(positions);
+        for (const auto* request : batch) {
+            for (const auto& tensor : *request->tensors) {
+                tensors.push_back(&tensor);
+            }
+        }
+
+        try {
+            const auto started = std::chrono::steady_clock::now();
+            auto results = loader_.forward_batch(tensors);
+            const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - started);
+
+            auto next = std::make_move_iterator(results.begin());
+            for (auto* request : batch) {
+                const auto count = static_cast<std::ptrdiff_t>(request->tensors->size());
+                // The caller may return as soon as its value is set: do not touch the request after.
+                request->answer.set_value(Answer{{next, next + count}, positions, elapsed});
+                next += count;
+            }
+        } catch (...) {
+            for (auto* request : batch) {
+                request->answer.set_exception(std::current_exception());
+            }
+        }
+    }
+
+    const ModelLoader& loader_;
+    const InferenceBatching batching_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::deque<Request*> queue_;
+    size_t queued_positions_ = 0;
+    int active_ = 0;
+    bool stopping_ = false;
+
+    // Last: started once everything above is initialized.
+    std::thread thread_;
+};
+
+#ifdef NEUTRON_RL_NO_TORCH
+
+// Exported weights only: CPU whatever the device asked for
+ModelLoader::ModelLoader(const std::string& /*device*/)
+    : id_(next_loader_id.fetch_add(1, std::memory_order_relaxed)) {}
+
+#else
+
 ModelLoader::ModelLoader(const std::string& device)
-    : device_(torch::kCPU) {
+    : device_(torch::kCPU), id_(next_loader_id.fetch_add(1, std::memory_order_relaxed)) {
     if (device == "cuda" || device == "gpu") {
         if (torch::cuda::is_available()) {
             device_ = torch::kCUDA;
@@ -15,17 +199,39 @@ ModelLoader::ModelLoader(const std::string& device)
     }
 }
 
-bool ModelLoader::load(const std::string& model_path) {
+#endif
+
+ModelLoader::~ModelLoader() = default;
+
+bool ModelLoader::load(const std::string& model_path, InferencePrecision precision) {
     try {
-        model_ = torch::jit::load(model_path, device_);
-        model_.eval();
+        if (NativeNetwork::is_weights_file(model_path)) {
+            auto network = NativeNetwork::load(model_path);
+            if (precision == InferencePrecision::Int8) {
+                const auto calibration = self_play_positions(*network, kCalibrationPositions);
+                network->quantize(calibration.data(), kCalibrationPositions);
+            }
+            native_ = std::move(network);
+        } else if (precision != InferencePrecision::Float32) {
+            throw std::runtime_error("INT8 needs exported weights (neutron_rl_weights export)");
+        } else {
+#ifdef NEUTRON_RL_NO_TORCH
+            throw std::runtime_error("built without libtorch, export the model with neutron_rl_weights");
+#else
+            model_ = torch::jit::load(model_path, device_);
+            model_.eval();
+            native_.reset();
+#endif
+        }
         loaded_ = true;
         error_message_.clear();
         return true;
+#ifndef NEUTRON_RL_NO_TORCH
     } catch (const c10::Error& e) {
         error_message_ = std::string("Failed to load model: ") + e.what();
         loaded_ = false;
         return false;
+#endif
     } catch (const std::exception& e) {
         error_message_ = std::string("Failed to load model: ") + e.what();
         loaded_ = false;
@@ -33,15 +239,23 @@ bool ModelLoader::load(const std::string& model_path) {
     }
 }
 
+InferencePrecision ModelLoader::precision() const {
+    return native_ && native_->quantized() ? InferencePrecision::Int8 : InferencePrecision::Float32;
+}
+
 bool ModelLoader::is_loaded() const {
     return loaded_;
 }
 
-InferenceResult ModelLoader::infer(const std::vector<float>& board_tensor) {
+InferenceResult ModelLoader::infer(const std::vector<float>& board_tensor) const {
     if (!loaded_) {
         throw std::runtime_error("No model loaded");
     }
 
+    if (batcher_) {
+        return std::move(infer_batch({board_tensor}).front());
+    }
+
     // Validate input size
     const size_t expected_size = kInputChannels * kBoardSize * kBoardSize;
     if (board_tensor.size() != expected_size) {
@@ -50,6 +264,15 @@ InferenceResult ModelLoader::infer(const std::vector<float>& board_tensor) {
             ", got " + std::to_string(board_tensor.size()));
     }
 
+    if (native_) {
+        const auto started = std::chrono::steady_clock::now();
+        auto result = std::move(forward_batch({&board_tensor}).front());
+        notify_observer(1, started);
+        return result;
+    }
+
+#ifndef NEUTRON_RL_NO_TORCH
+
     // Create input tensor [1, 4, 5, 5]
     auto options = torch::TensorOptions().dtype(torch::kFloat32);
     torch::Tensor input = torch::from_blob(
@@ -63,7 +286,9 @@ InferenceResult ModelLoader::infer(const std::vector<float>& board_tensor) {
     inputs.push_back(input);
 
     torch::NoGradGuard no_grad;
+    const auto started = std::chrono::steady_clock::now();
     auto outputs = model_.forward(inputs);
+    notify_observer(1, started);
 
     // Handle tuple output (policy, value)
     if (outputs.isTuple()) {
@@ -79,12 +304,13 @@ InferenceResult ModelLoader::infer(const std::vector<float>& board_tensor) {
         result.value = value_tensor.item<float>();
         return result;
     }
+#endif
 
     throw std::runtime_error("Unexpected model output format");
 }
 
 std::vector<InferenceResult> ModelLoader::infer_batch(
-    const std::vector<std::vector<float>>& board_tensors) {
+    const std::vector<std::vector<float>>& board_tensors) const {
     if (!loaded_) {
         throw std::runtime_error("No model loaded");
     }
@@ -93,19 +319,57 @@ std::vector<InferenceResult> ModelLoader::infer_batch(
         return {};
     }
 
+    if (batcher_) {
+        auto answer = batcher_->submit(board_tensors);
+        if (observer_) {
+            observer_(answer.batch_size, answer.elapsed);
+        }
+        return std::move(answer.results);
+    }
+
+    std::vector<const std::vector<float>*> tensors;
+    tensors.reserve(board_tensors.size());
+    for (const auto& tensor : board_tensors) {
+        tensors.push_back(&tensor);
+    }
+
+    const auto started = std::chrono::steady_clock::now();
+    auto results = forward_batch(tensors);
+    notify_observer(tensors.size(), started);
+    return results;
+}
+
+std::vector<InferenceResult> ModelLoader::forward_batch(
+    const std::vector<const std::vector<float>*>& board_tensors) const {
     const size_t batch_size = board_tensors.size();
     const size_t tensor_size = kInputChannels * kBoardSize * kBoardSize;
 
     // Validate and flatten input
     std::vector<float> flat_input;
     flat_input.reserve(batch_size * tensor_size);
-    for (const auto& tensor : board_tensors) {
-        if (tensor.size() != tensor_size) {
+    for (const auto* tensor : board_tensors) {
+        if (tensor->size() != tensor_size) {
             throw std::invalid_argument("Invalid board tensor size in batch");
         }
-        flat_input.insert(flat_input.end(), tensor.begin(), tensor.end());
+        flat_input.insert(flat_input.end(), tensor->begin(), tensor->end());
+    }
+
+    if (native_) {
+        std::vector<float> policy(batch_size * kActionSize);
+        std::vector<float> values(batch_size);
+        native_->forward(flat_input.data(), batch_size, policy.data(), values.data());
+
+        std::vector<InferenceResult> results(batch_size);
+        for (size_t i = 0; i < batch_size; ++i) {
+            const auto first = policy.begin() + static_cast<std::ptrdiff_t>(i * kActionSize);
+            results[i].policy_logits.assign(first, first + kActionSize);
+            results[i].value = values[i];
+        }
+        return results;
     }
 
+#ifndef NEUTRON_RL_NO_TORCH
+
     // Create input tensor [batch, 4, 5, 5]
     auto options = torch::TensorOptions().dtype(torch::kFloat32);
     torch::Tensor input = torch::from_blob(
@@ -141,23 +405,73 @@ std::vector<InferenceResult> ModelLoader::infer_batch(
         }
         return results;
     }
+#endif
 
     throw std::runtime_error("Unexpected model output format");
 }
 
+void ModelLoader::enable_batching(const InferenceBatching& batching) {
+    batcher_ = batching.max_batch > 1 ? std::make_unique<Batcher>(*this, batching) : nullptr;
+}
+
+ModelLoader::Activity ModelLoader::activity() const {
+    return Activity(batcher_.get());
+}
+
+ModelLoader::Activity::Activity(Batcher* batcher) : batcher_(batcher) {
+    if (batcher_) {
+        batcher_->enter();
+    }
+}
+
+ModelLoader::Activity::~Activity() {
+    if (batcher_) {
+        batcher_->leave();
+    }
+}
+
+void ModelLoader::enable_eval_cache(size_t entries, EvalCache::Observer observer) {
+    eval_cache_ = entries > 0 ? std::make_unique<EvalCache>(entries, std::move(observer)) : nullptr;
+}
+
+EvalCache* ModelLoader::eval_cache() const {
+    return eval_cache_.get();
+}
+
+void ModelLoader::set_inference_observer(InferenceObserver observer) {
+    observer_ = std::move(observer);
+}
+
+void ModelLoader::notify_observer(size_t batch_size, std::chrono::steady_clock::time_point started) const {
+    if (observer_) {
+        observer_(batch_size, std::chrono::duration_cast<std::chrono::microseconds>(
+                                  std::chrono::steady_clock::now() - started));
+    }
+}
+
 std::string ModelLoader::get_error_message() const {
     return error_message_;
 }
 
 std::string ModelLoader::get_device() const {
-    if (device_.is_cuda()) {
+#ifndef NEUTRON_RL_NO_TORCH
+    if (!native_ && device_.is_cuda()) {
         return "cuda:" + std::to_string(device_.index());
     }
+#endif
     return "cpu";
 }
 
+uint64_t ModelLoader::id() const {
+    return id_;
+}
+
 bool ModelLoader::cuda_available() {
+#ifdef NEUTRON_RL_NO_TORCH
+    return false;
+#else
     return torch::cuda::is_available();
+#endif
 }
 
 }  // namespace neutron_rl
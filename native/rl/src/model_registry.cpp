@@ -0,0 +1,43 @@
+#include "neutron_rl/model_registry.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+namespace neutron_rl {
+
+std::mutex ModelRegistry::mutex_;
+std::map<std::string, std::weak_ptr<const ModelLoader>> ModelRegistry::models_;
+
+std::shared_ptr<const ModelLoader> ModelRegistry::acquire(
+    const std::string& model_path,
+    const std::string& device,
+    ModelLoader::InferenceObserver observer,
+    const InferenceBatching& batching,
+    size_t eval_cache_entries,
+    EvalCache::Observer cache_observer,
+    InferencePrecision precision) {
+    const std::string key =
+        device + (precision == InferencePrecision::Int8 ? "/int8" : "") + ":" + model_path;
+
+    // Held while loading, so two environments asking for the same model
+    // concurrently load it only once.
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (auto cached = models_[key].lock()) {
+        return cached;
+    }
+
+    auto loader = std::make_shared<ModelLoader>(device);
+    if (!loader->load(model_path, precision)) {
+        models_.erase(key);
+        throw std::runtime_error(loader->get_error_message());
+    }
+    loader->set_inference_observer(std::move(observer));
+    loader->enable_batching(batching);
+    loader->enable_eval_cache(eval_cache_entries, std::move(cache_observer));
+
+    std::shared_ptr<const ModelLoader> shared = std::move(loader);
+    models_[key] = shared;
+    return shared;
+}
+
+}  // namespace neutron_rl
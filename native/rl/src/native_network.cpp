@@ -0,0 +1,834 @@
+#include "neutron_rl/native_network.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <initializer_list>
+#include <iterator>
+#include <map>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define NEUTRON_RL_X86 1
+#endif
+
+namespace neutron_rl {
+
+namespace {
+
+constexpr char kMagic[4] = {'N', 'R', 'L', 'W'};
+constexpr uint32_t kVersion = 1;
+
+// BatchNorm2d default, the one in the exported graph
+constexpr float kBatchNormEps = 1e-5f;
+
+struct Tensor {
+    std::vector<uint32_t> sizes;
+    std::vector<float> values;
+};
+
+using Tensors = std::map<std::string, Tensor>;
+
+// Bounds-checked reads from the weights file
+class Reader {
+public:
+    explicit Reader(std::vector<char> bytes) : bytes_(std::move(bytes)) {}
+
+    void read(void* out, size_t size) {
+        if (size > bytes_.size() - offset_) {
+            throw std::runtime_error("Invalid weights file: truncated");
+        }
+        std::memcpy(out, bytes_.data() + offset_, size);
+        offset_ += size;
+    }
+
+    uint32_t u32() {
+        uint32_t value;
+        read(&value, sizeof(value));
+        return value;
+    }
+
+    bool done() const {
+        return offset_ == bytes_.size();
+    }
+
+private:
+    std::vector<char> bytes_;
+    size_t offset_ = 0;
+};
+
+Tensors read_tensors(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Cannot open weights file " + path);
+    }
+    Reader reader(std::vector<char>(std::istreambuf_iterator<char>(file), {}));
+
+    char magic[sizeof(kMagic)];
+    reader.read(magic, sizeof(magic));
+    if (std::memcmp(magic, kMagic, sizeof(kMagic)) != 0) {
+        throw std::runtime_error("Invalid weights file: bad magic");
+    }
+    if (const uint32_t version = reader.u32(); version != kVersion) {
+        throw std::runtime_error("Unsupported weights file version " + std::to_string(version));
+    }
+
+    Tensors tensors;
+    const uint32_t count = reader.u32();
+    for (uint32_t i = 0; i < count; ++i) {
+        std::string name(reader.u32(), '\0');
+        reader.read(name.data(), name.size());
+
+        Tensor tensor;
+        tensor.sizes.resize(reader.u32());
+        size_t elements = 1;
+        for (auto& size : tensor.sizes) {
+            size = reader.u32();
+            elements *= size;
+        }
+        tensor.values.resize(elements);
+        reader.read(tensor.values.data(), elements * sizeof(float));
+        tensors.emplace(std::move(name), std::move(tensor));
+    }
+
+    if (!reader.done()) {
+        throw std::runtime_error("Invalid weights file: trailing bytes");
+    }
+    return tensors;
+}
+
+// Tensor `name` with the given sizes (0 = any)
+const Tensor& find(const Tensors& tensors, const std::string& name, std::initializer_list<uint32_t> sizes) {
+    const auto it = tensors.find(name);
+    if (it == tensors.end()) {
+        throw std::runtime_error("Weights file lacks " + name);
+    }
+
+    const auto& tensor = it->second;
+    bool match = tensor.sizes.size() == sizes.size();
+    for (size_t i = 0; match && i < sizes.size(); ++i) {
+        const auto expected = sizes.begin()[i];
+        match = expected == 0 || tensor.sizes[i] == expected;
+    }
+    if (!match) {
+        throw std::runtime_error("Unexpected shape of " + name);
+    }
+    return tensor;
+}
+
+// Inputs and weight matrices of a fused product over `cells` consecutive cells: cell j reads
+// x[t] + j * stride and adds x * w[t] (in x out) over the taps t
+struct Taps {
+    int count = 0;
+    int cells = 1;
+    int stride = 0;
+    std::array<const float*, 9> x{};
+    std::array<const float*, 9> w{};
+};
+
+// dst[j][n] = bias[n] + sum_t sum_k x[t][j][k] * w[t][k][n] (+ residual[j][n]), then ReLU, for n in [begin, end);
+// dst and residual rows are `out` apart
+void fused_range(const Taps& taps, int in, int out, const float* bias, const float* residual, bool relu, float* dst,
+                 int begin, int end) {
+    for (int j = 0; j < taps.cells; ++j) {
+        float* row = dst + j * out;
+        for (int n = begin; n < end; ++n) {
+            row[n] = bias[n];
+        }
+        for (int t = 0; t < taps.count; ++t) {
+            const float* x = taps.x[t] + j * taps.stride;
+            const float* w = taps.w[t];
+            for (int k = 0; k < in; ++k, w += out) {
+                const float xk = x[k];
+                for (int n = begin; n < end; ++n) {
+                    row[n] += xk * w[n];
+                }
+            }
+        }
+        for (int n = begin; n < end; ++n) {
+            float value = residual ? row[n] + residual[j * out + n] : row[n];
+            row[n] = relu ? std::max(value, 0.0f) : value;
+        }
+    }
+}
+
+void fused_scalar(const Taps& taps, int in, int out, const float* bias, const float* residual, bool relu, float* dst) {
+    fused_range(taps, in, out, bias, residual, relu, dst, 0, out);
+}
+
+#if NEUTRON_RL_X86
+
+// Outputs [n, n + 8 * Width) of Cells cells: Cells x Width accumulators, each weight load used Cells times.
+// Returns the first output left.
+template <int Cells, int Width>
+__attribute__((target("avx2,fma")))
+int fused_avx2_tile(const Taps& taps, int in, int out, const float* bias, const float* residual, bool relu, float* dst,
+                    int n) {
+    constexpr int kLanes = 8;
+    const __m256 zero = _mm256_setzero_ps();
+    for (; n + kLanes * Width <= out; n += kLanes * Width) {
+        __m256 acc[Cells][Width];
+        for (int j = 0; j < Cells; ++j) {
+            for (int i = 0; i < Width; ++i) {
+                acc[j][i] = _mm256_loadu_ps(bias + n + kLanes * i);
+            }
+        }
+        for (int t = 0; t < taps.count; ++t) {
+            const float* x = taps.x[t];
+            const float* w = taps.w[t] + n;
+            for (int k = 0; k < in; ++k, w += out) {
+                __m256 wk[Width];
+                for (int i = 0; i < Width; ++i) {
+                    wk[i] = _mm256_loadu_ps(w + kLanes * i);
+                }
+                for (int j = 0; j < Cells; ++j) {
+                    const __m256 xk = _mm256_broadcast_ss(x + j * taps.stride + k);
+                    for (int i = 0; i < Width; ++i) {
+                        acc[j][i] = _mm256_fmadd_ps(xk, wk[i], acc[j][i]);
+                    }
+                }
+            }
+        }
+        for (int j = 0; j < Cells; ++j) {
+            for (int i = 0; i < Width; ++i) {
+                const int offset = j * out + n + kLanes * i;
+                if (residual) {
+                    acc[j][i] = _mm256_add_ps(acc[j][i], _mm256_loadu_ps(residual + offset));
+                }
+                if (relu) {
+                    acc[j][i] = _mm256_max_ps(acc[j][i], zero);
+                }
+                _mm256_storeu_ps(dst + offset, acc[j][i]);
+            }
+        }
+    }
+    return n;
+}
+
+// A row of the board: 5 cells x 16 outputs, 10 accumulators. One cell: 64 outputs, 8 accumulators.
+void fused_avx2(const Taps& taps, int in, int out, const float* bias, const float* residual, bool relu, float* dst) {
+    int n = 0;
+    if (taps.cells == NativeNetwork::kBoardSize) {
+        n = fused_avx2_tile<NativeNetwork::kBoardSize, 2>(taps, in, out, bias, residual, relu, dst, n);
+        n = fused_avx2_tile<NativeNetwork::kBoardSize, 1>(taps, in, out, bias, residual, relu, dst, n);
+    } else if (taps.cells == 1) {
+        n = fused_avx2_tile<1, 8>(taps, in, out, bias, residual, relu, dst, n);
+        n = fused_avx2_tile<1, 1>(taps, in, out, bias, residual, relu, dst, n);
+    }
+    fused_range(taps, in, out, bias, residual, relu, dst, n, out);
+}
+
+template <int Cells, int Width>
+__attribute__((target("avx512f")))
+int fused_avx512_tile(const Taps& taps, int in, int out, const float* bias, const float* residual, bool relu,
+                      float* dst, int n) {
+    constexpr int kLanes = 16;
+    const __m512 zero = _mm512_setzero_ps();
+    for (; n + kLanes * Width <= out; n += kLanes * Width) {
+        __m512 acc[Cells][Width];
+        for (int j = 0; j < Cells; ++j) {
+            for (int i = 0; i < Width; ++i) {
+                acc[j][i] = _mm512_loadu_ps(bias + n + kLanes * i);
+            }
+        }
+        for (int t = 0; t < taps.count; ++t) {
+            const float* x = taps.x[t];
+            const float* w = taps.w[t] + n;
+            for (int k = 0; k < in; ++k, w += out) {
+                __m512 wk[Width];
+                for (int i = 0; i < Width; ++i) {
+                    wk[i] = _mm512_loadu_ps(w + kLanes * i);
+                }
+                for (int j = 0; j < Cells; ++j) {
+                    const __m512 xk = _mm512_set1_ps(x[j * taps.stride + k]);
+                    for (int i = 0; i < Width; ++i) {
+                        acc[j][i] = _mm512_fmadd_ps(xk, wk[i], acc[j][i]);
+                    }
+                }
+            }
+        }
+        for (int j = 0; j < Cells; ++j) {
+            for (int i = 0; i < Width; ++i) {
+                const int offset = j * out + n + kLanes * i;
+                if (residual) {
+                    acc[j][i] = _mm512_add_ps(acc[j][i], _mm512_loadu_ps(residual + offset));
+                }
+                if (relu) {
+                    // Masked form: GCC 12 warns about the undefined source of the plain one
+                    acc[j][i] = _mm512_mask_max_ps(acc[j][i], 0xFFFF, acc[j][i], zero);
+                }
+                _mm512_storeu_ps(dst + offset, acc[j][i]);
+            }
+        }
+    }
+    return n;
+}
+
+// A row of the board: 5 cells x 64 outputs, 20 accumulators. One cell: 128 outputs, 8 accumulators.
+void fused_avx512(const Taps& taps, int in, int out, const float* bias, const float* residual, bool relu, float* dst) {
+    int n = 0;
+    if (taps.cells == NativeNetwork::kBoardSize) {
+        n = fused_avx512_tile<NativeNetwork::kBoardSize, 4>(taps, in, out, bias, residual, relu, dst, n);
+        n = fused_avx512_tile<NativeNetwork::kBoardSize, 1>(taps, in, out, bias, residual, relu, dst, n);
+    } else if (taps.cells == 1) {
+        n = fused_avx512_tile<1, 8>(taps, in, out, bias, residual, relu, dst, n);
+        n = fused_avx512_tile<1, 1>(taps, in, out, bias, residual, relu, dst, n);
+    }
+    fused_range(taps, in, out, bias, residual, relu, dst, n, out);
+}
+
+#endif
+
+using Kernel = void (*)(const Taps&, int, int, const float*, const float*, bool, float*);
+
+Kernel kernel_of(NativeNetwork::Isa isa) {
+    switch (isa) {
+#if NEUTRON_RL_X86
+        case NativeNetwork::Isa::Avx512: return fused_avx512;
+        case NativeNetwork::Isa::Avx2: return fused_avx2;
+#endif
+        default: return fused_scalar;
+    }
+}
+
+bool supported(NativeNetwork::Isa isa) {
+    switch (isa) {
+#if NEUTRON_RL_X86
+        case NativeNetwork::Isa::Avx512: return __builtin_cpu_supports("avx512f");
+        case NativeNetwork::Isa::Avx2: return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+        case NativeNetwork::Isa::Scalar: return true;
+        default: return false;
+    }
+}
+
+// INT8 counterpart of Taps: 7-bit activation codes, weights as [in / 4][out][4] bytes per tap
+struct QuantizedTaps {
+    int count = 0;
+    int cells = 1;
+    int stride = 0;
+    std::array<const uint8_t*, 9> x{};
+    std::array<const int8_t*, 9> w{};
+};
+
+// dst[j][n] = ReLU(scale[n] * sum_t sum_k x[t][j][k] * w[t][k][n] + bias[n] (+ residual[j][n])) for n in [begin, end)
+void quantized_range(const QuantizedTaps& taps, int in, int out, const float* scale, const float* bias,
+                     const float* residual, float* dst, int begin, int end) {
+    std::vector<int32_t> sums(end - begin);
+    for (int j = 0; j < taps.cells; ++j) {
+        std::fill(sums.begin(), sums.end(), 0);
+        for (int t = 0; t < taps.count; ++t) {
+            const uint8_t* x = taps.x[t] + j * taps.stride;
+            const int8_t* w = taps.w[t];
+            for (int k = 0; k < in; k += 4, w += out * 4) {
+                for (int n = begin; n < end; ++n) {
+                    const int8_t* wn = w + n * 4;
+                    sums[n - begin] += x[k] * wn[0] + x[k + 1] * wn[1] + x[k + 2] * wn[2] + x[k + 3] * wn[3];
+                }
+            }
+        }
+        for (int n = begin; n < end; ++n) {
+            const float value = scale[n] * static_cast<float>(sums[n - begin]) + bias[n];
+            dst[j * out + n] = std::max(residual ? value + residual[j * out + n] : value, 0.0f);
+        }
+    }
+}
+
+void quantized_scalar(const QuantizedTaps& taps, int in, int out, const float* scale, const float* bias,
+                      const float* residual, float* dst) {
+    quantized_range(taps, in, out, scale, bias, residual, dst, 0, out);
+}
+
+#if NEUTRON_RL_X86
+
+// Outputs [n, n + 8 * Width) of Cells cells. Without VNNI, u8 x s8 pairs go to 16 bits (maddubs; 7-bit
+// activations keep the pair sum from saturating), then to 32 bits (madd by ones).
+template <int Cells, int Width>
+__attribute__((target("avx2,fma")))
+int quantized_avx2_tile(const QuantizedTaps& taps, int in, int out, const float* scale, const float* bias,
+                        const float* residual, float* dst, int n) {
+    constexpr int kLanes = 8;
+    const __m256i ones = _mm256_set1_epi16(1);
+    for (; n + kLanes * Width <= out; n += kLanes * Width) {
+        __m256i acc[Cells][Width];
+        for (int j = 0; j < Cells; ++j) {
+            for (int i = 0; i < Width; ++i) {
+                acc[j][i] = _mm256_setzero_si256();
+            }
+        }
+        for (int t = 0; t < taps.count; ++t) {
+            const uint8_t* x = taps.x[t];
+            const int8_t* w = taps.w[t] + n * 4;
+            for (int k = 0; k < in; k += 4, w += out * 4) {
+                __m256i wk[Width];
+                for (int i = 0; i < Width; ++i) {
+                    wk[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + 4 * kLanes * i));
+                }
+                for (int j = 0; j < Cells; ++j) {
+                    int32_t quad;
+                    std::memcpy(&quad, x + j * taps.stride + k, sizeof(quad));
+                    const __m256i xk = _mm256_set1_epi32(quad);
+                    for (int i = 0; i < Width; ++i) {
+                        const __m256i pairs = _mm256_maddubs_epi16(xk, wk[i]);
+                        acc[j][i] = _mm256_add_epi32(acc[j][i], _mm256_madd_epi16(pairs, ones));
+                    }
+                }
+            }
+        }
+        for (int j = 0; j < Cells; ++j) {
+            for (int i = 0; i < Width; ++i) {
+                const int offset = j * out + n + kLanes * i;
+                __m256 value = _mm256_fmadd_ps(_mm256_loadu_ps(scale + n + kLanes * i), _mm256_cvtepi32_ps(acc[j][i]),
+                                               _mm256_loadu_ps(bias + n + kLanes * i));
+                if (residual) {
+                    value = _mm256_add_ps(value, _mm256_loadu_ps(residual + offset));
+                }
+                _mm256_storeu_ps(dst + offset, _mm256_max_ps(value, _mm256_setzero_ps()));
+            }
+        }
+    }
+    return n;
+}
+
+void quantized_avx2(const QuantizedTaps& taps, int in, int out, const float* scale, const float* bias,
+                    const float* residual, float* dst) {
+    int n = 0;
+    if (taps.cells == NativeNetwork::kBoardSize) {
+        n = quantized_avx2_tile<NativeNetwork::kBoardSize, 2>(taps, in, out, scale, bias, residual, dst, n);
+        n = quantized_avx2_tile<NativeNetwork::kBoardSize, 1>(taps, in, out, scale, bias, residual, dst, n);
+    }
+    quantized_range(taps, in, out, scale, bias, residual, dst, n, out);
+}
+
+// Outputs [n, n + 16 * Width) of Cells cells, four inputs per instruction (vpdpbusd)
+template <int Cells, int Width>
+__attribute__((target("avx512f,avx512bw,avx512vnni")))
+int quantized_avx512_tile(const QuantizedTaps& taps, int in, int out, const float* scale, const float* bias,
+                          const float* residual, float* dst, int n) {
+    constexpr int kLanes = 16;
+    const __m512 zero = _mm512_setzero_ps();
+    for (; n + kLanes * Width <= out; n += kLanes * Width) {
+        __m512i acc[Cells][Width];
+        for (int j = 0; j < Cells; ++j) {
+            for (int i = 0; i < Width; ++i) {
+                acc[j][i] = _mm512_setzero_si512();
+            }
+        }
+        for (int t = 0; t < taps.count; ++t) {
+            const uint8_t* x = taps.x[t];
+            const int8_t* w = taps.w[t] + n * 4;
+            for (int k = 0; k < in; k += 4, w += out * 4) {
+                __m512i wk[Width];
+                for (int i = 0; i < Width; ++i) {
+                    wk[i] = _mm512_loadu_si512(w + 4 * kLanes * i);
+                }
+                for (int j = 0; j < Cells; ++j) {
+                    int32_t quad;
+                    std::memcpy(&quad, x + j * taps.stride + k, sizeof(quad));
+                    const __m512i xk = _mm512_set1_epi32(quad);
+                    for (int i = 0; i < Width; ++i) {
+                        acc[j][i] = _mm512_dpbusd_epi32(acc[j][i], xk, wk[i]);
+                    }
+                }
+            }
+        }
+        for (int j = 0; j < Cells; ++j) {
+            for (int i = 0; i < Width; ++i) {
+                const int offset = j * out + n + kLanes * i;
+                // Masked conversion, for the same GCC 12 warning as the masked max
+                const __m512 sum = _mm512_mask_cvtepi32_ps(zero, 0xFFFF, acc[j][i]);
+                __m512 value =
+                    _mm512_fmadd_ps(_mm512_loadu_ps(scale + n + kLanes * i), sum, _mm512_loadu_ps(bias + n + kLanes * i));
+                if (residual) {
+                    value = _mm512_add_ps(value, _mm512_loadu_ps(residual + offset));
+                }
+                _mm512_storeu_ps(dst + offset, _mm512_mask_max_ps(value, 0xFFFF, value, zero));
+            }
+        }
+    }
+    return n;
+}
+
+void quantized_avx512(const QuantizedTaps& taps, int in, int out, const float* scale, const float* bias,
+                      const float* residual, float* dst) {
+    int n = 0;
+    if (taps.cells == NativeNetwork::kBoardSize) {
+        n = quantized_avx512_tile<NativeNetwork::kBoardSize, 4>(taps, in, out, scale, bias, residual, dst, n);
+        n = quantized_avx512_tile<NativeNetwork::kBoardSize, 1>(taps, in, out, scale, bias, residual, dst, n);
+    }
+    quantized_range(taps, in, out, scale, bias, residual, dst, n, out);
+}
+
+#endif
+
+using QuantizedKernel = void (*)(const QuantizedTaps&, int, int, const float*, const float*, const float*, float*);
+
+QuantizedKernel quantized_kernel_of(NativeNetwork::Isa isa) {
+    switch (isa) {
+#if NEUTRON_RL_X86
+        case NativeNetwork::Isa::Avx512: return quantized_avx512;
+        case NativeNetwork::Isa::Avx2: return quantized_avx2;
+#endif
+        default: return quantized_scalar;
+    }
+}
+
+// The INT8 kernels need more of AVX-512 than the FP32 ones
+bool quantized_supported(NativeNetwork::Isa isa) {
+#if NEUTRON_RL_X86
+    if (isa == NativeNetwork::Isa::Avx512) {
+        return __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512vnni");
+    }
+#endif
+    return supported(isa);
+}
+
+using Layer = NativeNetwork::Layer;
+
+// Convolution `conv` followed by batch norm `bn`, folded into [tap][in][out] weights and a bias
+Layer folded_conv(const Tensors& tensors, const std::string& conv, const std::string& bn, uint32_t in,
+                   uint32_t kernel) {
+    const auto& weight = find(tensors, conv + ".weight", {0, in, kernel, kernel});
+    const uint32_t out = weight.sizes[0];
+    const auto& bias = find(tensors, conv + ".bias", {out});
+    const auto& gamma = find(tensors, bn + ".weight", {out});
+    const auto& beta = find(tensors, bn + ".bias", {out});
+    const auto& mean = find(tensors, bn + ".running_mean", {out});
+    const auto& var = find(tensors, bn + ".running_var", {out});
+
+    const uint32_t taps = kernel * kernel;
+    Layer layer;
+    layer.in = static_cast<int>(in);
+    layer.out = static_cast<int>(out);
+    layer.weights.resize(static_cast<size_t>(taps) * in * out);
+    layer.bias.resize(out);
+    for (uint32_t o = 0; o < out; ++o) {
+        const float scale = gamma.values[o] / std::sqrt(var.values[o] + kBatchNormEps);
+        layer.bias[o] = (bias.values[o] - mean.values[o]) * scale + beta.values[o];
+        for (uint32_t i = 0; i < in; ++i) {
+            for (uint32_t tap = 0; tap < taps; ++tap) {
+                layer.weights[(static_cast<size_t>(tap) * in + i) * out + o] =
+                    weight.values[(static_cast<size_t>(o) * in + i) * taps + tap] * scale;
+            }
+        }
+    }
+    return layer;
+}
+
+// Linear layer as an in x out matrix. Its input is the flattened output of a layer with
+// `channels` channels: channel-major in TorchScript, cell-major here.
+Layer dense_layer(const Tensors& tensors, const std::string& name, uint32_t in, uint32_t channels) {
+    const auto& weight = find(tensors, name + ".weight", {0, in});
+    const uint32_t out = weight.sizes[0];
+    const auto& bias = find(tensors, name + ".bias", {out});
+    const uint32_t cells = in / channels;
+
+    Layer layer;
+    layer.in = static_cast<int>(in);
+    layer.out = static_cast<int>(out);
+    layer.weights.resize(static_cast<size_t>(in) * out);
+    layer.bias = bias.values;
+    for (uint32_t o = 0; o < out; ++o) {
+        for (uint32_t c = 0; c < channels; ++c) {
+            for (uint32_t cell = 0; cell < cells; ++cell) {
+                layer.weights[(static_cast<size_t>(cell) * channels + c) * out + o] =
+                    weight.values[static_cast<size_t>(o) * in + c * cells + cell];
+            }
+        }
+    }
+    return layer;
+}
+
+
+// Per-output-channel symmetric INT8 weights of a 3x3 convolution whose input takes values up to `largest_input`
+NativeNetwork::QuantizedLayer quantized_conv(const Layer& layer, float largest_input) {
+    constexpr int kTaps = 9;
+    NativeNetwork::QuantizedLayer quantized;
+    quantized.in = layer.in;
+    quantized.out = layer.out;
+    quantized.input_scale = largest_input > 0.0f ? largest_input / 127.0f : 1.0f;
+    quantized.weights.resize(static_cast<size_t>(kTaps) * layer.in * layer.out);
+    quantized.scale.resize(layer.out);
+    quantized.bias = layer.bias;
+
+    for (int o = 0; o < layer.out; ++o) {
+        float largest = 0.0f;
+        for (size_t i = o; i < layer.weights.size(); i += layer.out) {
+            largest = std::max(largest, std::abs(layer.weights[i]));
+        }
+        const float weight_scale = largest > 0.0f ? largest / 127.0f : 1.0f;
+        quantized.scale[o] = quantized.input_scale * weight_scale;
+
+        for (int tap = 0; tap < kTaps; ++tap) {
+            for (int k = 0; k < layer.in; ++k) {
+                const float weight = layer.weights[(static_cast<size_t>(tap) * layer.in + k) * layer.out + o];
+                quantized.weights[((static_cast<size_t>(tap) * layer.in + k / 4 * 4) * layer.out + o * 4) + k % 4] =
+                    static_cast<int8_t>(std::lround(weight / weight_scale));
+            }
+        }
+    }
+    return quantized;
+}
+
+}  // namespace
+
+bool NativeNetwork::is_weights_file(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    char magic[sizeof(kMagic)] = {};
+    return file.read(magic, sizeof(magic)) && std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+}
+
+std::unique_ptr<NativeNetwork> NativeNetwork::load(const std::string& path, Isa isa) {
+    const auto tensors = read_tensors(path);
+
+    std::unique_ptr<NativeNetwork> network(new NativeNetwork());
+    while (!supported(isa)) {
+        isa = static_cast<Isa>(static_cast<int>(isa) - 1);
+    }
+    network->isa_ = isa;
+
+    network->input_conv_ = folded_conv(tensors, "input_conv", "input_bn", kInputChannels, 3);
+    const auto channels = static_cast<uint32_t>(network->input_conv_.out);
+    for (int i = 0; tensors.count("res_blocks." + std::to_string(i) + ".conv1.weight"); ++i) {
+        const std::string block = "res_blocks." + std::to_string(i);
+        network->blocks_.push_back({folded_conv(tensors, block + ".conv1", block + ".bn1", channels, 3),
+                                    folded_conv(tensors, block + ".conv2", block + ".bn2", channels, 3)});
+        if (network->blocks_.back().conv2.out != network->input_conv_.out) {
+            throw std::runtime_error("Unexpected shape of " + block + ".conv2.weight");
+        }
+    }
+
+    network->policy_conv_ = folded_conv(tensors, "policy_conv", "policy_bn", channels, 1);
+    const auto policy_channels = static_cast<uint32_t>(network->policy_conv_.out);
+    network->policy_fc_ = dense_layer(tensors, "policy_fc", policy_channels * kCells, policy_channels);
+    if (network->policy_fc_.out != kActionSize) {
+        throw std::runtime_error("Unexpected shape of policy_fc.weight");
+    }
+
+    network->value_conv_ = folded_conv(tensors, "value_conv", "value_bn", channels, 1);
+    const auto value_channels = static_cast<uint32_t>(network->value_conv_.out);
+    network->value_fc1_ = dense_layer(tensors, "value_fc1", value_channels * kCells, value_channels);
+    network->value_fc2_ = dense_layer(tensors, "value_fc2", static_cast<uint32_t>(network->value_fc1_.out), 1);
+    if (network->value_fc2_.out != 1) {
+        throw std::runtime_error("Unexpected shape of value_fc2.weight");
+    }
+
+    // Padded input and three activations of the trunk, both heads, value hidden layer and output
+    network->scratch_size_ = static_cast<size_t>(kPaddedCells) * (kInputChannels + 3 * channels) +
+                             static_cast<size_t>(kCells) * (policy_channels + value_channels) +
+                             static_cast<size_t>(network->value_fc1_.out) + 1;
+    return network;
+}
+
+NativeNetwork::Isa NativeNetwork::preferred_isa() {
+    if (const char* name = std::getenv("NEUTRON_RL_ISA")) {
+        for (const auto isa : {Isa::Scalar, Isa::Avx2, Isa::Avx512}) {
+            if (std::strcmp(name, isa_name(isa)) == 0 && supported(isa)) {
+                return isa;
+            }
+        }
+    }
+
+    for (const auto isa : {Isa::Avx512, Isa::Avx2}) {
+        if (supported(isa)) {
+            return isa;
+        }
+    }
+    return Isa::Scalar;
+}
+
+const char* NativeNetwork::isa_name(Isa isa) {
+    switch (isa) {
+        case Isa::Avx512: return "avx512";
+        case Isa::Avx2: return "avx2";
+        default: return "scalar";
+    }
+}
+
+NativeNetwork::Isa NativeNetwork::isa() const {
+    return isa_;
+}
+
+void NativeNetwork::quantize(const float* calibration, size_t count) {
+    const int channels = input_conv_.out;
+    if (channels % 4 != 0) {
+        throw std::runtime_error("INT8 needs a multiple of 4 channels");
+    }
+
+    // Largest input of every trunk convolution over the calibration positions, in FP32
+    quantized_ = false;
+    std::vector<float> largest(1 + 2 * blocks_.size(), 0.0f);
+    std::vector<float> scratch(scratch_size_, 0.0f);
+    std::vector<uint8_t> codes(static_cast<size_t>(kPaddedCells) * channels);
+    std::vector<float> policy(kActionSize);
+    float value;
+    for (size_t i = 0; i < count; ++i) {
+        forward_one(calibration + i * kInputChannels * kCells, policy.data(), &value, scratch.data(), codes.data(),
+                    &largest);
+    }
+
+    quantized_input_conv_ = quantized_conv(input_conv_, largest[0]);
+    quantized_blocks_.clear();
+    for (size_t i = 0; i < blocks_.size(); ++i) {
+        quantized_blocks_.push_back({quantized_conv(blocks_[i].conv1, largest[1 + 2 * i]),
+                                     quantized_conv(blocks_[i].conv2, largest[2 + 2 * i])});
+    }
+
+    quantized_isa_ = isa_;
+    while (!quantized_supported(quantized_isa_)) {
+        quantized_isa_ = static_cast<Isa>(static_cast<int>(quantized_isa_) - 1);
+    }
+    quantized_ = true;
+}
+
+bool NativeNetwork::quantized() const {
+    return quantized_;
+}
+
+void NativeNetwork::forward(const float* input, size_t batch, float* policy, float* value) const {
+    // Zeroed once: forward_one() only writes board interiors, so the padding stays zero
+    thread_local std::vector<float> scratch;
+    thread_local std::vector<uint8_t> codes;
+    scratch.assign(scratch_size_, 0.0f);
+    codes.resize(static_cast<size_t>(kPaddedCells) * input_conv_.out);
+
+    for (size_t i = 0; i < batch; ++i) {
+        forward_one(input + i * kInputChannels * kCells, policy + i * kActionSize, value + i, scratch.data(),
+                    codes.data());
+    }
+}
+
+void NativeNetwork::forward_one(const float* input, float* policy, float* value, float* scratch, uint8_t* codes,
+                                std::vector<float>* inputs) const {
+    const int channels = input_conv_.out;
+    float* planes = scratch;
+    float* x = planes + kPaddedCells * kInputChannels;
+    float* t = x + kPaddedCells * channels;
+    float* y = t + kPaddedCells * channels;
+
+    // Channel-major input to padded cell-major
+    for (int c = 0; c < kInputChannels; ++c) {
+        for (int cell = 0; cell < kCells; ++cell) {
+            planes[padded(cell) * kInputChannels + c] = input[c * kCells + cell];
+        }
+    }
+
+    // Calibration: running maximum of the input of trunk convolution `layer`
+    const auto record = [inputs](size_t layer, const float* in, int size) {
+        if (inputs) {
+            (*inputs)[layer] = std::max((*inputs)[layer], *std::max_element(in, in + kPaddedCells * size));
+        }
+    };
+
+    if (quantized_) {
+        conv3x3(quantized_input_conv_, planes, codes, nullptr, x);
+        for (const auto& block : quantized_blocks_) {
+            conv3x3(block.conv1, x, codes, nullptr, t);
+            conv3x3(block.conv2, t, codes, x, y);
+            std::swap(x, y);
+        }
+    } else {
+        record(0, planes, kInputChannels);
+        conv3x3(input_conv_, planes, nullptr, x);
+        for (size_t i = 0; i < blocks_.size(); ++i) {
+            record(1 + 2 * i, x, channels);
+            conv3x3(blocks_[i].conv1, x, nullptr, t);
+            record(2 + 2 * i, t, channels);
+            conv3x3(blocks_[i].conv2, t, x, y);
+            std::swap(x, y);
+        }
+    }
+
+    heads(x, policy, value, y + kPaddedCells * channels);
+}
+
+void NativeNetwork::heads(const float* trunk, float* policy, float* value, float* scratch) const {
+    float* p = scratch;
+    float* v = p + kCells * policy_conv_.out;
+    float* h = v + kCells * value_conv_.out;
+    float* out = h + value_fc1_.out;
+
+    conv1x1(policy_conv_, trunk, p);
+    dense(policy_fc_, p, false, policy);
+
+    conv1x1(value_conv_, trunk, v);
+    dense(value_fc1_, v, true, h);
+    dense(value_fc2_, h, false, out);
+    *value = std::tanh(*out);
+}
+
+int NativeNetwork::padded(int cell) {
+    return (cell / kBoardSize + 1) * kPaddedSize + cell % kBoardSize + 1;
+}
+
+void NativeNetwork::conv3x3(const Layer& layer, const float* in, const float* residual, float* out) const {
+    const Kernel kernel = kernel_of(isa_);
+    const size_t matrix = static_cast<size_t>(layer.in) * layer.out;
+
+    // One board row per call; tap (kr, kc) of cell (row, col) is padded cell (row + kr, col + kc)
+    for (int row = 0; row < kBoardSize; ++row) {
+        Taps taps;
+        taps.count = 9;
+        taps.cells = kBoardSize;
+        taps.stride = layer.in;
+        for (int tap = 0; tap < taps.count; ++tap) {
+            taps.x[tap] = in + ((row + tap / 3) * kPaddedSize + tap % 3) * layer.in;
+            taps.w[tap] = layer.weights.data() + tap * matrix;
+        }
+        const int first = padded(row * kBoardSize) * layer.out;
+        kernel(taps, layer.in, layer.out, layer.bias.data(), residual ? residual + first : nullptr, true, out + first);
+    }
+}
+
+void NativeNetwork::conv3x3(const QuantizedLayer& layer, const float* in, uint8_t* codes, const float* residual,
+                            float* out) const {
+    // Whole padded board, so the border codes are zero whatever the previous layer's width
+    const float inverse = 1.0f / layer.input_scale;
+    for (int i = 0; i < kPaddedCells * layer.in; ++i) {
+        codes[i] = static_cast<uint8_t>(std::min(in[i] * inverse, 127.0f) + 0.5f);
+    }
+
+    const QuantizedKernel kernel = quantized_kernel_of(quantized_isa_);
+    const size_t matrix = static_cast<size_t>(layer.in) * layer.out;
+    for (int row = 0; row < kBoardSize; ++row) {
+        QuantizedTaps taps;
+        taps.count = 9;
+        taps.cells = kBoardSize;
+        taps.stride = layer.in;
+        for (int tap = 0; tap < taps.count; ++tap) {
+            taps.x[tap] = codes + ((row + tap / 3) * kPaddedSize + tap % 3) * layer.in;
+            taps.w[tap] = layer.weights.data() + tap * matrix;
+        }
+        const int first = padded(row * kBoardSize) * layer.out;
+        kernel(taps, layer.in, layer.out, layer.scale.data(), layer.bias.data(), residual ? residual + first : nullptr,
+               out + first);
+    }
+}
+
+void NativeNetwork::conv1x1(const Layer& layer, const float* in, float* out) const {
+    const Kernel kernel = kernel_of(isa_);
+    for (int row = 0; row < kBoardSize; ++row) {
+        Taps taps;
+        taps.count = 1;
+        taps.cells = kBoardSize;
+        taps.stride = layer.in;
+        taps.x[0] = in + padded(row * kBoardSize) * layer.in;
+        taps.w[0] = layer.weights.data();
+        kernel(taps, layer.in, layer.out, layer.bias.data(), nullptr, true, out + row * kBoardSize * layer.out);
+    }
+}
+
+void NativeNetwork::dense(const Layer& layer, const float* in, bool relu, float* out) const {
+    Taps taps;
+    taps.count = 1;
+    taps.x[0] = in;
+    taps.w[0] = layer.weights.data();
+    kernel_of(isa_)(taps, layer.in, layer.out, layer.bias.data(), nullptr, relu, out);
+}
+
+}  // namespace neutron_rl
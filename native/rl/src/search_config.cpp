@@ -0,0 +1,42 @@
+#include "neutron_rl/search_config.hpp"
+
+#include <algorithm>
+#include <cctype>
+
+namespace neutron_rl {
+
+// DifficultyConfig implementation
+
+DifficultyConfig DifficultyConfig::from_preset(Difficulty difficulty) {
+    switch (difficulty) {
+        case Difficulty::Easy:
+            return {100, 0.5f};
+        case Difficulty::Medium:
+            return {300, 0.2f};
+        case Difficulty::Hard:
+        default:
+            return {800, 0.0f};
+    }
+}
+
+DifficultyConfig DifficultyConfig::from_simulations(int simulations, float temperature) {
+    return {simulations, temperature};
+}
+
+std::optional<DifficultyConfig> DifficultyConfig::from_name(const std::string& difficulty_name) {
+    std::string lower_name = difficulty_name;
+    std::transform(lower_name.begin(), lower_name.end(), lower_name.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+
+    if (lower_name == "easy") {
+        return from_preset(Difficulty::Easy);
+    } else if (lower_name == "medium") {
+        return from_preset(Difficulty::Medium);
+    } else if (lower_name == "hard") {
+        return from_preset(Difficulty::Hard);
+    }
+
+    return std::nullopt;
+}
+
+}  // namespace neutron_rl
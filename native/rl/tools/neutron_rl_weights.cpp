@@ -0,0 +1,327 @@
+// Weights of the RL network for NativeNetwork, the libtorch-free backend of ModelLoader.
+//
+//   neutron_rl_weights export <model.pt> <model.bin>
+//       Writes the float parameters and buffers of a TorchScript model as a weights file
+//       (format in native_network.hpp).
+//   neutron_rl_weights check <model.pt> <model.bin> [positions]
+//       Runs both through ModelLoader on positions from random games: largest policy and value
+//       differences, then forward latency at batch 1 and 32 for each.
+//   neutron_rl_weights int8 <model.bin> [games] [simulations]
+//       INT8 against FP32 on the same weights: policy and value agreement on positions from random
+//       games, forward latency at batch 1 and 32, and a match at equal search time (INT8 gets the
+//       simulations it runs in the time FP32 runs `simulations`).
+//
+// export and check need libtorch; int8 does not.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifndef NEUTRON_RL_NO_TORCH
+#include <torch/script.h>
+#endif
+
+#include "neutron_rl/eval_cache.hpp"
+#include "neutron_rl/game_state.hpp"
+#include "neutron_rl/mcts.hpp"
+#include "neutron_rl/model_loader.hpp"
+#include "neutron_rl/native_network.hpp"
+
+using namespace neutron_rl;
+
+namespace {
+
+constexpr uint32_t kVersion = 1;
+
+// Match: plies before a game counts as a draw, random plies opening each pair of games
+constexpr int kMaxPlies = 300;
+constexpr int kOpeningPlies = 4;
+
+#ifndef NEUTRON_RL_NO_TORCH
+
+void write_u32(std::ofstream& out, uint32_t value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void export_weights(const std::string& model_path, const std::string& weights_path) {
+    auto module = torch::jit::load(model_path, torch::kCPU);
+
+    std::vector<std::pair<std::string, torch::Tensor>> tensors;
+    for (const auto& parameter : module.named_parameters()) {
+        tensors.emplace_back(parameter.name, parameter.value);
+    }
+    for (const auto& buffer : module.named_buffers()) {
+        // num_batches_tracked and the like: training state, not weights
+        if (buffer.value.scalar_type() == torch::kFloat) {
+            tensors.emplace_back(buffer.name, buffer.value);
+        }
+    }
+
+    // The network may sit under a wrapper ("net.input_conv.weight"): names start at the network
+    std::string prefix;
+    for (const auto& [name, tensor] : tensors) {
+        const std::string first = "input_conv.weight";
+        if (name.size() >= first.size() && name.compare(name.size() - first.size(), first.size(), first) == 0) {
+            prefix = name.substr(0, name.size() - first.size());
+        }
+    }
+
+    std::ofstream out(weights_path, std::ios::binary);
+    if (!out) {
+        throw std::runtime_error("Cannot write " + weights_path);
+    }
+    out.write("NRLW", 4);
+    write_u32(out, kVersion);
+    write_u32(out, static_cast<uint32_t>(tensors.size()));
+    for (const auto& [full_name, tensor] : tensors) {
+        const std::string name = full_name.rfind(prefix, 0) == 0 ? full_name.substr(prefix.size()) : full_name;
+        const auto values = tensor.detach().to(torch::kFloat).contiguous();
+
+        write_u32(out, static_cast<uint32_t>(name.size()));
+        out.write(name.data(), static_cast<std::streamsize>(name.size()));
+        write_u32(out, static_cast<uint32_t>(values.dim()));
+        for (const auto size : values.sizes()) {
+            write_u32(out, static_cast<uint32_t>(size));
+        }
+        out.write(reinterpret_cast<const char*>(values.data_ptr<float>()),
+                  static_cast<std::streamsize>(values.numel() * sizeof(float)));
+    }
+    if (!out) {
+        throw std::runtime_error("Cannot write " + weights_path);
+    }
+
+    // Loading validates names and shapes
+    NativeNetwork::load(weights_path);
+    std::printf("%zu tensors -> %s\n", tensors.size(), weights_path.c_str());
+}
+
+#endif
+
+// Positions of random games from the start
+std::vector<GameState> random_states(size_t count) {
+    std::mt19937 rng(1);
+    std::vector<GameState> states;
+    while (states.size() < count) {
+        GameState state;
+        while (!state.is_terminal() && states.size() < count) {
+            states.push_back(state);
+            const auto actions = state.get_legal_actions();
+            state = state.apply_action(actions[rng() % actions.size()]);
+        }
+    }
+    return states;
+}
+
+// Mean microseconds of a forward pass over the first `batch` positions
+double latency_us(const ModelLoader& loader, const std::vector<std::vector<float>>& positions, size_t batch) {
+    const std::vector<std::vector<float>> inputs(positions.begin(), positions.begin() + batch);
+    loader.infer_batch(inputs);  // warm-up
+
+    const int repeats = std::max<int>(20, static_cast<int>(2000 / batch));
+    const auto started = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeats; ++i) {
+        loader.infer_batch(inputs);
+    }
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - started).count() / repeats;
+}
+
+#ifndef NEUTRON_RL_NO_TORCH
+
+std::vector<std::vector<float>> random_positions(size_t count) {
+    std::vector<std::vector<float>> positions;
+    for (const auto& state : random_states(count)) {
+        positions.push_back(state.encode());
+    }
+    return positions;
+}
+
+int check(const std::string& model_path, const std::string& weights_path, size_t count) {
+    ModelLoader torch_loader;
+    ModelLoader native_loader;
+    for (auto [loader, path] : {std::pair{&torch_loader, &model_path}, std::pair{&native_loader, &weights_path}}) {
+        if (!loader->load(*path)) {
+            std::fprintf(stderr, "%s\n", loader->get_error_message().c_str());
+            return 1;
+        }
+    }
+
+    const auto positions = random_positions(std::max<size_t>(count, 32));
+    const std::vector<std::vector<float>> checked(positions.begin(), positions.begin() + count);
+    const auto expected = torch_loader.infer_batch(checked);
+    const auto actual = native_loader.infer_batch(checked);
+
+    float policy_diff = 0.0f;
+    float value_diff = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t a = 0; a < expected[i].policy_logits.size(); ++a) {
+            policy_diff = std::max(policy_diff, std::abs(expected[i].policy_logits[a] - actual[i].policy_logits[a]));
+        }
+        value_diff = std::max(value_diff, std::abs(expected[i].value - actual[i].value));
+    }
+    std::printf("%zu positions: max |policy logit diff| %.3g, max |value diff| %.3g\n", count, policy_diff,
+                value_diff);
+
+    const auto isa = NativeNetwork::isa_name(NativeNetwork::preferred_isa());
+    for (const size_t batch : {size_t{1}, size_t{32}}) {
+        std::printf("batch %2zu: libtorch %8.1f us, native (%s) %8.1f us\n", batch,
+                    latency_us(torch_loader, positions, batch), isa, latency_us(native_loader, positions, batch));
+    }
+    return 0;
+}
+
+#endif
+
+// Mean milliseconds of a search of `simulations` over the first positions of `states`
+double search_ms(const ModelLoader& loader, const std::vector<GameState>& states, int simulations) {
+    constexpr size_t kSearches = 16;
+    MCTSConfig config;
+    config.num_simulations = simulations;
+    MCTS mcts(loader, config);
+
+    const auto started = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < kSearches; ++i) {
+        mcts.search(states[i * states.size() / kSearches]);
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count() / kSearches;
+}
+
+// Winner of one game (0 = draw) between the searches of players 1 and 2, after `opening` random plies
+int play(MCTS& first, MCTS& second, std::mt19937& rng, int opening) {
+    GameState state;
+    for (int ply = 0; ply < kMaxPlies && !state.is_terminal(); ++ply) {
+        int action;
+        if (ply < opening) {
+            const auto actions = state.get_legal_actions();
+            action = actions[rng() % actions.size()];
+        } else {
+            action = (state.current_player() == 1 ? first : second).search(state);
+        }
+        state = state.apply_action(action);
+    }
+    return state.get_winner().value_or(0);
+}
+
+int int8(const std::string& weights_path, int games, int simulations) {
+    ModelLoader fp32;
+    ModelLoader int8;
+    if (!fp32.load(weights_path)) {
+        std::fprintf(stderr, "%s\n", fp32.get_error_message().c_str());
+        return 1;
+    }
+    const auto load_started = std::chrono::steady_clock::now();
+    if (!int8.load(weights_path, InferencePrecision::Int8)) {
+        std::fprintf(stderr, "%s\n", int8.get_error_message().c_str());
+        return 1;
+    }
+    std::printf("INT8 load with calibration: %.0f ms\n",
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - load_started).count());
+
+    // Agreement: softmax over the legal actions, as searches see it
+    constexpr size_t kPositions = 2048;
+    const auto states = random_states(kPositions);
+    std::vector<std::vector<float>> positions;
+    for (const auto& state : states) {
+        positions.push_back(state.encode());
+    }
+    const auto expected = fp32.infer_batch(positions);
+    const auto actual = int8.infer_batch(positions);
+
+    size_t same_best = 0;
+    double variation = 0.0;
+    double value_diff = 0.0;
+    double max_value_diff = 0.0;
+    for (size_t i = 0; i < kPositions; ++i) {
+        const auto a = Evaluation::from_logits(states[i], expected[i].policy_logits, expected[i].value);
+        const auto b = Evaluation::from_logits(states[i], actual[i].policy_logits, actual[i].value);
+        same_best += std::max_element(a.priors.begin(), a.priors.begin() + a.num_actions) - a.priors.begin() ==
+                     std::max_element(b.priors.begin(), b.priors.begin() + b.num_actions) - b.priors.begin();
+        for (int k = 0; k < a.num_actions; ++k) {
+            variation += std::abs(a.priors[k] - b.priors[k]) / 2.0;
+        }
+        value_diff += std::abs(a.value - b.value);
+        max_value_diff = std::max<double>(max_value_diff, std::abs(a.value - b.value));
+    }
+    std::printf("%zu positions: same best move %.1f%%, mean policy total variation %.4f, value diff mean %.4f max %.4f\n",
+                kPositions, 100.0 * same_best / kPositions, variation / kPositions, value_diff / kPositions,
+                max_value_diff);
+
+    const auto isa = NativeNetwork::isa_name(NativeNetwork::preferred_isa());
+    for (const size_t batch : {size_t{1}, size_t{32}}) {
+        std::printf("batch %2zu (%s): FP32 %8.1f us, INT8 %8.1f us\n", batch, isa, latency_us(fp32, positions, batch),
+                    latency_us(int8, positions, batch));
+    }
+
+    // Equal time: INT8 runs as many more simulations as it is faster per search
+    const double fp32_ms = search_ms(fp32, states, simulations);
+    const double int8_ms = search_ms(int8, states, simulations);
+    const int int8_simulations = static_cast<int>(simulations * fp32_ms / int8_ms);
+    std::printf("search of %d simulations: FP32 %.1f ms, INT8 %.1f ms; match FP32 %d vs INT8 %d simulations\n",
+                simulations, fp32_ms, int8_ms, simulations, int8_simulations);
+
+    MCTSConfig fp32_config;
+    fp32_config.num_simulations = simulations;
+    MCTSConfig int8_config;
+    int8_config.num_simulations = int8_simulations;
+    MCTS fp32_search(fp32, fp32_config);
+    MCTS int8_search(int8, int8_config);
+
+    // Pairs of games from the same random opening, INT8 first in one and second in the other
+    std::mt19937 rng(7);
+    int wins = 0;
+    int losses = 0;
+    for (int game = 0; game < games; ++game) {
+        const bool int8_first = game % 2 == 0;
+        std::mt19937 opening(rng() * (game / 2 + 1));
+        const int winner = int8_first ? play(int8_search, fp32_search, opening, kOpeningPlies)
+                                      : play(fp32_search, int8_search, opening, kOpeningPlies);
+        if (winner != 0) {
+            ((winner == 1) == int8_first ? wins : losses) += 1;
+        }
+    }
+    std::printf("%d games: INT8 %d wins, %d losses, %d draws\n", games, wins, losses, games - wins - losses);
+    return 0;
+}
+
+int usage() {
+    std::fprintf(stderr,
+                 "usage: neutron_rl_weights export <model.pt> <model.bin>\n"
+                 "       neutron_rl_weights check <model.pt> <model.bin> [positions]\n"
+                 "       neutron_rl_weights int8 <model.bin> [games] [simulations]\n");
+    return 2;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        return usage();
+    }
+
+    const std::string command = argv[1];
+    try {
+        if (command == "int8" && argc <= 5) {
+            return int8(argv[2], argc >= 4 ? std::atoi(argv[3]) : 40, argc == 5 ? std::atoi(argv[4]) : 200);
+        }
+#ifndef NEUTRON_RL_NO_TORCH
+        if (command == "export" && argc == 4) {
+            export_weights(argv[2], argv[3]);
+            return 0;
+        }
+        if (command == "check" && argc >= 4 && argc <= 5) {
+            return check(argv[2], argv[3], argc == 5 ? std::strtoul(argv[4], nullptr, 10) : 256);
+        }
+#endif
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    return usage();
+}
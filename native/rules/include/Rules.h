@@ -0,0 +1,300 @@
+/**
+ * Authors:
+ * Rigoberto Leander Salgado Reyes <rlsalgado2006@gmail.com>
+ *
+ * Copyright 2025 by Rigoberto Leander Salgado Reyes.
+ *
+ * This program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ */
+
+#pragma once
+
+#include <PieceKind.h>
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Game rules on the game's own board: 25 cells, column-major (index = col * 5 + row), values as
+ * in PieceKind. Highlighted cells (SBLACK..SNEUTRON) count as their plain kind, so the board
+ * the frontend renders can be passed as is. Nothing here allocates.
+ *
+ * Same rules as engine.ts: a piece slides in one of 8 directions until the next cell is not
+ * empty. The neutron on row 0 wins for BLACK, on row 4 for WHITE, and a neutron with no moves
+ * left wins for the player who just moved.
+ *
+ * Header-only and constexpr: the minimax addon (Board, TranspositionTable, the rules API) and the
+ * RL engine (neutron_rl::GameState) both build on it, so there is one board, one move generator,
+ * one hash and one terminal test. The low-level functions (find, distance, slides, outcome) take
+ * plain cells; targets, winner, turns and valid accept highlighted ones.
+ */
+namespace rules {
+
+using Cells = std::array<uint8_t, 25>;
+
+// Cell index of a turn that has no pawn move (the neutron move ended the game).
+constexpr int kNone = -1;
+
+// Neutron destination, then the pawn move; pawnFrom/pawnTo are kNone when the neutron ends the game.
+struct Turn {
+    int neutronTo;
+    int pawnFrom;
+    int pawnTo;
+};
+
+// Longest possible list: 8 neutron moves x 5 pawns x 8 directions.
+constexpr size_t kMaxTurns = 8 * 5 * 8;
+
+constexpr auto kCell = static_cast<uint8_t>(PieceKind::CELL);
+constexpr auto kNeutron = static_cast<uint8_t>(PieceKind::NEUTRON);
+
+// Directions in the order of the RL action space: N, NE, E, SE, S, SW, W, NW (N = row - 1).
+constexpr int kDirections = 8;
+constexpr std::array<int, kDirections> kRowDelta = {-1, -1, 0, 1, 1, 1, 0, -1};
+constexpr std::array<int, kDirections> kColDelta = {0, 1, 1, 1, 0, -1, -1, -1};
+
+// Cells a slide crosses, nearest first, until the edge of the board.
+struct Ray {
+    uint8_t length;
+    std::array<uint8_t, 4> cells;
+};
+
+constexpr std::array<std::array<Ray, kDirections>, 25> makeRays() {
+    std::array<std::array<Ray, kDirections>, 25> rays{};
+    for (int index = 0; index < 25; index++) {
+        for (int dir = 0; dir < kDirections; dir++) {
+            auto &ray = rays[index][dir];
+            for (int r = index % 5 + kRowDelta[dir], c = index / 5 + kColDelta[dir]; r >= 0 && r < 5 && c >= 0 && c < 5;
+                 r += kRowDelta[dir], c += kColDelta[dir]) {
+                ray.cells[ray.length++] = static_cast<uint8_t>(c * 5 + r);
+            }
+        }
+    }
+    return rays;
+}
+
+inline constexpr auto kRays = makeRays();
+
+// Same rays as bitmasks over the cells, for distance() on an occupancy mask.
+constexpr std::array<std::array<uint32_t, kDirections>, 25> makeRayMasks() {
+    std::array<std::array<uint32_t, kDirections>, 25> masks{};
+    for (int index = 0; index < 25; index++) {
+        for (int dir = 0; dir < kDirections; dir++) {
+            const auto &ray = kRays[index][dir];
+            for (int k = 0; k < ray.length; k++) masks[index][dir] |= uint32_t{1} << ray.cells[k];
+        }
+    }
+    return masks;
+}
+
+inline constexpr auto kRayMasks = makeRayMasks();
+
+// Steps from a cell to another (king moves), the position of the second along a ray through both.
+// Columns are cells + 1; the first and last, reached when a ray has no occupied cell, are past
+// any ray.
+constexpr std::array<std::array<uint8_t, 27>, 25> makeSteps() {
+    std::array<std::array<uint8_t, 27>, 25> steps{};
+    for (int a = 0; a < 25; a++) {
+        steps[a][0] = steps[a][26] = 5;
+        for (int b = 0; b < 25; b++) {
+            const int rows = a % 5 > b % 5 ? a % 5 - b % 5 : b % 5 - a % 5;
+            const int cols = a / 5 > b / 5 ? a / 5 - b / 5 : b / 5 - a / 5;
+            steps[a][b + 1] = static_cast<uint8_t>(rows > cols ? rows : cols);
+        }
+    }
+    return steps;
+}
+
+inline constexpr auto kSteps = makeSteps();
+
+// Plain kind of a possibly highlighted cell.
+constexpr uint8_t plain(const uint8_t cell) {
+    switch (static_cast<PieceKind>(cell)) {
+        case PieceKind::SBLACK:
+            return static_cast<uint8_t>(PieceKind::BLACK);
+        case PieceKind::SWHITE:
+            return static_cast<uint8_t>(PieceKind::WHITE);
+        case PieceKind::SCELL:
+            return static_cast<uint8_t>(PieceKind::CELL);
+        case PieceKind::SNEUTRON:
+            return static_cast<uint8_t>(PieceKind::NEUTRON);
+        default:
+            return cell;
+    }
+}
+
+constexpr Cells plainCells(const Cells &board) {
+    Cells cells{};
+    for (size_t i = 0; i < cells.size(); i++) cells[i] = plain(board[i]);
+    return cells;
+}
+
+constexpr bool inside(const int index) {
+    return index >= 0 && index < 25;
+}
+
+// First cell holding `kind`, or kNone.
+constexpr int find(const Cells &cells, const uint8_t kind) {
+    for (int i = 0; i < static_cast<int>(cells.size()); i++) {
+        if (cells[i] == kind)
+            return i;
+    }
+    return kNone;
+}
+
+// Cells the piece on `index` slides towards `dir` (0 when blocked); it stops at
+// kRays[index][dir].cells[distance - 1].
+constexpr int distance(const Cells &cells, const int index, const int dir) {
+    const auto &ray = kRays[index][dir];
+    int length = 0;
+    while (length < ray.length && cells[ray.cells[length]] == kCell) length++;
+    return length;
+}
+
+// Bit i set when cell i holds a piece (plain cells).
+constexpr uint32_t occupancy(const Cells &cells) {
+    uint32_t occupied = 0;
+    for (size_t i = 0; i < cells.size(); i++) {
+        if (cells[i] != kCell)
+            occupied |= uint32_t{1} << i;
+    }
+    return occupied;
+}
+
+// distance() from an occupancy mask, without walking the ray or branching: up to its nearest
+// occupied cell, the lowest one when the ray goes towards higher indices and the highest otherwise.
+constexpr int distance(const uint32_t occupied, const int index, const int dir) {
+    const auto &ray = kRays[index][dir];
+    const uint32_t blockers = occupied & kRayMasks[index][dir];
+    const int column = ray.cells[0] > index ? std::countr_zero(blockers | uint32_t{1} << 25) + 1 : std::bit_width(blockers);
+    const int length = kSteps[index][column] - 1;
+    return length < ray.length ? length : ray.length;
+}
+
+// Destinations of the piece on `index`: bit i set when it can slide to cell i.
+constexpr uint32_t slides(const Cells &cells, const int index) {
+    uint32_t mask = 0;
+    for (int dir = 0; dir < kDirections; dir++) {
+        if (const int length = distance(cells, index, dir))
+            mask |= uint32_t{1} << kRays[index][dir].cells[length - 1];
+    }
+    return mask;
+}
+
+// Winner (BLACK or WHITE) once `mover` has moved the neutron, or CELL while the game goes on.
+constexpr PieceKind outcome(const Cells &cells, const PieceKind mover) {
+    const int neutron = find(cells, kNeutron);
+    if (neutron == kNone)
+        return PieceKind::CELL;
+
+    if (!slides(cells, neutron))
+        return mover;
+    if (neutron % 5 == 0)
+        return PieceKind::BLACK;
+    if (neutron % 5 == 4)
+        return PieceKind::WHITE;
+    return PieceKind::CELL;
+}
+
+constexpr uint32_t targets(const Cells &board, const int index) {
+    if (!inside(index))
+        return 0;
+    return slides(plainCells(board), index);
+}
+
+constexpr PieceKind winner(const Cells &board, const PieceKind mover) {
+    return outcome(plainCells(board), mover);
+}
+
+// Every legal turn of `player`; writes at most kMaxTurns and returns how many there are.
+constexpr size_t turns(const Cells &board, const PieceKind player, Turn *out) {
+    auto cells = plainCells(board);
+    const int neutron = find(cells, kNeutron);
+    if (neutron == kNone)
+        return 0;
+
+    size_t count = 0;
+    for (auto neutronMoves = slides(cells, neutron); neutronMoves; neutronMoves &= neutronMoves - 1) {
+        const int neutronTo = std::countr_zero(neutronMoves);
+        cells[neutron] = kCell;
+        cells[neutronTo] = kNeutron;
+
+        if (outcome(cells, player) != PieceKind::CELL) {
+            out[count++] = {neutronTo, kNone, kNone};
+        } else {
+            for (int pawn = 0; pawn < static_cast<int>(cells.size()); pawn++) {
+                if (cells[pawn] != static_cast<uint8_t>(player))
+                    continue;
+                for (auto pawnMoves = slides(cells, pawn); pawnMoves; pawnMoves &= pawnMoves - 1) {
+                    out[count++] = {neutronTo, pawn, std::countr_zero(pawnMoves)};
+                }
+            }
+        }
+
+        cells[neutronTo] = kCell;
+        cells[neutron] = kNeutron;
+    }
+    return count;
+}
+
+// True when (neutronFrom, neutronTo, pawnFrom, pawnTo) is a legal turn of `player`.
+constexpr bool valid(const Cells &board,
+                     const PieceKind player,
+                     const int neutronFrom,
+                     const int neutronTo,
+                     const int pawnFrom,
+                     const int pawnTo) {
+    auto cells = plainCells(board);
+    if (!inside(neutronFrom) || !inside(neutronTo) || cells[neutronFrom] != kNeutron ||
+        !(slides(cells, neutronFrom) >> neutronTo & 1))
+        return false;
+
+    cells[neutronFrom] = kCell;
+    cells[neutronTo] = kNeutron;
+
+    // si el neutrón ya decide la partida no hay jugada de peón.
+    if (outcome(cells, player) != PieceKind::CELL)
+        return pawnFrom == kNone && pawnTo == kNone;
+
+    return inside(pawnFrom) && inside(pawnTo) && cells[pawnFrom] == static_cast<uint8_t>(player) &&
+           (slides(cells, pawnFrom) >> pawnTo & 1);
+}
+
+constexpr uint64_t splitmix64(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ull;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+// 9 valores por casilla: PieceKind llega hasta SNEUTRON = 8.
+constexpr size_t kKinds = 9;
+
+constexpr std::array<uint64_t, 25 * kKinds> makeZobrist() {
+    std::array<uint64_t, 25 * kKinds> keys{};
+    for (size_t i = 0; i < keys.size(); i++) keys[i] = splitmix64(i + 1);
+    return keys;
+}
+
+inline constexpr auto kZobrist = makeZobrist();
+
+// Zobrist hash of the cells as given (a highlighted cell hashes apart from its plain kind).
+constexpr uint64_t hash(const Cells &board) {
+    uint64_t hash = 0;
+    for (size_t i = 0; i < board.size(); i++) hash ^= kZobrist[i * kKinds + board[i] % kKinds];
+    return hash;
+}
+
+// Sanity checks the compiler runs once for every user of the header.
+static_assert(kRays[12][0].length == 2 && kRays[12][0].cells[0] == 11 && kRays[12][0].cells[1] == 10);
+static_assert(kRays[0][2].length == 4 && kRays[0][2].cells[3] == 20);
+static_assert(distance(occupancy(plainCells({1, 4, 4, 4, 2, 1, 4, 4, 4, 2, 1, 4, 3, 4, 2, 1, 4, 4, 4, 2, 1, 4, 4, 4, 2})), 12, 0) == 1);
+static_assert(distance(occupancy(plainCells({1, 4, 4, 4, 2, 1, 4, 4, 4, 2, 1, 4, 3, 4, 2, 1, 4, 4, 4, 2, 1, 4, 4, 4, 2})), 12, 2) == 2);
+
+}  // namespace rules
@@ -0,0 +1,92 @@
+/**
+ * Authors:
+ * Rigoberto Leander Salgado Reyes <rlsalgado2006@gmail.com>
+ *
+ * Copyright 2025 by Rigoberto Leander Salgado Reyes.
+ *
+ * This program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ */
+
+#include <AdmissionControl.h>
+
+#include <algorithm>
+
+void AdmissionControl::configure(const Options& poptions, const unsigned pthreads) {
+    std::lock_guard lock(mutex);
+    options = poptions;
+    threads = std::max(1u, pthreads);
+}
+
+bool AdmissionControl::active() const {
+    std::lock_guard lock(mutex);
+    return options.policy != Policy::Off && options.slo.count() > 0;
+}
+
+std::optional<AdmissionControl::Ticket> AdmissionControl::admit(const std::vector<Level>& levels) {
+    if (levels.empty())
+        return std::nullopt;
+
+    std::lock_guard lock(mutex);
+
+    const auto reserve = [&](const size_t index) {
+        const auto expected = estimateLocked(levels[index].key, levels[index].seed);
+        inflight += expected;
+        return Ticket{index, levels[index].key, expected};
+    };
+
+    if (options.policy == Policy::Off || options.slo.count() <= 0)
+        return reserve(0);
+
+    // Una búsqueda no se reparte entre hilos: su propio coste también tiene que caber en el SLO.
+    // Con el pool vacío, una clase aún sin mediciones pasa igualmente, para que llegue a medirse.
+    const bool idle = inflight.count() == 0;
+    const auto fits = [&](const Level& level) {
+        if (idle && !costs.contains(level.key))
+            return true;
+        const auto own = estimateLocked(level.key, level.seed);
+        return own <= options.slo && (inflight + own) / threads <= options.slo;
+    };
+
+    // Rechazar sin nada en vuelo no alivia ninguna carga.
+    if (options.policy == Policy::Reject)
+        return idle || fits(levels.front()) ? std::optional(reserve(0)) : std::nullopt;
+
+    // Downgrade: el primer nivel que cabe; si ninguno cabe, el más barato.
+    for (size_t i = 0; i < levels.size(); i++) {
+        if (fits(levels[i]))
+            return reserve(i);
+    }
+    return reserve(levels.size() - 1);
+}
+
+void AdmissionControl::complete(const Ticket& ticket, const Micros actual) {
+    std::lock_guard lock(mutex);
+    inflight = std::max(Micros{0}, inflight - ticket.expected);
+
+    const auto sample = static_cast<double>(actual.count());
+    const auto found = costs.find(ticket.key);
+    if (found == costs.end()) {
+        costs.emplace(ticket.key, sample);
+    } else {
+        found->second += options.smoothing * (sample - found->second);
+    }
+}
+
+AdmissionControl::Micros AdmissionControl::estimate(const std::string& key, const Micros seed) const {
+    std::lock_guard lock(mutex);
+    return estimateLocked(key, seed);
+}
+
+AdmissionControl::Micros AdmissionControl::expectedWait() const {
+    std::lock_guard lock(mutex);
+    return inflight / threads;
+}
+
+AdmissionControl::Micros AdmissionControl::estimateLocked(const std::string& key, const Micros seed) const {
+    const auto found = costs.find(key);
+    return found == costs.end() ? seed : Micros(static_cast<Micros::rep>(found->second));
+}
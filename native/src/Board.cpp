@@ -15,6 +15,7 @@
 
 #include <Board.h>
 #include <PieceKind.h>
+#include <Rules.h>
 #include <cleaners.h>
 
 #include <algorithm>
@@ -28,18 +29,10 @@ Board::Board(const std::array<uint8_t, 25> &ptable) : table(ptable) {
 Board::~Board() = default;
 
 std::unique_ptr<Move> Board::findNeutron() const {
-    int index = 0;
-    for (const auto cell : this->table) {
-        const int col = index / 5;
-        const int row = index % 5;
-        if (cell == static_cast<uint8_t>(PieceKind::NEUTRON)) {
-            return std::make_unique<Move>(row, col, PieceKind::NEUTRON);
-        }
-
-        index++;
-    }
-
-    return nullptr;
+    const int index = rules::find(this->table, rules::kNeutron);
+    if (index == rules::kNone)
+        return nullptr;
+    return std::make_unique<Move>(index % 5, index / 5, PieceKind::NEUTRON);
 }
 
 std::vector<std::unique_ptr<Move>> Board::findPieces(PieceKind pieceKind) const {
@@ -60,81 +53,27 @@ std::vector<std::unique_ptr<Move>> Board::findPieces(PieceKind pieceKind) const
     return pos;
 }
 
-int Board::getRowMove(const Direction direction) {
-    switch (direction) {
-        case Direction::NORTH:
-        case Direction::NORTHEAST:
-        case Direction::NORTHWEST:
-            return -1;
-        case Direction::SOUTH:
-        case Direction::SOUTHEAST:
-        case Direction::SOUTHWEST:
-            return 1;
-        default:
-            return 0;
-    }
-}
-
-int Board::getColMove(const Direction direction) {
-    switch (direction) {
-        case Direction::WEST:
-        case Direction::NORTHWEST:
-        case Direction::SOUTHWEST:
-            return -1;
-        case Direction::EAST:
-        case Direction::NORTHEAST:
-        case Direction::SOUTHEAST:
-            return 1;
-        default:
-            return 0;
-    }
-}
-
-PieceKind Board::elementAt(const int row, const int col) const {
-    return static_cast<PieceKind>(this->table[col * 5 + row]);
+const std::array<uint8_t, 25> &Board::cells() const {
+    return table;
 }
 
 void Board::setElementAt(const int row, const int col, PieceKind pieceKind) {
     this->table[col * 5 + row] = static_cast<uint8_t>(pieceKind);
 }
 
-bool Board::inBounds(const int value, const int inc) {
-    return value + inc >= 0 && value + inc < 5;
-}
-
-std::unique_ptr<Move> Board::_check(const int row, const int col, const int incR, const int incC) const {
-    if (!inBounds(row, incR) ||  //
-        !inBounds(col, incC) ||  //
-        elementAt(row + incR, col + incC) != PieceKind::CELL) {
-        return std::make_unique<Move>(row, col, elementAt(row, col));
-    }
-    return _check(row + incR, col + incC, incR, incC);
-}
-
-std::unique_ptr<Move> Board::checkMove(const std::unique_ptr<Move> &move, const Direction direction) const {
-    const auto tip = _check(move->row, move->col, getRowMove(direction), getColMove(direction));
-
-    if (move->row == tip->row && move->col == tip->col)
-        return nullptr;
-    return std::make_unique<Move>(tip->row, tip->col, move->kind);
-}
-
 std::vector<std::unique_ptr<Move>> Board::moves(const std::unique_ptr<Move> &startPoint) const {
     std::vector<std::unique_ptr<Move>> result;
     result.reserve(8);
 
-    constexpr Direction directions[8] = {Direction::NORTH,  //
-                                         Direction::SOUTH,  //
-                                         Direction::EAST,   //
-                                         Direction::WEST,   //
-                                         Direction::NORTHEAST,
-                                         Direction::NORTHWEST,  //
-                                         Direction::SOUTHEAST,  //
-                                         Direction::SOUTHWEST};
+    // N, S, E, W, NE, NW, SE, SW: el orden de siempre, que decide el orden de allMoves().
+    constexpr int directions[8] = {0, 4, 2, 6, 1, 7, 3, 5};
 
+    const int from = startPoint->col * 5 + startPoint->row;
     for (const auto d : directions) {
-        if (auto m = checkMove(startPoint, d))
-            result.emplace_back(std::move(m));
+        if (const int length = rules::distance(this->table, from, d)) {
+            const int to = rules::kRays[from][d].cells[length - 1];
+            result.emplace_back(std::make_unique<Move>(to % 5, to / 5, startPoint->kind));
+        }
     }
 
     return result;
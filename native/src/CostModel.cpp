@@ -0,0 +1,218 @@
+/**
+ * Authors:
+ * Rigoberto Leander Salgado Reyes <rlsalgado2006@gmail.com>
+ *
+ * Copyright 2025 by Rigoberto Leander Salgado Reyes.
+ *
+ * This program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ */
+
+#include <Board.h>
+#include <CostModel.h>
+#include <PieceKind.h>
+#include <minimax.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace {
+
+using std::chrono::microseconds;
+
+constexpr size_t kProbes = 8;                       // respuestas de WHITE muestreadas en la raíz
+constexpr double kDecay = 0.98;                     // peso de la muestra anterior en la regresión
+constexpr double kRateSmoothing = 0.2;              // EWMA de nodos/µs
+constexpr microseconds kMinRateSample{1000};        // búsquedas más cortas no miden bien el ritmo
+constexpr microseconds kCalibrationBudget{100000};
+constexpr int kCalibrationDepth = 4;
+constexpr double kMinAlpha = 0.25;
+constexpr double kMaxAlpha = 1.5;
+
+constexpr auto B = static_cast<uint8_t>(PieceKind::BLACK);
+constexpr auto W = static_cast<uint8_t>(PieceKind::WHITE);
+constexpr auto N = static_cast<uint8_t>(PieceKind::NEUTRON);
+constexpr auto C = static_cast<uint8_t>(PieceKind::CELL);
+
+// Posición inicial (getDefaultBoard en src/domain/utils.ts).
+constexpr std::array<uint8_t, 25> kStart = {
+    B, C, C, C, W,  //
+    B, C, C, C, W,  //
+    B, C, N, C, W,  //
+    B, C, C, C, W,  //
+    B, C, C, C, W   //
+};
+
+// True when `player` wins with its neutron move (allMoves then keeps only that one).
+bool wins(Board &board, const PieceKind player) {
+    const auto moves = board.allMoves(player);
+    return !moves.empty() && moves.front()->moves[1]->row == (player == PieceKind::BLACK ? 0 : 4);
+}
+
+// La inicial y dos de medio juego, deterministas para que la calibración sea reproducible. Se
+// evitan las posiciones ya decididas: su búsqueda termina en un ply y no enseña nada del árbol.
+std::vector<std::array<uint8_t, 25>> calibrationBoards() {
+    std::vector boards{kStart};
+    Board board(kStart);
+    for (const auto player : {PieceKind::BLACK, PieceKind::WHITE, PieceKind::BLACK, PieceKind::WHITE}) {
+        const auto opponent = player == PieceKind::BLACK ? PieceKind::WHITE : PieceKind::BLACK;
+        const auto moves = board.allMoves(player);
+
+        bool moved = false;
+        for (const auto &move : moves) {
+            if (move->moves[1]->row == 0 || move->moves[1]->row == 4)
+                continue;
+            board.applyFullMove(move);
+            if (!wins(board, opponent)) {
+                moved = true;
+                break;
+            }
+            board.applyFullMove(move, false);
+        }
+        if (!moved)
+            break;
+        if (player == PieceKind::WHITE)
+            boards.push_back(board.cells());
+    }
+    return boards;
+}
+
+}  // namespace
+
+CostModel& CostModel::instance() {
+    static CostModel model;
+    return model;
+}
+
+CostModel::CostModel() {
+    // a priori: alpha-beta visita ~raw^0.75 nodos, a 1 nodo/µs, hasta que haya mediciones.
+    fit(0.0, 0.0);
+    fit(10.0, 7.5);
+    samples = 0;
+}
+
+CostModel::Features CostModel::features(const std::array<uint8_t, 25>& board) {
+    Board root(board);
+    const auto moves = root.allMoves(PieceKind::BLACK);
+    if (moves.empty())
+        return {0.0, 0.0, true};
+    if (moves.front()->moves[1]->row == 0)
+        return {static_cast<double>(moves.size()), 0.0, true};
+
+    // sondeo a un ply: respuestas de WHITE tras jugadas repartidas por toda la lista.
+    const size_t probes = std::min(kProbes, moves.size());
+    double replies = 0;
+    for (size_t i = 0; i < probes; i++) {
+        const auto& move = moves[i * moves.size() / probes];
+        root.applyFullMove(move);
+        replies += static_cast<double>(root.allMoves(PieceKind::WHITE).size());
+        root.applyFullMove(move, false);
+    }
+    return {static_cast<double>(moves.size()), replies / static_cast<double>(probes), false};
+}
+
+double CostModel::logRaw(const Features& features, const int depth) {
+    double x = 0;
+    for (int ply = 0; ply < (features.decided ? std::min(depth, 1) : depth); ply++) x += std::log(std::max(1.0, ply % 2 ? features.reply : features.root));
+    return x;
+}
+
+void CostModel::fit(const double x, const double y) {
+    w = w * kDecay + 1.0;
+    wx = wx * kDecay + x;
+    wy = wy * kDecay + y;
+    wxx = wxx * kDecay + x * x;
+    wxy = wxy * kDecay + x * y;
+
+    // con todas las muestras en el mismo raw la pendiente no está determinada: se conserva.
+    const double det = w * wxx - wx * wx;
+    if (det > 1e-9 * w * w)
+        alpha = std::clamp((w * wxy - wx * wy) / det, kMinAlpha, kMaxAlpha);
+    beta = (wy - alpha * wx) / w;
+    samples++;
+}
+
+CostModel::Prediction CostModel::predictLocked(const Features& features, const int depth) const {
+    const double nodes = depth > 0 ? std::max(1.0, std::exp(alpha * logRaw(features, depth) + beta)) : 1.0;
+    return {depth, nodes, microseconds(static_cast<int64_t>(std::ceil(nodes / nodesPerMicro)))};
+}
+
+CostModel::Prediction CostModel::predict(const Features& features, const int depth) {
+    std::lock_guard lock(mutex);
+    return predictLocked(features, depth);
+}
+
+CostModel::Prediction CostModel::choose(const Features& features, const int maxDepth, const microseconds budget) {
+    calibrate();
+
+    std::lock_guard lock(mutex);
+    auto best = predictLocked(features, std::min(maxDepth, 1));
+    // el coste crece con la profundidad: la primera que no cabe corta la búsqueda.
+    for (int depth = 2; depth <= maxDepth; depth++) {
+        const auto next = predictLocked(features, depth);
+        if (next.time > budget)
+            break;
+        best = next;
+    }
+    return best;
+}
+
+void CostModel::record(const Features& features, const int depth, const uint64_t nodes, const microseconds busy) {
+    if (depth <= 0 || !nodes)
+        return;
+
+    std::lock_guard lock(mutex);
+    fit(logRaw(features, depth), std::log(static_cast<double>(nodes)));
+    if (busy >= kMinRateSample)
+        nodesPerMicro += kRateSmoothing * (static_cast<double>(nodes) / static_cast<double>(busy.count()) - nodesPerMicro);
+}
+
+CostModel::Summary CostModel::calibrate() {
+    std::call_once(calibrated, [this] {
+        using clock = std::chrono::steady_clock;
+        constexpr int lowest = std::numeric_limits<int>::min();
+        constexpr int highest = std::numeric_limits<int>::max();
+
+        const auto deadline = clock::now() + kCalibrationBudget;
+        uint64_t nodes = 0;
+        microseconds busy{0};
+
+        for (const auto& cells : calibrationBoards()) {
+            const auto f = features(cells);
+            for (int depth = 1; depth <= kCalibrationDepth; depth++) {
+                // no pasarse del presupuesto: cada profundidad se estima con lo medido hasta ahora.
+                const auto left = std::chrono::duration_cast<microseconds>(deadline - clock::now());
+                if (depth > 1 && predict(f, depth).time > left)
+                    break;
+
+                auto board = std::make_unique<Board>(cells);
+                SearchSlice slice;
+                const auto start = clock::now();
+                maxValue(slice, board, depth, lowest, highest, PieceKind::BLACK).run(slice);
+                const auto spent = std::chrono::duration_cast<microseconds>(clock::now() - start);
+
+                record(f, depth, slice.units, spent);
+                nodes += slice.units;
+                busy += spent;
+
+                // aquí el ritmo es el acumulado de la calibración, no una media móvil.
+                if (busy.count() > 0) {
+                    std::lock_guard lock(mutex);
+                    nodesPerMicro = static_cast<double>(nodes) / static_cast<double>(busy.count());
+                }
+            }
+        }
+    });
+    return summary();
+}
+
+CostModel::Summary CostModel::summary() {
+    std::lock_guard lock(mutex);
+    return {nodesPerMicro * 1e6, alpha, beta, samples};
+}
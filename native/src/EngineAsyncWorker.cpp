@@ -0,0 +1,470 @@
+/**
+ * Authors:
+ * Rigoberto Leander Salgado Reyes <rlsalgado2006@gmail.com>
+ *
+ * Copyright 2025 by Rigoberto Leander Salgado Reyes.
+ *
+ * This program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ */
+
+#include <EngineAsyncWorker.h>
+#include <napi.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <string>
+#include <utility>
+
+namespace {
+
+// El nombre lleva versión, ABI de la biblioteca estándar y tamaño: un addon compilado con otro layout de
+// EngineScheduler u otros std::string/std::list/std::function (p. ej. el de RL con TORCH_CXX_FLAGS y otro
+// _GLIBCXX_USE_CXX11_ABI) no lo adopta y se queda con su propio scheduler.
+std::string SchedulerKey() {
+    std::string key = "neutron.engine.scheduler.v5";
+#if defined(_LIBCPP_VERSION)
+    key += ".libc++" + std::to_string(_LIBCPP_ABI_VERSION);
+#elif defined(__GLIBCXX__)
+    key += ".cxx11abi" + std::to_string(_GLIBCXX_USE_CXX11_ABI);
+#endif
+#if defined(_GLIBCXX_DEBUG)
+    key += ".debug";
+#endif
+    return key + "." + std::to_string(sizeof(EngineScheduler));
+}
+
+// Por defecto como mucho ~10 avisos por segundo y búsqueda.
+constexpr std::chrono::milliseconds kDefaultProgressInterval{100};
+
+// progressIntervalMs se ajusta a este rango: por debajo de 10 ms los avisos solo cargan el event loop.
+constexpr double kMinProgressInterval = 10;
+constexpr double kMaxProgressInterval = 3600 * 1000;
+
+}  // namespace
+
+EngineAsyncWorker::EngineAsyncWorker(Napi::Env penv) : env(penv) {
+}
+
+EngineAsyncWorker::~EngineAsyncWorker() {
+    // worker descartado tras Serve() sin llegar a encolarse (p. ej. rechazado por admisión).
+    if (armed)
+        completion.Release();
+}
+
+Napi::Env EngineAsyncWorker::Env() const {
+    return env;
+}
+
+void EngineAsyncWorker::SetError(const std::string& error) {
+    std::lock_guard lock(errorMutex);
+    errorMessage = error;
+    failed = true;
+}
+
+void EngineAsyncWorker::Arm() {
+    if (!armed) {
+        completion = onProgress.IsEmpty() ? Completion::New(env, "neutron:engine", 0, 1, this)
+                                          : Completion::New(env, onProgress.Value(), "neutron:engine", 0, 1, this);
+    }
+    armed = true;
+}
+
+void EngineAsyncWorker::SetProgress(const Napi::Object& input) {
+    if (!input.Has("onProgress") || input.Get("onProgress").IsUndefined())
+        return;
+    if (!input.Get("onProgress").IsFunction())
+        throw Napi::TypeError::New(env, "onProgress must be a function");
+
+    onProgress = Napi::Persistent(input.Get("onProgress").As<Napi::Function>());
+    progressInterval = kDefaultProgressInterval;
+    if (!input.Has("progressIntervalMs") || input.Get("progressIntervalMs").IsUndefined())
+        return;
+
+    // sin Uint32Value(): -1 o NaN darían la vuelta a un intervalo de ~49 días.
+    const auto value = input.Get("progressIntervalMs");
+    const double ms = value.IsNumber() ? value.As<Napi::Number>().DoubleValue() : -1;
+    if (!std::isfinite(ms) || ms < 0)
+        throw Napi::TypeError::New(env, "progressIntervalMs must be a finite number >= 0");
+
+    progressInterval = std::chrono::milliseconds(static_cast<int64_t>(std::clamp(ms, kMinProgressInterval, kMaxProgressInterval)));
+}
+
+bool EngineAsyncWorker::WantsProgress() const {
+    return !onProgress.IsEmpty();
+}
+
+bool EngineAsyncWorker::ProgressDue() const {
+    return !onProgress.IsEmpty() && !progressPending.load(std::memory_order_acquire) &&
+           std::chrono::steady_clock::now() - lastProgress >= progressInterval;
+}
+
+void EngineAsyncWorker::EmitProgress() {
+    static constexpr Message progress = Message::Progress;
+
+    // un solo aviso en cola: si JS va atrasado se salta snapshots en vez de acumularlos.
+    lastProgress = std::chrono::steady_clock::now();
+    progressPending.store(true, std::memory_order_release);
+    if (completion.NonBlockingCall(&progress) != napi_ok)
+        progressPending.store(false, std::memory_order_release);
+}
+
+void EngineAsyncWorker::Queue(const std::chrono::microseconds slack) {
+    Arm();
+    if (!pool) {
+        Submit(slack);
+        return;
+    }
+
+    const auto enteredAt = std::chrono::steady_clock::now();
+    pool->enter([this, slack, enteredAt] {
+        if (stats)
+            stats->poolWaitMicros.record(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - enteredAt).count());
+        Submit(slack);
+    });
+}
+
+void EngineAsyncWorker::Submit(const std::chrono::microseconds slack) {
+    queuedAt = std::chrono::steady_clock::now();
+    const auto lanes = std::max(1u, Lanes());
+    lanesLeft = lanes;
+    for (unsigned lane = 0; lane < lanes; lane++) {
+        EngineScheduler::instance().submit(slack, [this, lane] { return Step(lane); });
+    }
+}
+
+bool EngineAsyncWorker::Serve(const ResultCache::Key& key, ClassStats& requested) {
+    // antes de find(): la búsqueda a la que se une puede terminar en otro hilo enseguida.
+    Arm();
+
+    ResultCache::Value value;
+    const auto outcome = EngineScheduler::instance().cache().find(key, value, [this](const ResultCache::Value* result, const std::string& error) {
+        if (result) {
+            Adopt(*result);
+        } else {
+            SetError(error);
+        }
+        Finish();
+    });
+
+    switch (outcome) {
+        case ResultCache::Outcome::Hit:
+            requested.cacheHits.fetch_add(1, std::memory_order_relaxed);
+            Adopt(value);
+            OnOK();
+            delete this;
+            return true;
+        case ResultCache::Outcome::Joined:
+            requested.coalesced.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        case ResultCache::Outcome::Miss:
+            break;
+    }
+    return false;
+}
+
+void EngineAsyncWorker::Lead(ResultCache::Key key) {
+    EngineScheduler::instance().cache().begin(key);
+    cacheKey = std::move(key);
+}
+
+void EngineAsyncWorker::SetTicket(AdmissionControl::Ticket pticket) {
+    SetClass(pticket.key);
+    ticket = std::move(pticket);
+}
+
+void EngineAsyncWorker::SetClass(const std::string& key) {
+    stats = &EngineScheduler::instance().stats().forClass(key);
+}
+
+void EngineAsyncWorker::SetPool(SearchPool& ppool) {
+    pool = &ppool;
+}
+
+Napi::Error EngineAsyncWorker::Overloaded(Napi::Env env) {
+    const auto wait = EngineScheduler::instance().admission().expectedWait();
+
+    auto error = Napi::Error::New(env, "engine overloaded, retry later");
+    auto value = error.Value();
+    value.Set("code", Napi::String::New(env, "ENGINE_OVERLOADED"));
+    value.Set("retryable", Napi::Boolean::New(env, true));
+    value.Set("retryAfterMs", Napi::Number::New(env, static_cast<double>(wait.count()) / 1000.0));
+    return error;
+}
+
+bool EngineAsyncWorker::Step(const unsigned lane) {
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+
+    const auto sliceStart = std::chrono::steady_clock::now();
+    if (stats && !started.exchange(true, std::memory_order_relaxed))
+        stats->queueWaitMicros.record(duration_cast<microseconds>(sliceStart - queuedAt).count());
+
+    ClassStats::setCurrent(stats);
+    bool done = true;
+    try {
+        done = ExecuteLane(lane);
+    } catch (const std::exception& ex) {
+        SetError(ex.what());
+    } catch (...) {
+        SetError("Unknown error in EngineAsyncWorker");
+    }
+    ClassStats::setCurrent(nullptr);
+    busyMicros.fetch_add(duration_cast<microseconds>(std::chrono::steady_clock::now() - sliceStart).count(), std::memory_order_relaxed);
+
+    if (!done)
+        return false;
+    // la última lane en terminar entrega el resultado.
+    if (lanesLeft.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        return true;
+
+    const microseconds busy(busyMicros.load(std::memory_order_relaxed));
+    if (ticket)
+        EngineScheduler::instance().admission().complete(*ticket, busy);
+    // puede arrancar aquí mismo la siguiente búsqueda en espera.
+    if (pool)
+        pool->leave();
+
+    if (stats) {
+        const auto units = WorkUnits();
+        (failed ? stats->failed : stats->completed).fetch_add(1, std::memory_order_relaxed);
+        stats->units.fetch_add(units, std::memory_order_relaxed);
+        stats->busyMicros.fetch_add(busy.count(), std::memory_order_relaxed);
+        stats->executionMicros.record(busy.count());
+        stats->unitsPerSearch.record(units);
+    }
+    if (!failed)
+        Completed(stats, WorkUnits(), busy);
+
+    if (cacheKey) {
+        const auto value = failed ? ResultCache::Value{} : CacheValue();
+        EngineScheduler::instance().cache().publish(*cacheKey, failed ? nullptr : &value, errorMessage);
+    }
+
+    Finish();
+    return true;
+}
+
+void EngineAsyncWorker::Finish() {
+    static constexpr Message done = Message::Done;
+
+    // copia local: CallJs puede borrar `this` antes de que Release() retorne.
+    auto fn = completion;
+    armed = false;
+    if (fn.BlockingCall(&done) == napi_ok) {
+        fn.Release();
+        return;
+    }
+
+    // entorno cerrándose: CallJs ya no llegará a ejecutarse, así que el worker se borra aquí.
+    if (stats)
+        stats->cancelled.fetch_add(1, std::memory_order_relaxed);
+    DropHandles();
+    delete this;
+}
+
+void EngineAsyncWorker::DropHandles() {
+    onProgress.SuppressDestruct();
+}
+
+void EngineAsyncWorker::CallJs(Napi::Env env, Napi::Function callback, EngineAsyncWorker* worker, const Message* message) {
+    if (*message == Message::Progress) {
+        if (env != nullptr) {
+            Napi::HandleScope scope(env);
+            try {
+                worker->OnProgress(env, callback);
+            } catch (const Napi::Error&) {
+                // un onProgress que lanza no debe tumbar la búsqueda; el resultado llega por la promesa.
+            }
+        }
+        worker->progressPending.store(false, std::memory_order_release);
+        return;
+    }
+
+    if (env == nullptr && worker->stats) {
+        worker->stats->cancelled.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (env != nullptr) {
+        Napi::HandleScope scope(env);
+        if (worker->failed) {
+            worker->OnError(Napi::Error::New(env, worker->errorMessage));
+        } else {
+            worker->OnOK();
+        }
+    }
+
+    delete worker;
+}
+
+void EngineAsyncWorker::Attach(Napi::Env env) {
+    const auto key = Napi::Symbol::For(env, SchedulerKey());
+    auto global = env.Global();
+
+    const auto existing = global.Get(key);
+    if (existing.IsExternal()) {
+        EngineScheduler::adopt(existing.As<Napi::External<EngineScheduler>>().Data());
+        return;
+    }
+
+    auto& scheduler = EngineScheduler::instance();
+    global.DefineProperty(Napi::PropertyDescriptor::Value(key, Napi::External<EngineScheduler>::New(env, &scheduler), napi_default));
+}
+
+Napi::Value EngineAsyncWorker::Configure(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsObject()) {
+        throw Napi::TypeError::New(env, "configureEngine(options) expects {threads?, pinThreads?, sliceNodes?, sliceSimulations?, leafBatch?, searchThreads?, inferenceBatch?, inferenceWaitUs?, evalCacheEntries?, inferencePrecision?, rlPoolSize?, sloMs?, overloadPolicy?, cacheEntries?}");
+    }
+
+    const auto input = info[0].As<Napi::Object>();
+    EngineScheduler::Options options;
+    if (input.Has("threads") && input.Get("threads").IsNumber()) {
+        options.threads = input.Get("threads").As<Napi::Number>().Uint32Value();
+    }
+    if (input.Has("pinThreads") && input.Get("pinThreads").IsBoolean()) {
+        options.pinThreads = input.Get("pinThreads").As<Napi::Boolean>().Value();
+    }
+    if (input.Has("sliceNodes") && input.Get("sliceNodes").IsNumber()) {
+        options.sliceNodes = input.Get("sliceNodes").As<Napi::Number>().Uint32Value();
+    }
+    if (input.Has("sliceSimulations") && input.Get("sliceSimulations").IsNumber()) {
+        options.sliceSimulations = input.Get("sliceSimulations").As<Napi::Number>().Uint32Value();
+    }
+    if (input.Has("leafBatch") && input.Get("leafBatch").IsNumber()) {
+        options.leafBatch = std::max(1u, input.Get("leafBatch").As<Napi::Number>().Uint32Value());
+    }
+    if (input.Has("searchThreads") && input.Get("searchThreads").IsNumber()) {
+        options.searchThreads = std::clamp(input.Get("searchThreads").As<Napi::Number>().Uint32Value(), 1u, 64u);
+    }
+    if (input.Has("inferenceBatch") && input.Get("inferenceBatch").IsNumber()) {
+        options.inferenceBatch = std::max(1u, input.Get("inferenceBatch").As<Napi::Number>().Uint32Value());
+    }
+    if (input.Has("inferenceWaitUs") && input.Get("inferenceWaitUs").IsNumber()) {
+        options.inferenceWait = std::chrono::microseconds(input.Get("inferenceWaitUs").As<Napi::Number>().Int64Value());
+    }
+    if (input.Has("evalCacheEntries") && input.Get("evalCacheEntries").IsNumber()) {
+        options.evalCacheEntries = input.Get("evalCacheEntries").As<Napi::Number>().Uint32Value();
+    }
+    if (input.Has("inferencePrecision") && input.Get("inferencePrecision").IsString()) {
+        const auto precision = input.Get("inferencePrecision").As<Napi::String>().Utf8Value();
+        if (precision != "fp32" && precision != "int8") {
+            throw Napi::TypeError::New(env, "inferencePrecision must be 'fp32' or 'int8'");
+        }
+        options.int8Inference = precision == "int8";
+    }
+    if (input.Has("rlPoolSize") && input.Get("rlPoolSize").IsNumber()) {
+        options.rlPoolSize = input.Get("rlPoolSize").As<Napi::Number>().Uint32Value();
+    }
+    if (input.Has("sloMs") && input.Get("sloMs").IsNumber()) {
+        options.admission.slo = std::chrono::microseconds(static_cast<int64_t>(input.Get("sloMs").As<Napi::Number>().DoubleValue() * 1000.0));
+    }
+    if (input.Has("cacheEntries") && input.Get("cacheEntries").IsNumber()) {
+        options.cacheEntries = input.Get("cacheEntries").As<Napi::Number>().Uint32Value();
+    }
+    if (input.Has("overloadPolicy") && input.Get("overloadPolicy").IsString()) {
+        const auto policy = input.Get("overloadPolicy").As<Napi::String>().Utf8Value();
+        if (policy == "reject") {
+            options.admission.policy = AdmissionControl::Policy::Reject;
+        } else if (policy == "downgrade") {
+            options.admission.policy = AdmissionControl::Policy::Downgrade;
+        } else if (policy == "off") {
+            options.admission.policy = AdmissionControl::Policy::Off;
+        } else {
+            throw Napi::TypeError::New(env, "overloadPolicy must be 'off', 'reject' or 'downgrade'");
+        }
+    }
+
+    return Napi::Boolean::New(env, EngineScheduler::instance().configure(options));
+}
+
+namespace {
+
+Napi::Object Summarize(Napi::Env env, const Histogram& histogram) {
+    const auto summary = histogram.summary();
+    auto out = Napi::Object::New(env);
+    out.Set("count", Napi::Number::New(env, static_cast<double>(summary.count)));
+    out.Set("mean", Napi::Number::New(env, summary.mean));
+    out.Set("p50", Napi::Number::New(env, static_cast<double>(summary.p50)));
+    out.Set("p90", Napi::Number::New(env, static_cast<double>(summary.p90)));
+    out.Set("p99", Napi::Number::New(env, static_cast<double>(summary.p99)));
+    out.Set("p999", Napi::Number::New(env, static_cast<double>(summary.p999)));
+    out.Set("max", Napi::Number::New(env, static_cast<double>(summary.max)));
+    return out;
+}
+
+double Ratio(const uint64_t part, const uint64_t whole) {
+    return whole ? static_cast<double>(part) / static_cast<double>(whole) : 0.0;
+}
+
+}  // namespace
+
+Napi::Value EngineAsyncWorker::Stats(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    auto& scheduler = EngineScheduler::instance();
+
+    auto out = Napi::Object::New(env);
+    out.Set("threads", Napi::Number::New(env, scheduler.threadCount()));
+    out.Set("queueDepth", Napi::Number::New(env, static_cast<double>(scheduler.queueDepth())));
+    out.Set("expectedWaitMs", Napi::Number::New(env, static_cast<double>(scheduler.admission().expectedWait().count()) / 1000.0));
+
+    const auto cached = scheduler.cache().summary();
+    auto cache = Napi::Object::New(env);
+    cache.Set("entries", Napi::Number::New(env, static_cast<double>(cached.entries)));
+    cache.Set("capacity", Napi::Number::New(env, static_cast<double>(cached.capacity)));
+    cache.Set("inflight", Napi::Number::New(env, static_cast<double>(cached.inflight)));
+    cache.Set("hits", Napi::Number::New(env, static_cast<double>(cached.hits)));
+    cache.Set("coalesced", Napi::Number::New(env, static_cast<double>(cached.coalesced)));
+    cache.Set("misses", Napi::Number::New(env, static_cast<double>(cached.misses)));
+    cache.Set("evictions", Napi::Number::New(env, static_cast<double>(cached.evictions)));
+    cache.Set("hitRate", Napi::Number::New(env, Ratio(cached.hits + cached.coalesced, cached.hits + cached.coalesced + cached.misses)));
+    out.Set("cache", cache);
+
+    const auto pooled = scheduler.rlPool().summary();
+    auto rlPool = Napi::Object::New(env);
+    rlPool.Set("size", Napi::Number::New(env, pooled.size));
+    rlPool.Set("active", Napi::Number::New(env, pooled.active));
+    rlPool.Set("waiting", Napi::Number::New(env, static_cast<double>(pooled.waiting)));
+    out.Set("rlPool", rlPool);
+
+    auto classes = Napi::Object::New(env);
+    scheduler.stats().forEach([&](const std::string& key, const ClassStats& stats) {
+        const auto load = [](const std::atomic<uint64_t>& counter) { return counter.load(std::memory_order_relaxed); };
+        const auto number = [&](const uint64_t value) { return Napi::Number::New(env, static_cast<double>(value)); };
+
+        auto entry = Napi::Object::New(env);
+        entry.Set("requests", number(load(stats.requests)));
+        entry.Set("completed", number(load(stats.completed)));
+        entry.Set("failed", number(load(stats.failed)));
+        entry.Set("rejected", number(load(stats.rejected)));
+        entry.Set("downgraded", number(load(stats.downgraded)));
+        entry.Set("cancelled", number(load(stats.cancelled)));
+        entry.Set("units", number(load(stats.units)));
+        entry.Set("unitsPerSec", Napi::Number::New(env, Ratio(load(stats.units) * 1000000, load(stats.busyMicros))));
+        entry.Set("cacheHits", number(load(stats.cacheHits)));
+        entry.Set("coalesced", number(load(stats.coalesced)));
+        entry.Set("ttProbes", number(load(stats.ttProbes)));
+        entry.Set("ttHitRate", Napi::Number::New(env, Ratio(load(stats.ttHits), load(stats.ttProbes))));
+        entry.Set("inferences", number(load(stats.inferences)));
+        entry.Set("meanBatchSize", Napi::Number::New(env, Ratio(load(stats.inferredPositions), load(stats.inferences))));
+        entry.Set("reusedVisits", number(load(stats.reusedVisits)));
+        entry.Set("evalCacheProbes", number(load(stats.evalProbes)));
+        entry.Set("evalCacheHitRate", Napi::Number::New(env, Ratio(load(stats.evalHits), load(stats.evalProbes))));
+        entry.Set("poolWaitUs", Summarize(env, stats.poolWaitMicros));
+        entry.Set("queueWaitUs", Summarize(env, stats.queueWaitMicros));
+        entry.Set("executionUs", Summarize(env, stats.executionMicros));
+        entry.Set("unitsPerSearch", Summarize(env, stats.unitsPerSearch));
+        entry.Set("predictionErrorPct", Summarize(env, stats.predictionErrorPct));
+        entry.Set("inferenceUs", Summarize(env, stats.inferenceMicros));
+        entry.Set("batchSize", Summarize(env, stats.batchSize));
+        classes.Set(key, entry);
+    });
+    out.Set("classes", classes);
+
+    return out;
+}
@@ -0,0 +1,164 @@
+/**
+ * Authors:
+ * Rigoberto Leander Salgado Reyes <rlsalgado2006@gmail.com>
+ *
+ * Copyright 2025 by Rigoberto Leander Salgado Reyes.
+ *
+ * This program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ */
+
+#include <EngineScheduler.h>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <algorithm>
+
+namespace {
+
+std::mutex instanceMutex;
+EngineScheduler *current = nullptr;
+
+}  // namespace
+
+EngineScheduler::EngineScheduler() : EngineScheduler(Options{}) {
+}
+
+EngineScheduler::EngineScheduler(const Options poptions) : options(poptions) {
+    admissionControl.configure(options.admission, threadCount());
+    resultCache.configure(options.cacheEntries);
+    rlSearchPool.configure(options.rlPoolSize);
+}
+
+EngineScheduler::~EngineScheduler() {
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    for (auto &worker : workers) worker.join();
+}
+
+EngineScheduler &EngineScheduler::instance() {
+    std::lock_guard lock(instanceMutex);
+    if (!current) {
+        // intencionalmente sin destruir: al salir del proceso no se espera por búsquedas en curso.
+        current = new EngineScheduler();
+    }
+    return *current;
+}
+
+void EngineScheduler::adopt(EngineScheduler *scheduler) {
+    std::lock_guard lock(instanceMutex);
+    current = scheduler;
+}
+
+bool EngineScheduler::configure(const Options &poptions) {
+    std::lock_guard lock(mutex);
+    if (!workers.empty())
+        return false;
+
+    options = poptions;
+    admissionControl.configure(options.admission, threadCount());
+    resultCache.configure(options.cacheEntries);
+    rlSearchPool.configure(options.rlPoolSize);
+    return true;
+}
+
+const EngineScheduler::Options &EngineScheduler::config() const {
+    return options;
+}
+
+AdmissionControl &EngineScheduler::admission() {
+    return admissionControl;
+}
+
+EngineStats &EngineScheduler::stats() {
+    return engineStats;
+}
+
+ResultCache &EngineScheduler::cache() {
+    return resultCache;
+}
+
+SearchPool &EngineScheduler::rlPool() {
+    return rlSearchPool;
+}
+
+unsigned EngineScheduler::threadCount() const {
+    if (options.threads)
+        return options.threads;
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+size_t EngineScheduler::queueDepth() const {
+    std::lock_guard lock(mutex);
+    return queue.size();
+}
+
+void EngineScheduler::submit(const std::chrono::microseconds slack, Job job) {
+    {
+        std::lock_guard lock(mutex);
+        if (workers.empty())
+            start();
+
+        const auto now = Clock::now();
+        queue.push(Entry{now + slack, now + 2 * slack, nextSequence++, slack, std::move(job)});
+    }
+    wakeUp.notify_one();
+}
+
+void EngineScheduler::start() {
+    const auto count = threadCount();
+    workers.reserve(count);
+    for (unsigned i = 0; i < count; i++) {
+        workers.emplace_back([this, i] { workerLoop(i); });
+    }
+}
+
+void EngineScheduler::workerLoop(const unsigned index) {
+    if (options.pinThreads)
+        pinCurrentThread(index);
+
+    for (;;) {
+        Entry entry;
+        {
+            std::unique_lock lock(mutex);
+            wakeUp.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (stopping)
+                return;
+
+            // std::priority_queue::top() es const; la entrada se mueve antes de sacarla de la cola.
+            entry = std::move(const_cast<Entry &>(queue.top()));
+            queue.pop();
+        }
+
+        if (entry.job())
+            continue;
+
+        // slice agotado: vuelve a la cola detrás de lo que llegó mientras corría, salvo que ya haya
+        // envejecido hasta su tope; desde ahí el plazo no se mueve y lo nuevo deja de adelantarla.
+        std::lock_guard lock(mutex);
+        entry.deadline = std::min(Clock::now() + entry.slack, entry.latest);
+        entry.sequence = nextSequence++;
+        queue.push(std::move(entry));
+    }
+}
+
+void EngineScheduler::pinCurrentThread(const unsigned index) {
+#if defined(__linux__)
+    const auto cpus = std::max(1u, std::thread::hardware_concurrency());
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(index % cpus, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)index;
+#endif
+}
@@ -0,0 +1,416 @@
+/**
+ * Authors:
+ * Rigoberto Leander Salgado Reyes <rlsalgado2006@gmail.com>
+ *
+ * Copyright 2025 by Rigoberto Leander Salgado Reyes.
+ *
+ * This program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ */
+
+#include <Board.h>
+#include <EngineSession.h>
+#include <PieceKind.h>
+#include <Rules.h>
+#include <SearchTask.h>
+#include <minimax.h>
+
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+#if defined(ENGINE_WITH_RL)
+#include "RlPlay.h"
+#include "neutron_rl/model_registry.hpp"
+#endif
+
+namespace {
+
+constexpr uint8_t kBlack = 1;
+constexpr uint8_t kWhite = 2;
+constexpr uint8_t kNeutron = 3;
+constexpr uint8_t kCell = 4;
+
+// Tablero inicial en col-major: board[col*5 + row]; negras en la fila 0, blancas en la 4.
+std::array<uint8_t, 25> startPosition() {
+    std::array<uint8_t, 25> board{};
+    for (int col = 0; col < 5; col++) {
+        for (int row = 0; row < 5; row++) {
+            board[col * 5 + row] = row == 0 ? kBlack : row == 4 ? kWhite : kCell;
+        }
+    }
+    board[2 * 5 + 2] = kNeutron;
+    return board;
+}
+
+std::string square(const int row, const int col) {
+    return {static_cast<char>('a' + col), static_cast<char>('5' - row)};
+}
+
+}  // namespace
+
+EngineSession::EngineSession(std::ostream &pout) : out(pout), position(startPosition()) {
+}
+
+EngineSession::~EngineSession() {
+    stop();
+}
+
+bool EngineSession::handle(const std::string &line) {
+    std::istringstream args(line);
+    std::string command;
+    if (!(args >> command))
+        return true;
+
+    try {
+        if (command == "neutron") {
+            identify();
+        } else if (command == "isready") {
+            say("readyok");
+        } else if (command == "setoption") {
+            setOption(args);
+        } else if (command == "newgame") {
+            stop();
+            position = startPosition();
+#if defined(ENGINE_WITH_RL)
+            tree.clear();
+#endif
+        } else if (command == "position") {
+            stop();
+            setPosition(args);
+        } else if (command == "go") {
+            go(args);
+        } else if (command == "stop") {
+            stop();
+        } else if (command == "stats") {
+            printStats();
+        } else if (command == "d") {
+            printBoard();
+        } else if (command == "quit") {
+            stop();
+            return false;
+        } else {
+            say("info string unknown command " + command);
+        }
+    } catch (const std::exception &ex) {
+        say(std::string("info string error ") + ex.what());
+    }
+
+    return true;
+}
+
+void EngineSession::identify() {
+    say("id name neutron-engine");
+    say("id author Rigoberto Leander Salgado Reyes");
+    say("option name SliceNodes type spin default 20000 min 1 max 100000000");
+    say("option name MaxDepth type spin default 12 min 1 max 64");
+#if defined(ENGINE_WITH_RL)
+    say("option name SliceSimulations type spin default 16 min 1 max 100000");
+    say("option name LeafBatch type spin default 1 min 1 max 256");
+    say("option name EvalCache type spin default 65536 min 0 max 16777216");
+    say("option name Precision type combo default fp32 var fp32 var int8");
+    say("option name Model type string default <empty>");
+#endif
+    say("neutronok");
+}
+
+void EngineSession::setOption(std::istringstream &args) {
+    std::string token, name, value;
+    args >> token >> name;
+    if (token != "name")
+        throw std::invalid_argument("setoption name <id> value <x>");
+    args >> token;
+    std::getline(args >> std::ws, value);
+
+    if (name == "SliceNodes") {
+        sliceNodes = static_cast<unsigned>(std::max(1ul, std::stoul(value)));
+    } else if (name == "MaxDepth") {
+        maxDepth = std::clamp(std::stoi(value), 1, 64);
+#if defined(ENGINE_WITH_RL)
+    } else if (name == "SliceSimulations") {
+        sliceSimulations = static_cast<unsigned>(std::max(1ul, std::stoul(value)));
+    } else if (name == "LeafBatch") {
+        leafBatch = std::clamp(std::stoi(value), 1, 256);
+    } else if (name == "EvalCache") {
+        evalCacheEntries = std::min(std::stoul(value), 16777216ul);
+    } else if (name == "Precision") {
+        if (value != "fp32" && value != "int8")
+            throw std::invalid_argument("Precision must be fp32 or int8");
+        precision = value == "int8" ? neutron_rl::InferencePrecision::Int8 : neutron_rl::InferencePrecision::Float32;
+    } else if (name == "Model") {
+        loadModel(value);
+#endif
+    } else {
+        throw std::invalid_argument("unknown option " + name);
+    }
+}
+
+void EngineSession::loadModel(const std::string &path) {
+#if defined(ENGINE_WITH_RL)
+    stop();
+    agent = std::make_shared<neutron_rl::NeutronAgent>(neutron_rl::ModelRegistry::acquire(path, "cpu", nullptr, {}, evalCacheEntries, nullptr, precision));
+    tree.clear();
+    say("info string model loaded " + path);
+#else
+    (void)path;
+    throw std::runtime_error("built without RL support");
+#endif
+}
+
+void EngineSession::setPosition(std::istringstream &args) {
+    std::string token;
+    args >> token;
+
+    std::array<uint8_t, 25> board{};
+    if (token == "startpos") {
+        board = startPosition();
+    } else if (token == "board") {
+        std::string digits;
+        args >> digits;
+        if (digits.size() != board.size())
+            throw std::invalid_argument("position board expects 25 digits");
+        for (size_t i = 0; i < board.size(); i++) {
+            if (digits[i] < '1' || digits[i] > '4')
+                throw std::invalid_argument("board digits must be 1-4");
+            board[i] = static_cast<uint8_t>(digits[i] - '0');
+        }
+    } else {
+        throw std::invalid_argument("position startpos|board <25 digits> [moves ...]");
+    }
+
+    if (args >> token) {
+        if (token != "moves")
+            throw std::invalid_argument("expected 'moves'");
+
+        while (args >> token) {
+            if (token.size() != 8)
+                throw std::invalid_argument("bad move " + token);
+
+            const auto neutronFrom = squareIndex(token.substr(0, 2));
+            const auto neutronTo = squareIndex(token.substr(2, 2));
+            const auto pawnFrom = squareIndex(token.substr(4, 2));
+            const auto pawnTo = squareIndex(token.substr(6, 2));
+            const auto pawn = board[pawnFrom];
+            if ((pawn != kBlack && pawn != kWhite) ||
+                !rules::valid(board, static_cast<PieceKind>(pawn), neutronFrom, neutronTo, pawnFrom, pawnTo))
+                throw std::invalid_argument("illegal move " + token);
+
+            board[neutronFrom] = kCell;
+            board[neutronTo] = kNeutron;
+            board[pawnFrom] = kCell;
+            board[pawnTo] = pawn;
+        }
+    }
+
+    position = board;
+}
+
+void EngineSession::go(std::istringstream &args) {
+    stop();
+
+    GoLimits limits;
+    std::string token;
+    while (args >> token) {
+        if (token == "depth") {
+            args >> limits.depth;
+        } else if (token == "movetime") {
+            long ms = 0;
+            args >> ms;
+            limits.movetime = std::chrono::milliseconds(ms);
+        } else if (token == "infinite") {
+            limits.infinite = true;
+        } else if (token == "rl") {
+            args >> limits.rlDifficulty;
+        } else if (token == "simulations") {
+            args >> limits.simulations;
+        } else {
+            throw std::invalid_argument("unknown go parameter " + token);
+        }
+    }
+
+    stopRequested = false;
+    if (!limits.rlDifficulty.empty() || limits.simulations > 0) {
+#if defined(ENGINE_WITH_RL)
+        if (!agent || !agent->is_ready())
+            throw std::runtime_error("RL model not loaded");
+        searcher = std::thread(&EngineSession::searchRl, this, position, limits);
+        return;
+#else
+        throw std::runtime_error("built without RL support");
+#endif
+    }
+
+    searcher = std::thread(&EngineSession::searchMinimax, this, position, limits);
+}
+
+void EngineSession::stop() {
+    stopRequested = true;
+    if (searcher.joinable())
+        searcher.join();
+}
+
+bool EngineSession::shouldStop(const Clock::time_point deadline) const {
+    return stopRequested.load(std::memory_order_relaxed) || Clock::now() >= deadline;
+}
+
+void EngineSession::searchMinimax(const std::array<uint8_t, 25> start, const GoLimits limits) {
+    constexpr int alpha = std::numeric_limits<int>::min();
+    constexpr int beta = std::numeric_limits<int>::max();
+
+    const auto started = Clock::now();
+    const auto deadline = limits.movetime.count() > 0 ? started + limits.movetime : Clock::time_point::max();
+    const int lastDepth = limits.depth > 0 ? limits.depth : maxDepth;
+    const auto key = limits.depth > 0 ? "minimax:" + std::to_string(limits.depth) : limits.infinite ? std::string("minimax:infinite") : std::string("minimax:movetime");
+
+    std::unique_ptr<FullMove> best;
+    uint64_t nodes = 0;
+    bool interrupted = false;
+
+    // Profundización iterativa: "stop" o movetime devuelven la última profundidad completa.
+    for (int depth = 1; depth <= lastDepth; depth++) {
+        auto board = std::make_unique<Board>(start);
+        SearchSlice slice{sliceNodes};
+        auto search = maxValue(slice, board, depth, alpha, beta, PieceKind::BLACK);
+
+        while (!search.step(slice)) {
+            if (best && shouldStop(deadline)) {
+                interrupted = true;
+                break;
+            }
+        }
+        nodes += slice.units;
+        if (interrupted)
+            break;
+
+        best = search.take();
+
+        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - started).count();
+        const auto nps = elapsed ? nodes * 1000 / static_cast<uint64_t>(elapsed) : nodes;
+        say("info depth " + std::to_string(depth) + " score " + std::to_string(best->score) + " nodes " + std::to_string(nodes) + " time " +
+            std::to_string(elapsed) + " nps " + std::to_string(nps) + " pv " + formatMove(*best));
+
+        // sin jugadas: la partida ya terminó y más profundidad no cambia nada.
+        if (best->moves.empty() || shouldStop(deadline))
+            break;
+    }
+
+    // "go infinite" espera a "stop" aunque haya agotado MaxDepth.
+    while (limits.infinite && !stopRequested) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    record(key, started, nodes, stopRequested && !limits.infinite);
+    say("bestmove " + (best && !best->moves.empty() ? formatMove(*best) : std::string("(none)")));
+}
+
+#if defined(ENGINE_WITH_RL)
+void EngineSession::searchRl(const std::array<uint8_t, 25> start, const GoLimits limits) {
+    auto difficulty = neutron_rl::DifficultyConfig::from_preset(neutron_rl::Difficulty::Hard);
+    std::string key = "rl:simulations";
+    if (limits.simulations > 0) {
+        difficulty = neutron_rl::DifficultyConfig::from_simulations(limits.simulations);
+    } else {
+        const auto preset = neutron_rl::DifficultyConfig::from_name(limits.rlDifficulty);
+        if (!preset) {
+            say("info string error invalid RL difficulty " + limits.rlDifficulty);
+            say("bestmove (none)");
+            return;
+        }
+        difficulty = *preset;
+        key = "rl:" + limits.rlDifficulty;
+    }
+
+    difficulty.leaf_batch = leafBatch;
+
+    const auto started = Clock::now();
+    const auto deadline = limits.movetime.count() > 0 ? started + limits.movetime : Clock::time_point::max();
+
+    SearchSlice slice{sliceSimulations};
+    auto search = play_black(*agent, start, difficulty, slice, nullptr, &tree);
+
+    bool stopped = false;
+    while (!search.step(slice)) {
+        if (shouldStop(deadline)) {
+            stopped = true;
+            break;
+        }
+    }
+
+    record(key, started, slice.units, stopped);
+    if (stopped) {
+        say("bestmove (none)");
+        return;
+    }
+
+    // Mismo formato que minimax: neutrón origen/destino y peón origen/destino.
+    const auto result = search.take();
+    std::string move;
+    for (const auto &step : result.moves) move += square(step.row, step.col);
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - started).count();
+    say("info simulations " + std::to_string(slice.units) + " reused " + std::to_string(result.reused_visits) + " time " +
+        std::to_string(elapsed));
+    say("bestmove " + move);
+}
+#endif
+
+void EngineSession::record(const std::string &key, const Clock::time_point started, const uint64_t units, const bool stopped) {
+    const auto elapsed = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - started).count());
+
+    auto &entry = stats.forClass(key);
+    entry.requests.fetch_add(1, std::memory_order_relaxed);
+    (stopped ? entry.cancelled : entry.completed).fetch_add(1, std::memory_order_relaxed);
+    entry.units.fetch_add(units, std::memory_order_relaxed);
+    entry.busyMicros.fetch_add(elapsed, std::memory_order_relaxed);
+    entry.executionMicros.record(elapsed);
+    entry.unitsPerSearch.record(units);
+}
+
+void EngineSession::printStats() {
+    stats.forEach([this](const std::string &key, const ClassStats &entry) {
+        const auto units = entry.units.load(std::memory_order_relaxed);
+        const auto busy = entry.busyMicros.load(std::memory_order_relaxed);
+        const auto time = entry.executionMicros.summary();
+
+        std::ostringstream line;
+        line << "info string stats " << key                                      //
+             << " searches " << entry.requests.load(std::memory_order_relaxed)  //
+             << " stopped " << entry.cancelled.load(std::memory_order_relaxed)  //
+             << " units " << units                                              //
+             << " ups " << (busy ? units * 1000000 / busy : 0)                  //
+             << " time_us_p50 " << time.p50                                     //
+             << " time_us_p99 " << time.p99                                     //
+             << " time_us_max " << time.max;
+        say(line.str());
+    });
+    say("info string stats end");
+}
+
+void EngineSession::printBoard() {
+    std::string digits;
+    for (const auto cell : position) digits += static_cast<char>('0' + cell);
+    say("info string board " + digits);
+}
+
+void EngineSession::say(const std::string &line) {
+    std::lock_guard lock(outMutex);
+    out << line << std::endl;
+}
+
+std::string EngineSession::formatMove(const FullMove &fullMove) {
+    std::string move;
+    for (const auto &step : fullMove.moves) move += square(step->row, step->col);
+    return move;
+}
+
+int EngineSession::squareIndex(const std::string &square) {
+    if (square.size() != 2 || square[0] < 'a' || square[0] > 'e' || square[1] < '1' || square[1] > '5')
+        throw std::invalid_argument("bad square " + square);
+
+    const int col = square[0] - 'a';
+    const int row = '5' - square[1];
+    return col * 5 + row;
+}
@@ -0,0 +1,106 @@
+/**
+ * Authors:
+ * Rigoberto Leander Salgado Reyes <rlsalgado2006@gmail.com>
+ *
+ * Copyright 2025 by Rigoberto Leander Salgado Reyes.
+ *
+ * This program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ */
+
+#include <EngineStats.h>
+
+#include <algorithm>
+#include <bit>
+
+namespace {
+
+thread_local ClassStats *currentStats = nullptr;
+
+}  // namespace
+
+unsigned Histogram::bucketOf(const uint64_t value) {
+    if (value < kSubBuckets)
+        return static_cast<unsigned>(value);
+
+    const unsigned shift = std::bit_width(value) - 1 - kSubBits;
+    return ((shift + 1) << kSubBits) | static_cast<unsigned>((value >> shift) & (kSubBuckets - 1));
+}
+
+uint64_t Histogram::highestIn(const unsigned bucket) {
+    const unsigned magnitude = bucket >> kSubBits;
+    const uint64_t sub = bucket & (kSubBuckets - 1);
+    if (!magnitude)
+        return sub;
+
+    const uint64_t lowest = (kSubBuckets | sub) << (magnitude - 1);
+    return lowest + ((uint64_t{1} << (magnitude - 1)) - 1);
+}
+
+void Histogram::record(const uint64_t value) {
+    buckets[bucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(value, std::memory_order_relaxed);
+
+    auto seen = max.load(std::memory_order_relaxed);
+    while (value > seen && !max.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+    }
+}
+
+Histogram::Summary Histogram::summary() const {
+    // Lecturas relajadas: el resumen puede mezclar muestras concurrentes, nunca las pierde.
+    std::array<uint64_t, kBuckets> snapshot{};
+    uint64_t total = 0;
+    for (unsigned i = 0; i < kBuckets; i++) {
+        snapshot[i] = buckets[i].load(std::memory_order_relaxed);
+        total += snapshot[i];
+    }
+
+    Summary out{};
+    out.count = total;
+    out.max = max.load(std::memory_order_relaxed);
+    out.mean = total ? static_cast<double>(sum.load(std::memory_order_relaxed)) / static_cast<double>(total) : 0.0;
+    if (!total)
+        return out;
+
+    const auto at = [&](const double quantile) {
+        const auto rank = static_cast<uint64_t>(quantile * static_cast<double>(total - 1)) + 1;
+        uint64_t seen = 0;
+        for (unsigned i = 0; i < kBuckets; i++) {
+            seen += snapshot[i];
+            if (seen >= rank)
+                return std::min(highestIn(i), out.max);
+        }
+        return out.max;
+    };
+
+    out.p50 = at(0.5);
+    out.p90 = at(0.9);
+    out.p99 = at(0.99);
+    out.p999 = at(0.999);
+    return out;
+}
+
+ClassStats *ClassStats::current() {
+    return currentStats;
+}
+
+void ClassStats::setCurrent(ClassStats *stats) {
+    currentStats = stats;
+}
+
+ClassStats &EngineStats::forClass(const std::string &key) {
+    std::lock_guard lock(mutex);
+    auto &slot = classes[key];
+    if (!slot)
+        slot = std::make_unique<ClassStats>();
+    return *slot;
+}
+
+void EngineStats::forEach(const std::function<void(const std::string &, const ClassStats &)> &visit) const {
+    std::lock_guard lock(mutex);
+    for (const auto &[key, stats] : classes) visit(key, *stats);
+}
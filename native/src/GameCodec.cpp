@@ -0,0 +1,364 @@
+/**
+ * Authors:
+ * Rigoberto Leander Salgado Reyes <rlsalgado2006@gmail.com>
+ *
+ * Copyright 2025 by Rigoberto Leander Salgado Reyes.
+ *
+ * This program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ */
+
+#include <GameCodec.h>
+
+#include <array>
+#include <bit>
+#include <cmath>
+#include <stdexcept>
+
+namespace codec {
+
+namespace {
+
+constexpr auto kBlack = static_cast<uint8_t>(PieceKind::BLACK);
+constexpr auto kWhite = static_cast<uint8_t>(PieceKind::WHITE);
+constexpr auto kNeutron = static_cast<uint8_t>(PieceKind::NEUTRON);
+constexpr auto kCell = static_cast<uint8_t>(PieceKind::CELL);
+
+constexpr int kPawns = 5;
+
+enum Flags : uint8_t { kScores = 1, kSelected = 2, kNeutronFrom = 4, kNeutronTo = 8 };
+
+constexpr std::array<std::array<uint64_t, kPawns + 1>, 26> makeBinomials() {
+    std::array<std::array<uint64_t, kPawns + 1>, 26> c{};
+    for (size_t n = 0; n < c.size(); n++) {
+        c[n][0] = 1;
+        for (size_t k = 1; k <= kPawns && k <= n; k++) c[n][k] = c[n - 1][k - 1] + c[n - 1][k];
+    }
+    return c;
+}
+
+constexpr auto kBinomial = makeBinomials();
+constexpr uint64_t kBlackRanks = kBinomial[24][kPawns];
+constexpr uint64_t kWhiteRanks = kBinomial[19][kPawns];
+constexpr uint64_t kKeys = 25 * kBlackRanks * kWhiteRanks * 4;
+
+static_assert(kKeys < (uint64_t{1} << (8 * kPositionBytes)));
+
+// cinco posiciones (de n) codificadas con el sistema combinatorio: suma de C(posición, i).
+uint32_t unrankSet(uint64_t rank, const int n) {
+    uint32_t set = 0;
+    for (int k = kPawns; k > 0; k--) {
+        int c = n - 1;
+        while (kBinomial[c][k] > rank) c--;
+        rank -= kBinomial[c][k];
+        set |= uint32_t{1} << c;
+    }
+    return set;
+}
+
+uint8_t highlighted(const uint8_t cell) {
+    switch (static_cast<PieceKind>(cell)) {
+        case PieceKind::BLACK:
+            return static_cast<uint8_t>(PieceKind::SBLACK);
+        case PieceKind::WHITE:
+            return static_cast<uint8_t>(PieceKind::SWHITE);
+        case PieceKind::NEUTRON:
+            return static_cast<uint8_t>(PieceKind::SNEUTRON);
+        case PieceKind::CELL:
+            return static_cast<uint8_t>(PieceKind::SCELL);
+        default:
+            return cell;
+    }
+}
+
+// lo mismo que onClickCell: la pieza seleccionada y sus destinos resaltados.
+Cells highlight(Cells cells, const int selected) {
+    if (selected == kNone)
+        return cells;
+
+    for (auto mask = rules::targets(cells, selected) | uint32_t{1} << selected; mask; mask &= mask - 1) {
+        const auto cell = std::countr_zero(mask);
+        cells[cell] = highlighted(cells[cell]);
+    }
+    return cells;
+}
+
+void apply(Cells &cells, const int from, const int to, const uint8_t kind) {
+    cells[to] = kind;
+    if (from != to)
+        cells[from] = kCell;
+}
+
+void put(std::vector<uint8_t> &out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+uint64_t zigzag(const int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t unzigzag(const uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+class Reader {
+   public:
+    Reader(const uint8_t *pdata, const size_t psize) : data(pdata), size(psize) {
+    }
+
+    uint8_t byte() {
+        if (at >= size)
+            throw std::invalid_argument("truncated game record");
+        return data[at++];
+    }
+
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            const auto b = byte();
+            value |= static_cast<uint64_t>(b & 0x7f) << shift;
+            if (!(b & 0x80))
+                return value;
+        }
+        throw std::invalid_argument("bad varint in game record");
+    }
+
+    uint64_t fixed(const size_t bytes) {
+        uint64_t value = 0;
+        for (size_t i = 0; i < bytes; i++) value |= static_cast<uint64_t>(byte()) << (8 * i);
+        return value;
+    }
+
+    int cell() {
+        const int value = byte();
+        if (!rules::inside(value))
+            throw std::invalid_argument("bad cell in game record");
+        return value;
+    }
+
+    [[nodiscard]] bool done() const {
+        return at == size;
+    }
+
+   private:
+    const uint8_t *data;
+    size_t size;
+    size_t at{0};
+};
+
+void putFixed(std::vector<uint8_t> &out, const uint64_t value, const size_t bytes) {
+    for (size_t i = 0; i < bytes; i++) out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+}  // namespace
+
+std::optional<uint64_t> rank(const Cells &board, const int phase) {
+    if (phase < 0 || phase > 3)
+        return std::nullopt;
+
+    const auto cells = rules::plainCells(board);
+    const int neutron = rules::find(cells, kNeutron);
+    if (neutron == kNone)
+        return std::nullopt;
+
+    uint64_t black = 0;
+    uint64_t white = 0;
+    int blacks = 0;
+    int whites = 0;
+    int rest24 = 0;  // casillas vistas sin contar el neutrón
+    int rest19 = 0;  // ... ni las negras
+    for (int i = 0; i < static_cast<int>(cells.size()); i++) {
+        if (i == neutron)
+            continue;
+
+        if (cells[i] == kBlack) {
+            if (++blacks > kPawns)
+                return std::nullopt;
+            black += kBinomial[rest24][blacks];
+        } else {
+            if (cells[i] == kWhite) {
+                if (++whites > kPawns)
+                    return std::nullopt;
+                white += kBinomial[rest19][whites];
+            } else if (cells[i] != kCell) {
+                return std::nullopt;
+            }
+            rest19++;
+        }
+        rest24++;
+    }
+
+    if (blacks != kPawns || whites != kPawns)
+        return std::nullopt;
+    return ((static_cast<uint64_t>(neutron) * kBlackRanks + black) * kWhiteRanks + white) * 4 + static_cast<uint64_t>(phase);
+}
+
+Cells unrank(uint64_t key, int &phase) {
+    if (key >= kKeys)
+        throw std::invalid_argument("position key out of range");
+
+    phase = static_cast<int>(key % 4);
+    key /= 4;
+    const auto whites = unrankSet(key % kWhiteRanks, 19);
+    key /= kWhiteRanks;
+    const auto blacks = unrankSet(key % kBlackRanks, 24);
+    const auto neutron = static_cast<int>(key / kBlackRanks);
+
+    Cells cells;
+    int rest24 = 0;
+    int rest19 = 0;
+    for (int i = 0; i < static_cast<int>(cells.size()); i++) {
+        if (i == neutron) {
+            cells[i] = kNeutron;
+            continue;
+        }
+
+        if (blacks >> rest24++ & 1) {
+            cells[i] = kBlack;
+        } else {
+            cells[i] = whites >> rest19++ & 1 ? kWhite : kCell;
+        }
+    }
+    return cells;
+}
+
+std::optional<std::vector<uint8_t>> encode(const Game &game) {
+    const auto board = rules::plainCells(game.board);
+    const auto startKey = rank(game.start, 0);
+    const auto boardKey = rank(board, game.phase);
+    if (!startKey || !boardKey || game.start != rules::plainCells(game.start))
+        return std::nullopt;
+
+    if ((game.selected != kNone && (!rules::inside(game.selected) || board[game.selected] == kCell)) ||
+        highlight(board, game.selected) != game.board)
+        return std::nullopt;
+    if ((game.neutronFrom != kNone && !rules::inside(game.neutronFrom)) || (game.neutronTo != kNone && !rules::inside(game.neutronTo)))
+        return std::nullopt;
+
+    std::vector<uint8_t> out;
+    out.reserve(24 + 2 * game.moves.size());
+
+    uint8_t flags = 0;
+    if (game.selected != kNone)
+        flags |= kSelected;
+    if (game.neutronFrom != kNone)
+        flags |= kNeutronFrom;
+    if (game.neutronTo != kNone)
+        flags |= kNeutronTo;
+
+    if (!game.scores.empty() && game.scores.size() != game.moves.size())
+        return std::nullopt;
+    for (const auto score : game.scores) {
+        // solo enteros: minimax da enteros y RL 1.0; cualquier otra cosa se guarda como JSON.
+        if (score != std::trunc(score) || std::fabs(score) > 9007199254740992.0)
+            return std::nullopt;
+        if (score != 0)
+            flags |= kScores;
+    }
+
+    out.push_back(kFormat);
+    out.push_back(flags);
+    putFixed(out, *startKey, kPositionBytes);
+    putFixed(out, *boardKey, kPositionBytes);
+    put(out, zigzag(game.version));
+    put(out, game.difficulty);
+    if (flags & kSelected)
+        out.push_back(static_cast<uint8_t>(game.selected));
+    if (flags & kNeutronFrom)
+        out.push_back(static_cast<uint8_t>(game.neutronFrom));
+    if (flags & kNeutronTo)
+        out.push_back(static_cast<uint8_t>(game.neutronTo));
+
+    put(out, game.moves.size());
+    auto cells = game.start;
+    for (const auto &move : game.moves) {
+        if (!rules::inside(move.neutronTo) || !rules::inside(move.pawnFrom) || !rules::inside(move.pawnTo) ||
+            move.neutronFrom != rules::find(cells, kNeutron))
+            return std::nullopt;
+
+        apply(cells, move.neutronFrom, move.neutronTo, kNeutron);
+        if (cells[move.pawnFrom] != move.pawnKind || (move.pawnKind != kBlack && move.pawnKind != kWhite))
+            return std::nullopt;
+        apply(cells, move.pawnFrom, move.pawnTo, move.pawnKind);
+
+        putFixed(out, move.neutronTo | move.pawnFrom << 5 | move.pawnTo << 10, 2);
+    }
+
+    if (flags & kScores) {
+        for (const auto score : game.scores) put(out, zigzag(static_cast<int64_t>(score)));
+    }
+    return out;
+}
+
+Game decode(const uint8_t *data, const size_t size) {
+    Reader in(data, size);
+    if (in.byte() != kFormat)
+        throw std::invalid_argument("not a game record");
+
+    const auto flags = in.byte();
+    if (flags & ~(kScores | kSelected | kNeutronFrom | kNeutronTo))
+        throw std::invalid_argument("unknown game record flags");
+
+    Game game;
+    int phase = 0;
+    game.start = unrank(in.fixed(kPositionBytes), phase);
+    const auto board = unrank(in.fixed(kPositionBytes), game.phase);
+    game.version = unzigzag(in.varint());
+    game.difficulty = static_cast<uint32_t>(in.varint());
+    if (flags & kSelected)
+        game.selected = in.cell();
+    if (flags & kNeutronFrom)
+        game.neutronFrom = in.cell();
+    if (flags & kNeutronTo)
+        game.neutronTo = in.cell();
+    game.board = highlight(board, game.selected);
+
+    const auto count = in.varint();
+    if (count > size)
+        throw std::invalid_argument("truncated game record");
+
+    game.moves.reserve(count);
+    auto cells = game.start;
+    for (uint64_t i = 0; i < count; i++) {
+        const auto code = static_cast<int>(in.fixed(2));
+        PlayedMove move{rules::find(cells, kNeutron), code & 31, code >> 5 & 31, code >> 10 & 31, 0};
+        if (move.neutronFrom == kNone || !rules::inside(move.neutronTo) || !rules::inside(move.pawnFrom) || !rules::inside(move.pawnTo) ||
+            code >> 15)
+            throw std::invalid_argument("bad move in game record");
+
+        apply(cells, move.neutronFrom, move.neutronTo, kNeutron);
+        move.pawnKind = cells[move.pawnFrom];
+        if (move.pawnKind != kBlack && move.pawnKind != kWhite)
+            throw std::invalid_argument("move does not replay in game record");
+        apply(cells, move.pawnFrom, move.pawnTo, move.pawnKind);
+        game.moves.push_back(move);
+    }
+
+    game.scores.assign(game.moves.size(), 0.0);
+    if (flags & kScores) {
+        for (auto &score : game.scores) score = static_cast<double>(unzigzag(in.varint()));
+    }
+
+    if (!in.done())
+        throw std::invalid_argument("trailing bytes in game record");
+    return game;
+}
+
+Cells replay(const Game &game, const size_t plies) {
+    auto cells = game.start;
+    for (size_t i = 0; i < plies && i < game.moves.size(); i++) {
+        const auto &move = game.moves[i];
+        apply(cells, move.neutronFrom, move.neutronTo, kNeutron);
+        apply(cells, move.pawnFrom, move.pawnTo, move.pawnKind);
+    }
+    return cells;
+}
+
+}  // namespace codec
@@ -13,15 +13,29 @@
 
 #include <napi.h>
 
+#include <algorithm>
 #include <array>
+#include <chrono>
 #include <cstdint>
 #include <cstring>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
 
+#include "CostModel.h"
 #include "MinimaxAsyncWorker.h"
+#include "MinimaxBatchWorker.h"
+#include "GameCodec.h"
+#include "Rules.h"
 
 using namespace Napi;
 
-// JS signature: minimaxAsync(input: string | Buffer): Promise<string>
+// JS signature: minimaxAsync({board, depth, targetMs?, packed?, out?, onProgress?, progressIntervalMs?}):
+// Promise<{moves, score, depth, predictedMs?, predictionError?} | Int32Array>. onProgress({depth, score, nodes, moves})
+// reports each completed depth. With targetMs, `depth` is the deepest allowed and the CostModel picks the deepest
+// one predicted to answer within targetMs (queue wait included); predictionError is actual / predicted time - 1.
+// Under load admission control may lower `depth` or reject with a retryable ENGINE_OVERLOADED error.
 Value MinimaxAsync(const CallbackInfo& info) {
     Env env = info.Env();
     if (info.Length() < 1 || !info[0].IsObject()) {
@@ -36,13 +50,386 @@ Value MinimaxAsync(const CallbackInfo& info) {
 
     int depth = input.Get("depth").As<Number>().Uint32Value();
 
+    auto packed = PackedResult::FromInput(env, input);
+
     auto deferred = Promise::Deferred::New(env);
-    (new MinimaxAsyncWorker(env, board, depth, deferred))->Queue();
+
+    auto& scheduler = EngineScheduler::instance();
+
+    // la ramificación cuesta unos cuantos allMoves en el event loop: solo si targetMs o la admisión la usan.
+    const bool targeted = input.Has("targetMs") && !input.Get("targetMs").IsUndefined();
+    std::optional<CostModel::Features> features;
+    if (targeted || scheduler.admission().active()) {
+        // sin calibrar el modelo supone 1 nodo/µs; engine.ts ya calibra al arrancar y esto queda en nada.
+        CostModel::instance().calibrate();
+        features = CostModel::features(board);
+    }
+    if (targeted) {
+        const auto target = std::chrono::microseconds(static_cast<int64_t>(input.Get("targetMs").As<Number>().DoubleValue() * 1000.0));
+        // el objetivo es de latencia: lo que se espere en la cola no queda para buscar.
+        const auto budget = std::max(target - scheduler.admission().expectedWait(), std::chrono::microseconds(0));
+        depth = CostModel::instance().choose(*features, depth, budget).depth;
+    }
+
+    const auto levels = MinimaxAsyncWorker::levelsFor(depth, features);
+    auto& requested = scheduler.stats().forClass(levels.front().key);
+    requested.requests.fetch_add(1, std::memory_order_relaxed);
+
+    // Posición ya resuelta o en búsqueda: no pasa por admisión, no cuesta tiempo de pool.
+    auto worker = new MinimaxAsyncWorker(env, board, depth, std::move(packed), deferred);
+    try {
+        worker->SetProgress(input);
+    } catch (...) {
+        delete worker;
+        throw;
+    }
+    if (worker->Serve(MinimaxAsyncWorker::cacheKey(board, depth), requested))
+        return deferred.Promise();
+
+    auto ticket = scheduler.admission().admit(levels);
+    if (!ticket) {
+        requested.rejected.fetch_add(1, std::memory_order_relaxed);
+        delete worker;
+        deferred.Reject(EngineAsyncWorker::Overloaded(env).Value());
+        return deferred.Promise();
+    }
+    if (ticket->level)
+        requested.downgraded.fetch_add(1, std::memory_order_relaxed);
+
+    depth -= static_cast<int>(ticket->level);
+    worker->SetDepth(depth);
+    if (features)
+        worker->SetFeatures(*features);
+    if (targeted)
+        worker->SetPrediction(CostModel::instance().predict(*features, depth));
+    worker->Lead(MinimaxAsyncWorker::cacheKey(board, depth));
+    worker->SetTicket(std::move(*ticket));
+    worker->Queue(MinimaxAsyncWorker::slackFor(depth));
     return deferred.Promise();
 }
 
+// JS signature: minimaxBatchAsync({boards, depth, out?, ttEntries?}): Promise<Int32Array>
+// `boards` holds N column-major boards back to back (Uint8Array of 25*N); the result has one
+// packed record per board (see PackedResult.h), N * 15 int32 in total. Analysis batches skip
+// admission control and the result cache; they share the pool through time slicing.
+Value MinimaxBatchAsync(const CallbackInfo& info) {
+    Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsObject()) {
+        throw TypeError::New(env, "minimaxBatchAsync(input) expects {boards, depth}");
+    }
+
+    auto input = info[0].As<Object>();
+    if (!input.Has("boards") || !input.Get("boards").IsTypedArray() ||
+        input.Get("boards").As<TypedArray>().TypedArrayType() != napi_uint8_array) {
+        throw TypeError::New(env, "minimaxBatchAsync expects boards: Uint8Array(25 * N)");
+    }
+
+    auto inputBoards = input.Get("boards").As<TypedArrayOf<uint8_t>>();
+    if (inputBoards.ElementLength() % 25) {
+        throw TypeError::New(env, "boards length must be a multiple of 25");
+    }
+
+    std::vector<std::array<uint8_t, 25>> boards(inputBoards.ElementLength() / 25);
+    if (!boards.empty())
+        std::memcpy(boards.data(), inputBoards.Data(), boards.size() * 25);
+
+    const int depth = input.Get("depth").As<Number>().Uint32Value();
+
+    size_t ttEntries = size_t{1} << 20;
+    if (input.Has("ttEntries") && input.Get("ttEntries").IsNumber()) {
+        ttEntries = input.Get("ttEntries").As<Number>().Uint32Value();
+    }
+
+    Reference<Int32Array> out;
+    if (input.Has("out") && !input.Get("out").IsUndefined()) {
+        const auto value = input.Get("out");
+        if (!value.IsTypedArray() || value.As<TypedArray>().TypedArrayType() != napi_int32_array) {
+            throw TypeError::New(env, "out must be an Int32Array");
+        }
+        if (value.As<Int32Array>().ElementLength() < boards.size() * PackedResult::kLength) {
+            throw TypeError::New(env, "out must hold at least " + std::to_string(boards.size() * PackedResult::kLength) + " elements");
+        }
+        out = Persistent(value.As<Int32Array>());
+    }
+
+    auto deferred = Promise::Deferred::New(env);
+
+    const auto key = "minimax-batch:" + std::to_string(depth);
+    EngineScheduler::instance().stats().forClass(key).requests.fetch_add(1, std::memory_order_relaxed);
+
+    auto worker = new MinimaxBatchWorker(env, std::move(boards), depth, ttEntries, std::move(out), deferred);
+    worker->SetClass(key);
+    worker->Queue(MinimaxAsyncWorker::slackFor(depth));
+    return deferred.Promise();
+}
+
+// Reglas síncronas: trabajan sobre el Uint8Array del tablero sin copiarlo a objetos JS.
+rules::Cells RulesBoard(const CallbackInfo& info, const char* name) {
+    if (info.Length() < 1 || !info[0].IsTypedArray() || info[0].As<TypedArray>().TypedArrayType() != napi_uint8_array ||
+        info[0].As<TypedArray>().ElementLength() != 25) {
+        throw TypeError::New(info.Env(), std::string(name) + " expects board: Uint8Array(25)");
+    }
+
+    rules::Cells board;
+    std::memcpy(board.data(), info[0].As<Uint8Array>().Data(), board.size());
+    return board;
+}
+
+int RulesInt(const CallbackInfo& info, const size_t i, const char* name) {
+    if (info.Length() <= i || !info[i].IsNumber()) {
+        throw TypeError::New(info.Env(), std::string(name) + " expects numeric arguments");
+    }
+    return info[i].As<Number>().Int32Value();
+}
+
+PieceKind RulesPlayer(const CallbackInfo& info, const size_t i, const char* name) {
+    const auto player = static_cast<PieceKind>(RulesInt(info, i, name));
+    if (player != PieceKind::BLACK && player != PieceKind::WHITE) {
+        throw TypeError::New(info.Env(), std::string(name) + " expects player BLACK (1) or WHITE (2)");
+    }
+    return player;
+}
+
+// JS signature: legalTargets(board, index): number. Bit i set = the piece on `index` (col * 5 + row) can slide to cell i.
+Value LegalTargets(const CallbackInfo& info) {
+    const auto board = RulesBoard(info, "legalTargets");
+    return Number::New(info.Env(), rules::targets(board, RulesInt(info, 1, "legalTargets")));
+}
+
+// JS signature: legalTurns(board, player, out?): Int32Array of [neutronTo, pawnFrom, pawnTo] triples,
+// pawn cells -1 when the neutron move ends the game. With `out` (at least 3 * 320 elements) the
+// result is a view of it.
+Value LegalTurns(const CallbackInfo& info) {
+    Env env = info.Env();
+    const auto board = RulesBoard(info, "legalTurns");
+    const auto player = RulesPlayer(info, 1, "legalTurns");
+
+    std::array<rules::Turn, rules::kMaxTurns> turns;
+    const auto count = rules::turns(board, player, turns.data());
+
+    Int32Array out;
+    if (info.Length() > 2 && !info[2].IsUndefined()) {
+        if (!info[2].IsTypedArray() || info[2].As<TypedArray>().TypedArrayType() != napi_int32_array ||
+            info[2].As<Int32Array>().ElementLength() < rules::kMaxTurns * 3) {
+            throw TypeError::New(env, "out must be an Int32Array of at least " + std::to_string(rules::kMaxTurns * 3) + " elements");
+        }
+        const auto buffer = info[2].As<Int32Array>();
+        out = Int32Array::New(env, count * 3, buffer.ArrayBuffer(), buffer.ByteOffset());
+    } else {
+        out = Int32Array::New(env, count * 3);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        out[i * 3] = turns[i].neutronTo;
+        out[i * 3 + 1] = turns[i].pawnFrom;
+        out[i * 3 + 2] = turns[i].pawnTo;
+    }
+    return out;
+}
+
+// JS signature: gameWinner(board, mover): number. BLACK/WHITE once `mover` has moved, CELL (4) while the game goes on.
+Value GameWinner(const CallbackInfo& info) {
+    const auto board = RulesBoard(info, "gameWinner");
+    return Number::New(info.Env(), static_cast<int>(rules::winner(board, RulesPlayer(info, 1, "gameWinner"))));
+}
+
+// JS signature: validateTurn(board, player, neutronFrom, neutronTo, pawnFrom, pawnTo): boolean (cells as col * 5 + row).
+Value ValidateTurn(const CallbackInfo& info) {
+    const auto board = RulesBoard(info, "validateTurn");
+    const auto player = RulesPlayer(info, 1, "validateTurn");
+    return Boolean::New(info.Env(),
+                        rules::valid(board,
+                                     player,
+                                     RulesInt(info, 2, "validateTurn"),
+                                     RulesInt(info, 3, "validateTurn"),
+                                     RulesInt(info, 4, "validateTurn"),
+                                     RulesInt(info, 5, "validateTurn")));
+}
+
+rules::Cells CodecBoard(Env env, const Napi::Value& value, const char* name) {
+    if (!value.IsTypedArray() || value.As<TypedArray>().TypedArrayType() != napi_uint8_array ||
+        value.As<TypedArray>().ElementLength() != 25) {
+        throw TypeError::New(env, std::string(name) + " must be a Uint8Array(25)");
+    }
+
+    rules::Cells board;
+    std::memcpy(board.data(), value.As<Uint8Array>().Data(), board.size());
+    return board;
+}
+
+Uint8Array CodecCells(Env env, const rules::Cells& board) {
+    auto out = Uint8Array::New(env, board.size());
+    std::memcpy(out.Data(), board.data(), board.size());
+    return out;
+}
+
+// Campos opcionales de encodeGame(): -1 (codec::kNone) cuando faltan.
+int CodecInt(const Object& input, const char* name) {
+    return input.Has(name) && input.Get(name).IsNumber() ? input.Get(name).As<Number>().Int32Value() : codec::kNone;
+}
+
+codec::Game CodecRecord(const CallbackInfo& info, const char* name) {
+    Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsTypedArray() || info[0].As<TypedArray>().TypedArrayType() != napi_uint8_array) {
+        throw TypeError::New(env, std::string(name) + " expects a Uint8Array game record");
+    }
+
+    const auto bytes = info[0].As<Uint8Array>();
+    try {
+        return codec::decode(bytes.Data(), bytes.ElementLength());
+    } catch (const std::invalid_argument& e) {
+        throw Error::New(env, e.what());
+    }
+}
+
+// JS signature: encodePosition(board, phase): number | null (key < 2^36, see GameCodec.h).
+Value EncodePosition(const CallbackInfo& info) {
+    const auto board = RulesBoard(info, "encodePosition");
+    const auto key = codec::rank(board, RulesInt(info, 1, "encodePosition"));
+    return key ? Number::New(info.Env(), static_cast<double>(*key)) : info.Env().Null();
+}
+
+// JS signature: decodePosition(key): {board: Uint8Array(25), phase}
+Value DecodePosition(const CallbackInfo& info) {
+    Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+        throw TypeError::New(env, "decodePosition(key) expects a number");
+    }
+
+    int phase = 0;
+    rules::Cells board;
+    try {
+        board = codec::unrank(static_cast<uint64_t>(info[0].As<Number>().Int64Value()), phase);
+    } catch (const std::invalid_argument& e) {
+        throw Error::New(env, e.what());
+    }
+
+    auto out = Object::New(env);
+    out.Set("board", CodecCells(env, board));
+    out.Set("phase", Number::New(env, phase));
+    return out;
+}
+
+// JS signature: encodeGame({start, board, phase, version, difficulty, selected?, neutronFrom?, neutronTo?, moves, scores?}):
+// Uint8Array | null. `moves` is an Int32Array of [neutronFrom, neutronTo, pawnFrom, pawnTo, pawnKind] per full move,
+// `scores` a Float64Array with one score per move; null when the game cannot be stored exactly (see GameCodec.h).
+Value EncodeGame(const CallbackInfo& info) {
+    Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsObject()) {
+        throw TypeError::New(env, "encodeGame(record) expects an object");
+    }
+
+    const auto input = info[0].As<Object>();
+    codec::Game game;
+    game.start = CodecBoard(env, input.Get("start"), "start");
+    game.board = CodecBoard(env, input.Get("board"), "board");
+    game.phase = CodecInt(input, "phase");
+    game.version = input.Get("version").As<Number>().Int64Value();
+    game.difficulty = input.Get("difficulty").As<Number>().Uint32Value();
+    game.selected = CodecInt(input, "selected");
+    game.neutronFrom = CodecInt(input, "neutronFrom");
+    game.neutronTo = CodecInt(input, "neutronTo");
+
+    const auto moves = input.Get("moves");
+    if (!moves.IsTypedArray() || moves.As<TypedArray>().TypedArrayType() != napi_int32_array ||
+        moves.As<TypedArray>().ElementLength() % 5) {
+        throw TypeError::New(env, "moves must be an Int32Array of 5 values per move");
+    }
+    const auto played = moves.As<Int32Array>();
+    for (size_t i = 0; i < played.ElementLength(); i += 5) {
+        game.moves.push_back({played[i], played[i + 1], played[i + 2], played[i + 3], static_cast<uint8_t>(played[i + 4])});
+    }
+
+    if (input.Has("scores") && !input.Get("scores").IsUndefined()) {
+        const auto scores = input.Get("scores");
+        if (!scores.IsTypedArray() || scores.As<TypedArray>().TypedArrayType() != napi_float64_array) {
+            throw TypeError::New(env, "scores must be a Float64Array");
+        }
+        const auto values = scores.As<Float64Array>();
+        game.scores.assign(values.Data(), values.Data() + values.ElementLength());
+    }
+
+    const auto bytes = codec::encode(game);
+    if (!bytes)
+        return env.Null();
+
+    auto out = Uint8Array::New(env, bytes->size());
+    std::memcpy(out.Data(), bytes->data(), bytes->size());
+    return out;
+}
+
+// JS signature: decodeGame(bytes): the encodeGame() record, with scores always present.
+Value DecodeGame(const CallbackInfo& info) {
+    Env env = info.Env();
+    const auto game = CodecRecord(info, "decodeGame");
+
+    auto moves = Int32Array::New(env, game.moves.size() * 5);
+    auto scores = Float64Array::New(env, game.scores.size());
+    for (size_t i = 0; i < game.moves.size(); i++) {
+        const auto& move = game.moves[i];
+        moves[i * 5] = move.neutronFrom;
+        moves[i * 5 + 1] = move.neutronTo;
+        moves[i * 5 + 2] = move.pawnFrom;
+        moves[i * 5 + 3] = move.pawnTo;
+        moves[i * 5 + 4] = move.pawnKind;
+        scores[i] = game.scores[i];
+    }
+
+    auto out = Object::New(env);
+    out.Set("start", CodecCells(env, game.start));
+    out.Set("board", CodecCells(env, game.board));
+    out.Set("phase", Number::New(env, game.phase));
+    out.Set("version", Number::New(env, static_cast<double>(game.version)));
+    out.Set("difficulty", Number::New(env, game.difficulty));
+    out.Set("selected", Number::New(env, game.selected));
+    out.Set("neutronFrom", Number::New(env, game.neutronFrom));
+    out.Set("neutronTo", Number::New(env, game.neutronTo));
+    out.Set("moves", moves);
+    out.Set("scores", scores);
+    return out;
+}
+
+// JS signature: replayGame(bytes, plies?): Uint8Array(25), the plain board after the first `plies` full moves (default all).
+Value ReplayGame(const CallbackInfo& info) {
+    const auto game = CodecRecord(info, "replayGame");
+    size_t plies = game.moves.size();
+    if (info.Length() > 1 && info[1].IsNumber()) {
+        plies = info[1].As<Number>().Uint32Value();
+    }
+    return CodecCells(info.Env(), codec::replay(game, plies));
+}
+
+// JS signature: calibrateCostModel(): {nodesPerSecond, alpha, beta, samples}. Times a few searches (~100ms) on the
+// calling thread the first time, so call it at startup rather than on the first targetMs request; later calls
+// return the current fit.
+Value CalibrateCostModel(const CallbackInfo& info) {
+    Env env = info.Env();
+    const auto summary = CostModel::instance().calibrate();
+
+    auto out = Object::New(env);
+    out.Set("nodesPerSecond", Number::New(env, summary.nodesPerSecond));
+    out.Set("alpha", Number::New(env, summary.alpha));
+    out.Set("beta", Number::New(env, summary.beta));
+    out.Set("samples", Number::New(env, static_cast<double>(summary.samples)));
+    return out;
+}
+
 Object Init(Env env, Object exports) {
+    EngineAsyncWorker::Attach(env);
     exports.Set("minimaxAsync", Function::New(env, MinimaxAsync));
+    exports.Set("minimaxBatchAsync", Function::New(env, MinimaxBatchAsync));
+    exports.Set("legalTargets", Function::New(env, LegalTargets));
+    exports.Set("legalTurns", Function::New(env, LegalTurns));
+    exports.Set("gameWinner", Function::New(env, GameWinner));
+    exports.Set("validateTurn", Function::New(env, ValidateTurn));
+    exports.Set("encodePosition", Function::New(env, EncodePosition));
+    exports.Set("decodePosition", Function::New(env, DecodePosition));
+    exports.Set("encodeGame", Function::New(env, EncodeGame));
+    exports.Set("decodeGame", Function::New(env, DecodeGame));
+    exports.Set("replayGame", Function::New(env, ReplayGame));
+    exports.Set("calibrateCostModel", Function::New(env, CalibrateCostModel));
+    exports.Set("configureEngine", Function::New(env, EngineAsyncWorker::Configure));
+    exports.Set("getStats", Function::New(env, EngineAsyncWorker::Stats));
     return exports;
 }
 
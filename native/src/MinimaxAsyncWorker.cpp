@@ -23,48 +23,173 @@
 #include <minimax.h>
 #include <napi.h>
 
+#include <algorithm>
+#include <cmath>
 #include <limits>
+#include <string>
 
-void MinimaxAsyncWorker::Execute() {
-    try {
-        auto board = std::make_unique<Board>(inputBoard);
-        constexpr int alpha = std::numeric_limits<int>::min();
-        constexpr int beta = std::numeric_limits<int>::max();
+namespace {
 
-        const auto fm = maxValue(board, depth, alpha, beta, PieceKind::BLACK);
+Napi::Array movesToJs(Napi::Env env, const std::vector<ResultCache::Move>& moves) {
+    Napi::Array out = Napi::Array::New(env);
 
+    int i = 0;
+    for (const auto& move : moves) {
+        auto jm = Napi::Object::New(env);
+        jm.Set("row", Napi::Number::New(env, move.row));
+        jm.Set("col", Napi::Number::New(env, move.col));
+        jm.Set("kind", Napi::Number::New(env, move.kind));
+        out.Set(i++, jm);
+    }
+    return out;
+}
+
+}  // namespace
+
+std::chrono::microseconds MinimaxAsyncWorker::slackFor(const int depth) {
+    // ~x8 de trabajo por ply extra; tope de ~33s a partir de depth 6.
+    const int plies = std::clamp(depth - 1, 0, 5);
+    return std::chrono::microseconds(1000LL << (3 * plies));
+}
+
+std::vector<AdmissionControl::Level> MinimaxAsyncWorker::levelsFor(const int depth, const std::optional<CostModel::Features>& features) {
+    std::vector<AdmissionControl::Level> levels;
+    for (int d = depth; d >= std::min(depth, 1); d--) {
+        // la holgura (~33s a depth 6) no sirve de coste si se va a rechazar o degradar: nada profundo cabría.
+        levels.push_back({"minimax:" + std::to_string(d), features ? CostModel::instance().predict(*features, d).time : slackFor(d)});
+    }
+    return levels;
+}
+
+ResultCache::Key MinimaxAsyncWorker::cacheKey(const std::array<uint8_t, 25>& board, const int depth) {
+    return {board, static_cast<uint8_t>(PieceKind::BLACK), "minimax:" + std::to_string(depth), 0};
+}
+
+bool MinimaxAsyncWorker::ExecuteSlice() {
+    constexpr int alpha = std::numeric_limits<int>::min();
+    constexpr int beta = std::numeric_limits<int>::max();
+
+    for (;;) {
+        if (!search) {
+            // con onProgress: profundización iterativa, para tener siempre una jugada completa que anunciar.
+            searching = WantsProgress() ? std::min<int>(searching + 1, depth) : depth;
+            board = std::make_unique<Board>(inputBoard);
+            search.emplace(maxValue(slice, board, searching, alpha, beta, PieceKind::BLACK));
+        }
+
+        if (!search->step(slice)) {
+            ReportProgress();
+            return false;
+        }
+
+        const auto fm = search->take();
+        search.reset();
         if (!fm)
-            throw new std::runtime_error("no 'fullmove' returned from minimax");
+            throw std::runtime_error("no 'fullmove' returned from minimax");
+
+        best = ResultCache::Value{static_cast<double>(fm->score), searching, {}};
+        for (const auto& move : fm->moves) best.moves.push_back({move->row, move->col, static_cast<int>(move->kind)});
 
-        result = std::make_unique<FullMove>(*fm);
-    } catch (const std::exception& ex) {
-        SetError(ex.what());
-    } catch (...) {
-        SetError("Unknown error in MinimaxAsyncWorker");
+        if (searching >= depth) {
+            Adopt(best);
+            return true;
+        }
+        ReportProgress();
     }
 }
 
+void MinimaxAsyncWorker::ReportProgress() {
+    // hasta completar la primera profundidad no hay jugada que anunciar.
+    if (best.moves.empty() || !ProgressDue())
+        return;
+
+    {
+        std::lock_guard lock(progressMutex);
+        progress = best;
+        progressNodes = slice.units;
+    }
+    EmitProgress();
+}
+
+ResultCache::Value MinimaxAsyncWorker::CacheValue() const {
+    return result;
+}
+
+void MinimaxAsyncWorker::Adopt(const ResultCache::Value& value) {
+    result = value;
+    depth = static_cast<uint8_t>(value.level);
+
+    if (packed.Enabled()) {
+        // se empaqueta aquí para que OnOK() solo copie enteros en el hilo principal.
+        packed.SetScore(static_cast<int32_t>(value.score));
+        packed.SetLevel(value.level);
+        for (const auto& move : value.moves) packed.Push(move.row, move.col, move.kind);
+    }
+}
+
+void MinimaxAsyncWorker::Completed(ClassStats* stats, const uint64_t units, const std::chrono::microseconds busy) {
+    // con onProgress se buscan todas las profundidades: el coste no es el de una sola.
+    if (WantsProgress())
+        return;
+
+    // toda búsqueda alimenta el modelo, no solo las de targetMs: de él salen también los costes de admisión.
+    if (!features)
+        features = CostModel::features(inputBoard);
+    CostModel::instance().record(*features, depth, units, busy);
+    if (!prediction)
+        return;
+
+    predictionError = static_cast<double>(busy.count()) / static_cast<double>(std::max<int64_t>(prediction->time.count(), 1)) - 1.0;
+    if (stats)
+        stats->predictionErrorPct.record(static_cast<uint64_t>(std::lround(std::abs(*predictionError) * 100.0)));
+}
+
+uint64_t MinimaxAsyncWorker::WorkUnits() const {
+    return slice.units;
+}
+
 void MinimaxAsyncWorker::OnOK() {
     Napi::Env env = Env();
 
-    Napi::Object out = Napi::Object::New(env);
-    Napi::Array moves = Napi::Array::New(env);
-
-    int i = 0;
-    for (const auto& move : result->moves) {
-        auto jm = Napi::Object::New(env);
-        jm.Set("row", Napi::Number::New(env, move->row));
-        jm.Set("col", Napi::Number::New(env, move->col));
-        jm.Set("kind", Napi::Number::New(env, static_cast<int>(move->kind)));
-        moves.Set(i++, jm);
+    if (packed.Enabled()) {
+        deferred.Resolve(packed.ToValue(env));
+        return;
     }
 
-    out.Set("moves", moves);
-    out.Set("score", Napi::Number::New(env, result->score));
+    Napi::Object out = Napi::Object::New(env);
+    out.Set("moves", movesToJs(env, result.moves));
+    out.Set("score", Napi::Number::New(env, result.score));
+    out.Set("depth", Napi::Number::New(env, depth));
+    if (prediction)
+        out.Set("predictedMs", Napi::Number::New(env, static_cast<double>(prediction->time.count()) / 1000.0));
+    if (predictionError)
+        out.Set("predictionError", Napi::Number::New(env, *predictionError));
 
     deferred.Resolve(out);
 }
 
+void MinimaxAsyncWorker::OnProgress(Napi::Env env, Napi::Function callback) {
+    ResultCache::Value snapshot;
+    uint64_t nodes = 0;
+    {
+        std::lock_guard lock(progressMutex);
+        snapshot = progress;
+        nodes = progressNodes;
+    }
+
+    Napi::Object out = Napi::Object::New(env);
+    out.Set("depth", Napi::Number::New(env, snapshot.level));
+    out.Set("score", Napi::Number::New(env, snapshot.score));
+    out.Set("nodes", Napi::Number::New(env, static_cast<double>(nodes)));
+    out.Set("moves", movesToJs(env, snapshot.moves));
+    callback.Call({out});
+}
+
 void MinimaxAsyncWorker::OnError(const Napi::Error& e) {
     deferred.Reject(e.Value());
 }
+
+void MinimaxAsyncWorker::DropHandles() {
+    EngineAsyncWorker::DropHandles();
+    packed.DropHandles();
+}
@@ -0,0 +1,108 @@
+/**
+ * Authors:
+ * Rigoberto Leander Salgado Reyes <rlsalgado2006@gmail.com>
+ *
+ * Copyright 2025 by Rigoberto Leander Salgado Reyes.
+ *
+ * This program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ */
+
+#include <MinimaxBatchWorker.h>
+#include <PackedResult.h>
+#include <PieceKind.h>
+#include <minimax.h>
+#include <napi.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+MinimaxBatchWorker::MinimaxBatchWorker(Napi::Env env,
+                                       std::vector<std::array<uint8_t, 25>> pboards,
+                                       const int pdepth,
+                                       const size_t ttEntries,
+                                       Napi::Reference<Napi::Int32Array> pout,
+                                       Napi::Promise::Deferred pdeferred)
+    : EngineAsyncWorker(env),
+      boards(std::move(pboards)),
+      depth(static_cast<uint8_t>(pdepth)),
+      table(ttEntries),
+      results(boards.size() * PackedResult::kLength),
+      out(std::move(pout)),
+      deferred(std::move(pdeferred)) {
+    const auto count = std::min<size_t>(EngineScheduler::instance().threadCount(), boards.size());
+    for (size_t i = 0; i < std::max<size_t>(count, 1); i++) lanes.push_back(std::make_unique<Lane>(table));
+}
+
+unsigned MinimaxBatchWorker::Lanes() const {
+    return static_cast<unsigned>(lanes.size());
+}
+
+bool MinimaxBatchWorker::ExecuteLane(const unsigned index) {
+    constexpr int alpha = std::numeric_limits<int>::min();
+    constexpr int beta = std::numeric_limits<int>::max();
+
+    auto& lane = *lanes[index];
+    for (;;) {
+        if (!lane.search) {
+            lane.position = next.fetch_add(1, std::memory_order_relaxed);
+            if (lane.position >= boards.size()) {
+                if (auto* stats = ClassStats::current()) {
+                    stats->ttProbes.fetch_add(lane.tt.probes, std::memory_order_relaxed);
+                    stats->ttHits.fetch_add(lane.tt.hits, std::memory_order_relaxed);
+                }
+                return true;
+            }
+
+            lane.board = std::make_unique<Board>(boards[lane.position]);
+            lane.search.emplace(maxValue(lane.slice, lane.board, depth, alpha, beta, PieceKind::BLACK, &lane.tt));
+        }
+
+        // el slice sigue corriendo con la siguiente posición hasta agotar su presupuesto.
+        if (!lane.search->step(lane.slice))
+            return false;
+
+        const auto fm = lane.search->take();
+        lane.search.reset();
+        if (!fm)
+            throw std::runtime_error("no 'fullmove' returned from minimax");
+
+        auto* packed = results.data() + lane.position * PackedResult::kLength;
+        packed[0] = fm->score;
+        packed[1] = static_cast<int32_t>(std::min(fm->moves.size(), PackedResult::kMaxMoves));
+        for (size_t i = 0; i < static_cast<size_t>(packed[1]); i++) {
+            packed[PackedResult::kHeader + i * 3] = fm->moves[i]->row;
+            packed[PackedResult::kHeader + i * 3 + 1] = fm->moves[i]->col;
+            packed[PackedResult::kHeader + i * 3 + 2] = static_cast<int32_t>(fm->moves[i]->kind);
+        }
+        packed[PackedResult::kLevel] = depth;
+    }
+}
+
+uint64_t MinimaxBatchWorker::WorkUnits() const {
+    uint64_t units = 0;
+    for (const auto& lane : lanes) units += lane->slice.units;
+    return units;
+}
+
+void MinimaxBatchWorker::OnOK() {
+    Napi::Env env = Env();
+
+    auto array = out.IsEmpty() ? Napi::Int32Array::New(env, results.size()) : out.Value();
+    std::memcpy(array.Data(), results.data(), results.size() * sizeof(int32_t));
+    deferred.Resolve(array);
+}
+
+void MinimaxBatchWorker::OnError(const Napi::Error& e) {
+    deferred.Reject(e.Value());
+}
+
+void MinimaxBatchWorker::DropHandles() {
+    EngineAsyncWorker::DropHandles();
+    out.SuppressDestruct();
+}
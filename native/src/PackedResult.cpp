@@ -0,0 +1,78 @@
+/**
+ * Authors:
+ * Rigoberto Leander Salgado Reyes <rlsalgado2006@gmail.com>
+ *
+ * Copyright 2025 by Rigoberto Leander Salgado Reyes.
+ *
+ * This program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ */
+
+#include <PackedResult.h>
+#include <napi.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+PackedResult PackedResult::FromInput(Napi::Env env, const Napi::Object& input) {
+    PackedResult result;
+
+    if (input.Has("out") && !input.Get("out").IsUndefined()) {
+        const auto value = input.Get("out");
+        if (!value.IsTypedArray() || value.As<Napi::TypedArray>().TypedArrayType() != napi_int32_array) {
+            throw Napi::TypeError::New(env, "out must be an Int32Array");
+        }
+
+        const auto buffer = value.As<Napi::Int32Array>();
+        if (buffer.ElementLength() < kLength) {
+            throw Napi::TypeError::New(env, "out must hold at least " + std::to_string(kLength) + " elements");
+        }
+
+        result.out = Napi::Persistent(buffer);
+        result.enabled = true;
+    }
+
+    if (input.Has("packed") && input.Get("packed").IsBoolean()) {
+        result.enabled = result.enabled || input.Get("packed").As<Napi::Boolean>().Value();
+    }
+
+    return result;
+}
+
+bool PackedResult::Enabled() const {
+    return enabled;
+}
+
+void PackedResult::SetScore(const int32_t score) {
+    values[0] = score;
+}
+
+void PackedResult::Push(const int32_t row, const int32_t col, const int32_t kind) {
+    const auto count = static_cast<size_t>(values[1]);
+    if (count >= kMaxMoves)
+        throw std::runtime_error("packed result holds at most 4 moves");
+
+    const auto at = kHeader + 3 * count;
+    values[at] = row;
+    values[at + 1] = col;
+    values[at + 2] = kind;
+    values[1] = static_cast<int32_t>(count + 1);
+}
+
+void PackedResult::SetLevel(const int32_t level) {
+    values[kLevel] = level;
+}
+
+void PackedResult::DropHandles() {
+    out.SuppressDestruct();
+}
+
+Napi::Value PackedResult::ToValue(Napi::Env env) const {
+    auto buffer = out.IsEmpty() ? Napi::Int32Array::New(env, kLength) : out.Value();
+    std::copy(values.begin(), values.end(), buffer.Data());
+    return buffer;
+}
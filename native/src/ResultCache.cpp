@@ -0,0 +1,108 @@
+/**
+ * Authors:
+ * Rigoberto Leander Salgado Reyes <rlsalgado2006@gmail.com>
+ *
+ * Copyright 2025 by Rigoberto Leander Salgado Reyes.
+ *
+ * This program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ */
+
+#include <ResultCache.h>
+
+#include <string_view>
+#include <utility>
+
+size_t ResultCache::KeyHash::operator()(const Key &key) const {
+    // FNV-1a sobre el tablero; la clase y el modelo se mezclan al final.
+    uint64_t hash = 1469598103934665603ull;
+    for (const auto cell : key.board) {
+        hash = (hash ^ cell) * 1099511628211ull;
+    }
+    hash = (hash ^ key.side) * 1099511628211ull;
+    hash ^= std::hash<std::string_view>{}(key.klass) + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+    hash ^= key.model + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+    return static_cast<size_t>(hash);
+}
+
+void ResultCache::configure(const size_t pcapacity) {
+    std::lock_guard lock(mutex);
+    capacity = pcapacity;
+    while (lru.size() > capacity) {
+        entries.erase(lru.back().first);
+        lru.pop_back();
+    }
+}
+
+ResultCache::Outcome ResultCache::find(const Key &key, Value &out, Waiter waiter) {
+    std::lock_guard lock(mutex);
+    if (!capacity)
+        return Outcome::Miss;
+
+    if (const auto entry = entries.find(key); entry != entries.end()) {
+        lru.splice(lru.begin(), lru, entry->second);
+        out = entry->second->second;
+        hits.fetch_add(1, std::memory_order_relaxed);
+        return Outcome::Hit;
+    }
+
+    if (const auto flight = inflight.find(key); flight != inflight.end()) {
+        flight->second.push_back(std::move(waiter));
+        coalesced.fetch_add(1, std::memory_order_relaxed);
+        return Outcome::Joined;
+    }
+
+    misses.fetch_add(1, std::memory_order_relaxed);
+    return Outcome::Miss;
+}
+
+void ResultCache::begin(const Key &key) {
+    std::lock_guard lock(mutex);
+    if (capacity)
+        inflight.try_emplace(key);
+}
+
+void ResultCache::publish(const Key &key, const Value *value, const std::string &error) {
+    std::vector<Waiter> waiters;
+    {
+        std::lock_guard lock(mutex);
+        if (const auto flight = inflight.find(key); flight != inflight.end()) {
+            waiters = std::move(flight->second);
+            inflight.erase(flight);
+        }
+
+        if (value && capacity) {
+            if (const auto entry = entries.find(key); entry != entries.end()) {
+                entry->second->second = *value;
+                lru.splice(lru.begin(), lru, entry->second);
+            } else {
+                lru.emplace_front(key, *value);
+                entries.emplace(key, lru.begin());
+                if (lru.size() > capacity) {
+                    entries.erase(lru.back().first);
+                    lru.pop_back();
+                    evictions.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        }
+    }
+
+    // fuera del lock: cada waiter entrega el resultado a su propio entorno JS.
+    for (auto &waiter : waiters) waiter(value, error);
+}
+
+ResultCache::Summary ResultCache::summary() const {
+    std::lock_guard lock(mutex);
+    return Summary{
+        lru.size(),
+        capacity,
+        inflight.size(),
+        hits.load(std::memory_order_relaxed),
+        coalesced.load(std::memory_order_relaxed),
+        misses.load(std::memory_order_relaxed),
+        evictions.load(std::memory_order_relaxed),
+    };
+}
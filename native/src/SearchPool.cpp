@@ -0,0 +1,54 @@
+/**
+ * Authors:
+ * Rigoberto Leander Salgado Reyes <rlsalgado2006@gmail.com>
+ *
+ * Copyright 2025 by Rigoberto Leander Salgado Reyes.
+ *
+ * This program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ */
+
+
+#include <SearchPool.h>
+
+#include <utility>
+
+void SearchPool::configure(const unsigned psize) {
+    std::lock_guard lock(mutex);
+    size = psize;
+}
+
+void SearchPool::enter(Start start) {
+    {
+        std::lock_guard lock(mutex);
+        if (size && active >= size) {
+            waiting.push_back(std::move(start));
+            return;
+        }
+        active++;
+    }
+    start();
+}
+
+void SearchPool::leave() {
+    Start next;
+    {
+        std::lock_guard lock(mutex);
+        if (waiting.empty()) {
+            active--;
+            return;
+        }
+        // el hueco pasa directamente a la siguiente: active no cambia.
+        next = std::move(waiting.front());
+        waiting.pop_front();
+    }
+    next();
+}
+
+SearchPool::Summary SearchPool::summary() const {
+    std::lock_guard lock(mutex);
+    return {size, active, waiting.size()};
+}
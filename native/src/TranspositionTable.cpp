@@ -0,0 +1,64 @@
+/**
+ * Authors:
+ * Rigoberto Leander Salgado Reyes <rlsalgado2006@gmail.com>
+ *
+ * Copyright 2025 by Rigoberto Leander Salgado Reyes.
+ *
+ * This program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ */
+
+#include <Rules.h>
+#include <TranspositionTable.h>
+
+#include <algorithm>
+#include <bit>
+
+namespace {
+
+// un valor sin bits altos podría confundirse con un slot vacío (check = data = 0).
+constexpr uint64_t kOccupied = uint64_t{1} << 32;
+
+}  // namespace
+
+TranspositionTable::TranspositionTable(const size_t entries)
+    : mask(std::bit_ceil(std::max<size_t>(entries, 1)) - 1), slots(std::make_unique<Slot[]>(mask + 1)) {
+}
+
+TranspositionTable::Cursor TranspositionTable::cursor() {
+    return Cursor{*this};
+}
+
+uint64_t TranspositionTable::hash(const std::array<uint8_t, 25> &board) {
+    return rules::hash(board);
+}
+
+uint64_t TranspositionTable::key(const uint64_t position, const PieceKind player, const int depth, const int alpha, const int beta) {
+    const auto window = (static_cast<uint64_t>(static_cast<uint32_t>(alpha)) << 32) | static_cast<uint32_t>(beta);
+    const auto node = (static_cast<uint64_t>(depth) << 8) | static_cast<uint8_t>(player);
+    return position ^ rules::splitmix64(window) ^ rules::splitmix64(node ^ 0x5bd1e995ull);
+}
+
+bool TranspositionTable::Cursor::probe(const uint64_t key, int &score) {
+    probes++;
+
+    auto &slot = table.slots[key & table.mask];
+    const auto data = slot.data.load(std::memory_order_relaxed);
+    if ((slot.check.load(std::memory_order_relaxed) ^ data) != key || !(data & kOccupied))
+        return false;
+
+    hits++;
+    score = static_cast<int>(static_cast<uint32_t>(data));
+    return true;
+}
+
+void TranspositionTable::Cursor::store(const uint64_t key, const int score) {
+    // siempre reemplaza: los nodos recientes son los que se transponen dentro del lote.
+    auto &slot = table.slots[key & table.mask];
+    const auto data = kOccupied | static_cast<uint32_t>(score);
+    slot.check.store(key ^ data, std::memory_order_relaxed);
+    slot.data.store(data, std::memory_order_relaxed);
+}
@@ -17,38 +17,46 @@
 
 #include <limits>
 
-std::unique_ptr<FullMove> maxValue(std::unique_ptr<Board>& board, const int depth, const int alpha, const int beta, const PieceKind player) {
+SearchTask<std::unique_ptr<FullMove>> maxValue(SearchSlice& slice, std::unique_ptr<Board>& board, const int depth, const int alpha, const int beta,
+                                               const PieceKind player, TranspositionTable::Cursor* tt) {
+    co_await slice.checkpoint();
+
     const auto neutron = board->findNeutron();
 
     if (!depth || neutron->row == 0 || neutron->row == 4) {
-        return std::make_unique<FullMove>(std::vector<std::unique_ptr<Move>>(), heuristic(board));
+        co_return std::make_unique<FullMove>(std::vector<std::unique_ptr<Move>>(), heuristic(board));
     }
 
     const auto fullMoves = board->allMoves(player);
 
     auto maxFullMove = std::make_unique<FullMove>(std::vector<std::unique_ptr<Move>>(), alpha);
 
+    const auto opponent = player == PieceKind::BLACK ? PieceKind::WHITE : PieceKind::BLACK;
+
     for (const auto& fullMove : fullMoves) {
         board->applyFullMove(fullMove);
 
-        const auto minFullMove = minValue(                                    //
-            board,                                                            //
-            depth - 1,                                                        //
-            maxFullMove->score,                                               //
-            beta,                                                             //
-            player == PieceKind::BLACK ? PieceKind::WHITE : PieceKind::BLACK  //
-        );
+        // hojas sin tabla: la heurística cuesta menos que el hash.
+        const bool cached = tt && depth > 1;
+        const auto key = cached ? TranspositionTable::key(TranspositionTable::hash(board->cells()), opponent, depth - 1, maxFullMove->score, beta) : 0;
+
+        int score = 0;
+        if (!cached || !tt->probe(key, score)) {
+            score = (co_await minValue(slice, board, depth - 1, maxFullMove->score, beta, opponent, tt))->score;
+            if (cached)
+                tt->store(key, score);
+        }
 
-        if (minFullMove->score > maxFullMove->score) {
+        if (score > maxFullMove->score) {
             *maxFullMove = *fullMove;
-            maxFullMove->score = minFullMove->score;
+            maxFullMove->score = score;
         }
 
         board->applyFullMove(fullMove, false);
 
         if (maxFullMove->score >= beta) {
             fullMove->score = beta;
-            return fullMove->clone();
+            co_return fullMove->clone();
         }
     }
 
@@ -65,44 +73,51 @@ std::unique_ptr<FullMove> maxValue(std::unique_ptr<Board>& board, const int dept
             }
         }
 
-        return tmp;
+        co_return std::move(tmp);
     } else {
-        return maxFullMove;
+        co_return std::move(maxFullMove);
     }
 }
 
-std::unique_ptr<FullMove> minValue(std::unique_ptr<Board>& board, const int depth, const int alpha, const int beta, const PieceKind player) {
+SearchTask<std::unique_ptr<FullMove>> minValue(SearchSlice& slice, std::unique_ptr<Board>& board, const int depth, const int alpha, const int beta,
+                                               const PieceKind player, TranspositionTable::Cursor* tt) {
+    co_await slice.checkpoint();
+
     const auto neutron = board->findNeutron();
 
     if (!depth || neutron->row == 0 || neutron->row == 4) {
-        return std::make_unique<FullMove>(std::vector<std::unique_ptr<Move>>(), heuristic(board));
+        co_return std::make_unique<FullMove>(std::vector<std::unique_ptr<Move>>(), heuristic(board));
     }
 
     const auto fullMoves = board->allMoves(player);
 
     auto minFullMove = std::make_unique<FullMove>(std::vector<std::unique_ptr<Move>>(), beta);
 
+    const auto opponent = player == PieceKind::BLACK ? PieceKind::WHITE : PieceKind::BLACK;
+
     for (const auto& fullMove : fullMoves) {
         board->applyFullMove(fullMove);
 
-        const auto maxFullMove = maxValue(                                    //
-            board,                                                            //
-            depth - 1,                                                        //
-            alpha,                                                            //
-            minFullMove->score,                                               //
-            player == PieceKind::BLACK ? PieceKind::WHITE : PieceKind::BLACK  //
-        );
+        const bool cached = tt && depth > 1;
+        const auto key = cached ? TranspositionTable::key(TranspositionTable::hash(board->cells()), opponent, depth - 1, alpha, minFullMove->score) : 0;
 
-        if (maxFullMove->score < minFullMove->score) {
+        int score = 0;
+        if (!cached || !tt->probe(key, score)) {
+            score = (co_await maxValue(slice, board, depth - 1, alpha, minFullMove->score, opponent, tt))->score;
+            if (cached)
+                tt->store(key, score);
+        }
+
+        if (score < minFullMove->score) {
             *minFullMove = *fullMove;
-            minFullMove->score = maxFullMove->score;
+            minFullMove->score = score;
         }
 
         board->applyFullMove(fullMove, false);
 
         if (alpha >= minFullMove->score) {
             fullMove->score = alpha;
-            return fullMove->clone();
+            co_return fullMove->clone();
         }
     }
 
@@ -119,8 +134,18 @@ std::unique_ptr<FullMove> minValue(std::unique_ptr<Board>& board, const int dept
             }
         }
 
-        return tmp;
+        co_return std::move(tmp);
     } else {
-        return minFullMove;
+        co_return std::move(minFullMove);
     }
 }
+
+std::unique_ptr<FullMove> maxValue(std::unique_ptr<Board>& board, const int depth, const int alpha, const int beta, const PieceKind player) {
+    SearchSlice unlimited;
+    return maxValue(unlimited, board, depth, alpha, beta, player).run(unlimited);
+}
+
+std::unique_ptr<FullMove> minValue(std::unique_ptr<Board>& board, const int depth, const int alpha, const int beta, const PieceKind player) {
+    SearchSlice unlimited;
+    return minValue(unlimited, board, depth, alpha, beta, player).run(unlimited);
+}
@@ -0,0 +1,255 @@
+/**
+ * Authors:
+ * Rigoberto Leander Salgado Reyes <rlsalgado2006@gmail.com>
+ *
+ * Copyright 2025 by Rigoberto Leander Salgado Reyes.
+ *
+ * This program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ */
+
+// GameCodec: posiciones y partidas de juego aleatorio codificadas, decodificadas y rejugadas, más
+// los registros que encode() debe rechazar y los bytes malformados que decode() debe rechazar.
+
+#include <GameCodec.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "check.h"
+
+namespace {
+
+constexpr auto kCell = static_cast<uint8_t>(PieceKind::CELL);
+constexpr auto kNeutron = static_cast<uint8_t>(PieceKind::NEUTRON);
+constexpr auto kBlack = static_cast<uint8_t>(PieceKind::BLACK);
+constexpr auto kWhite = static_cast<uint8_t>(PieceKind::WHITE);
+
+codec::Cells startBoard() {
+    codec::Cells cells;
+    cells.fill(kCell);
+    for (int row = 0; row < 5; row++) {
+        cells[row] = kBlack;
+        cells[20 + row] = kWhite;
+    }
+    cells[12] = kNeutron;
+    return cells;
+}
+
+// Un destino al azar de la máscara (no vacía) de rules::targets().
+int pick(uint32_t mask, std::mt19937 &rng) {
+    for (auto skip = rng() % std::popcount(mask); skip; skip--) mask &= mask - 1;
+    return std::countr_zero(mask);
+}
+
+// Como onClickCell: la pieza seleccionada y sus destinos resaltados.
+codec::Cells highlight(codec::Cells cells, const int selected) {
+    constexpr uint8_t kLit[] = {0, 5, 6, 8, 7};
+    for (auto mask = rules::targets(cells, selected) | uint32_t{1} << selected; mask; mask &= mask - 1) {
+        const int cell = std::countr_zero(mask);
+        cells[cell] = kLit[cells[cell]];
+    }
+    return cells;
+}
+
+// Partida legal al azar, con el tablero tras cada jugada en `boards` (boards[0] = inicial).
+codec::Game randomGame(std::mt19937 &rng, std::vector<codec::Cells> &boards) {
+    codec::Game game;
+    game.start = startBoard();
+    boards = {game.start};
+
+    auto cells = game.start;
+    auto kind = rng() % 2 ? kWhite : kBlack;
+    const auto plies = rng() % 40;
+    for (unsigned ply = 0; ply < plies; ply++) {
+        const int neutron = rules::find(cells, kNeutron);
+        const auto targets = rules::targets(cells, neutron);
+        if (!targets || neutron % 5 == 0 || neutron % 5 == 4)
+            break;
+        const int neutronTo = pick(targets, rng);
+        cells[neutron] = kCell;
+        cells[neutronTo] = kNeutron;
+
+        std::vector<int> pawns;
+        for (int i = 0; i < 25; i++) {
+            if (cells[i] == kind && rules::targets(cells, i))
+                pawns.push_back(i);
+        }
+        if (pawns.empty())
+            break;
+        const int pawn = pawns[rng() % pawns.size()];
+        const int pawnTo = pick(rules::targets(cells, pawn), rng);
+        cells[pawn] = kCell;
+        cells[pawnTo] = kind;
+
+        game.moves.push_back({neutron, neutronTo, pawn, pawnTo, kind});
+        game.scores.push_back(static_cast<double>(static_cast<int>(rng() % 20001) - 10000));
+        boards.push_back(cells);
+        kind = kind == kBlack ? kWhite : kBlack;
+    }
+
+    game.phase = static_cast<int>(rng() % 4);
+    game.version = static_cast<int64_t>(rng() % 200) - 1;
+    game.difficulty = rng() % 5;
+    game.board = cells;
+    if (rng() % 2) {
+        const int neutron = rules::find(cells, kNeutron);
+        game.selected = rng() % 2 ? neutron : rules::find(cells, kind);
+        game.board = highlight(cells, game.selected);
+        game.neutronFrom = rng() % 2 ? neutron : codec::kNone;
+        game.neutronTo = rng() % 2 ? static_cast<int>(rng() % 25) : codec::kNone;
+    }
+    return game;
+}
+
+bool same(const codec::Game &a, const codec::Game &b) {
+    if (a.moves.size() != b.moves.size())
+        return false;
+    for (size_t i = 0; i < a.moves.size(); i++) {
+        const auto &x = a.moves[i];
+        const auto &y = b.moves[i];
+        if (x.neutronFrom != y.neutronFrom || x.neutronTo != y.neutronTo || x.pawnFrom != y.pawnFrom || x.pawnTo != y.pawnTo ||
+            x.pawnKind != y.pawnKind)
+            return false;
+    }
+    return a.start == b.start && a.board == b.board && a.phase == b.phase && a.version == b.version && a.difficulty == b.difficulty &&
+           a.selected == b.selected && a.neutronFrom == b.neutronFrom && a.neutronTo == b.neutronTo && a.scores == b.scores;
+}
+
+bool rejected(const std::vector<uint8_t> &bytes) {
+    try {
+        codec::decode(bytes.data(), bytes.size());
+    } catch (const std::invalid_argument &) {
+        return true;
+    }
+    return false;
+}
+
+void checkPositions(std::mt19937 &rng) {
+    std::set<uint64_t> keys;
+    std::set<std::pair<codec::Cells, int>> positions;
+    for (int i = 0; i < 5000; i++) {
+        auto cells = startBoard();
+        std::ranges::shuffle(cells, rng);
+        const int phase = static_cast<int>(rng() % 4);
+
+        const auto key = codec::rank(cells, phase);
+        CHECK(key.has_value());
+        if (!key)
+            continue;
+        CHECK(*key < (uint64_t{1} << 36));
+        int back = -1;
+        CHECK(codec::unrank(*key, back) == cells);
+        CHECK(back == phase);
+        keys.insert(*key);
+        positions.insert({cells, phase});
+    }
+    // otra posición u otra fase, otra clave.
+    CHECK(keys.size() == positions.size());
+
+    auto cells = startBoard();
+    CHECK(!codec::rank(cells, 4));
+    cells[0] = kCell;
+    CHECK(!codec::rank(cells, 0));
+    int phase = 0;
+    bool threw = false;
+    try {
+        codec::unrank(uint64_t{1} << 40, phase);
+    } catch (const std::invalid_argument &) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+void checkGames(std::mt19937 &rng) {
+    for (int i = 0; i < 3000; i++) {
+        std::vector<codec::Cells> boards;
+        auto game = randomGame(rng, boards);
+        if (i % 3 == 0)
+            game.scores.assign(game.moves.size(), 0.0);
+
+        const auto bytes = codec::encode(game);
+        CHECK(bytes.has_value());
+        if (!bytes)
+            continue;
+        CHECK(bytes->size() <= 24 + 2 * game.moves.size() + 3 * game.moves.size());
+
+        const auto back = codec::decode(bytes->data(), bytes->size());
+        CHECK(same(back, game));
+        for (size_t ply = 0; ply < boards.size(); ply++) CHECK(codec::replay(back, ply) == boards[ply]);
+        CHECK(codec::replay(back, boards.size() + 3) == boards.back());
+
+        // cualquier prefijo o byte de más es un registro malformado.
+        for (size_t size = 0; size < bytes->size(); size++) {
+            CHECK(rejected(std::vector<uint8_t>(bytes->begin(), bytes->begin() + static_cast<long>(size))));
+        }
+        auto longer = *bytes;
+        longer.push_back(0);
+        CHECK(rejected(longer));
+    }
+}
+
+// Lo que no se puede guardar exactamente vuelve como nullopt (engine.ts lo guarda en JSON).
+void checkRejected(std::mt19937 &rng) {
+    std::vector<codec::Cells> boards;
+    codec::Game game;
+    do {
+        game = randomGame(rng, boards);
+    } while (game.moves.empty());
+    CHECK(codec::encode(game).has_value());
+
+    auto fractional = game;
+    fractional.scores[0] = 0.5;
+    CHECK(!codec::encode(fractional));
+
+    auto shortScores = game;
+    shortScores.scores.pop_back();
+    CHECK(!codec::encode(shortScores));
+
+    auto start = game;
+    start.start[0] = kCell;
+    CHECK(!codec::encode(start));
+
+    auto replay = game;
+    replay.moves[0].pawnFrom = replay.moves[0].pawnTo;
+    CHECK(!codec::encode(replay));
+
+    auto kind = game;
+    kind.moves[0].pawnKind = kind.moves[0].pawnKind == kBlack ? kWhite : kBlack;
+    CHECK(!codec::encode(kind));
+
+    auto lit = game;
+    lit.selected = codec::kNone;
+    lit.board[rules::find(rules::plainCells(lit.board), kNeutron)] = static_cast<uint8_t>(PieceKind::SNEUTRON);
+    CHECK(!codec::encode(lit));
+
+    auto empty = game;
+    empty.selected = rules::find(rules::plainCells(empty.board), kCell);
+    empty.board = highlight(rules::plainCells(empty.board), empty.selected);
+    CHECK(!codec::encode(empty));
+
+    CHECK(rejected({}));
+    CHECK(rejected({0x7B, 0x7D}));
+    auto flags = *codec::encode(game);
+    flags[1] = 0xF0;
+    CHECK(rejected(flags));
+}
+
+}  // namespace
+
+int main() {
+    std::mt19937 rng(2025);
+    checkPositions(rng);
+    checkGames(rng);
+    checkRejected(rng);
+    return test::result();
+}
@@ -0,0 +1,261 @@
+/**
+ * Authors:
+ * Rigoberto Leander Salgado Reyes <rlsalgado2006@gmail.com>
+ *
+ * Copyright 2025 by Rigoberto Leander Salgado Reyes.
+ *
+ * This program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ */
+
+// NativeNetwork frente a un forward de referencia en double, escrito aquí capa a capa como el modelo
+// de PyTorch (conv + batch norm sin plegar, bloques residuales, cabezas): pesos aleatorios en un
+// fichero NRLW, posiciones de partidas aleatorias, cada ISA que tenga la CPU y lotes de 1 y de varias.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "check.h"
+#include "neutron_rl/game_state.hpp"
+#include "neutron_rl/native_network.hpp"
+
+using neutron_rl::GameState;
+using neutron_rl::NativeNetwork;
+
+namespace {
+
+constexpr int kChannels = 8;
+constexpr int kBlocks = 2;
+constexpr int kPolicyChannels = 2;
+constexpr int kValueChannels = 1;
+constexpr int kValueHidden = 16;
+constexpr int kCells = 25;
+
+struct Tensor {
+    std::vector<uint32_t> sizes;
+    std::vector<float> values;
+};
+
+using Weights = std::map<std::string, Tensor>;
+
+// Pesos de escala 1/sqrt(fan-in), para que las activaciones no crezcan capa a capa.
+void add(Weights &weights, std::mt19937 &rng, const std::string &name, std::vector<uint32_t> sizes, const int fanIn) {
+    size_t count = 1;
+    for (const auto size : sizes) count *= size;
+    std::uniform_real_distribution<float> dist(-1.0f / std::sqrt(static_cast<float>(fanIn)), 1.0f / std::sqrt(static_cast<float>(fanIn)));
+    Tensor tensor{std::move(sizes), std::vector<float>(count)};
+    for (auto &value : tensor.values) value = dist(rng);
+    weights[name] = std::move(tensor);
+}
+
+void addConv(Weights &weights, std::mt19937 &rng, const std::string &conv, const std::string &bn, const uint32_t in, const uint32_t out, const uint32_t kernel) {
+    add(weights, rng, conv + ".weight", {out, in, kernel, kernel}, static_cast<int>(in * kernel * kernel));
+    add(weights, rng, conv + ".bias", {out}, 1);
+    add(weights, rng, bn + ".weight", {out}, 1);
+    add(weights, rng, bn + ".bias", {out}, 1);
+    add(weights, rng, bn + ".running_mean", {out}, 1);
+    add(weights, rng, bn + ".running_var", {out}, 1);
+    for (auto &var : weights[bn + ".running_var"].values) var = 0.5f + std::abs(var);
+}
+
+Weights randomWeights() {
+    std::mt19937 rng(7);
+    Weights weights;
+    addConv(weights, rng, "input_conv", "input_bn", NativeNetwork::kInputChannels, kChannels, 3);
+    for (int b = 0; b < kBlocks; b++) {
+        const auto block = "res_blocks." + std::to_string(b);
+        addConv(weights, rng, block + ".conv1", block + ".bn1", kChannels, kChannels, 3);
+        addConv(weights, rng, block + ".conv2", block + ".bn2", kChannels, kChannels, 3);
+    }
+    addConv(weights, rng, "policy_conv", "policy_bn", kChannels, kPolicyChannels, 1);
+    add(weights, rng, "policy_fc.weight", {NativeNetwork::kActionSize, kPolicyChannels * kCells}, kPolicyChannels * kCells);
+    add(weights, rng, "policy_fc.bias", {NativeNetwork::kActionSize}, 1);
+    addConv(weights, rng, "value_conv", "value_bn", kChannels, kValueChannels, 1);
+    add(weights, rng, "value_fc1.weight", {kValueHidden, kValueChannels * kCells}, kValueChannels * kCells);
+    add(weights, rng, "value_fc1.bias", {kValueHidden}, 1);
+    add(weights, rng, "value_fc2.weight", {1, kValueHidden}, kValueHidden);
+    add(weights, rng, "value_fc2.bias", {1}, 1);
+    return weights;
+}
+
+void write(const std::string &path, const Weights &weights) {
+    std::ofstream out(path, std::ios::binary);
+    const auto u32 = [&](const uint32_t value) { out.write(reinterpret_cast<const char *>(&value), sizeof(value)); };
+    out.write("NRLW", 4);
+    u32(1);
+    u32(static_cast<uint32_t>(weights.size()));
+    for (const auto &[name, tensor] : weights) {
+        u32(static_cast<uint32_t>(name.size()));
+        out.write(name.data(), static_cast<std::streamsize>(name.size()));
+        u32(static_cast<uint32_t>(tensor.sizes.size()));
+        for (const auto size : tensor.sizes) u32(size);
+        out.write(reinterpret_cast<const char *>(tensor.values.data()), static_cast<std::streamsize>(tensor.values.size() * sizeof(float)));
+    }
+}
+
+using Planes = std::vector<std::vector<double>>;  // [canal][celda]
+
+class Reference {
+   public:
+    explicit Reference(const Weights &pweights) : weights(pweights) {
+    }
+
+    void forward(const float *input, std::vector<double> &policy, double &value) const {
+        Planes x(NativeNetwork::kInputChannels, std::vector<double>(kCells));
+        for (size_t c = 0; c < x.size(); c++)
+            for (int i = 0; i < kCells; i++) x[c][i] = input[c * kCells + i];
+
+        x = relu(batchNorm(conv(x, "input_conv", 3), "input_bn"));
+        for (int b = 0; b < kBlocks; b++) {
+            const auto block = "res_blocks." + std::to_string(b);
+            auto t = relu(batchNorm(conv(x, block + ".conv1", 3), block + ".bn1"));
+            t = batchNorm(conv(t, block + ".conv2", 3), block + ".bn2");
+            for (size_t c = 0; c < t.size(); c++)
+                for (int i = 0; i < kCells; i++) t[c][i] += x[c][i];
+            x = relu(t);
+        }
+
+        policy = linear(flatten(relu(batchNorm(conv(x, "policy_conv", 1), "policy_bn"))), "policy_fc");
+        auto hidden = linear(flatten(relu(batchNorm(conv(x, "value_conv", 1), "value_bn"))), "value_fc1");
+        for (auto &h : hidden) h = std::max(h, 0.0);
+        value = std::tanh(linear(hidden, "value_fc2")[0]);
+    }
+
+   private:
+    const std::vector<float> &at(const std::string &name) const {
+        return weights.at(name).values;
+    }
+
+    Planes conv(const Planes &x, const std::string &name, const int kernel) const {
+        const auto &w = at(name + ".weight");
+        const auto &bias = at(name + ".bias");
+        const int in = static_cast<int>(x.size());
+        const int pad = kernel / 2;
+        Planes y(bias.size(), std::vector<double>(kCells));
+        for (size_t o = 0; o < y.size(); o++) {
+            for (int r = 0; r < 5; r++) {
+                for (int c = 0; c < 5; c++) {
+                    double sum = bias[o];
+                    for (int i = 0; i < in; i++) {
+                        for (int kr = 0; kr < kernel; kr++) {
+                            for (int kc = 0; kc < kernel; kc++) {
+                                const int rr = r + kr - pad, cc = c + kc - pad;
+                                if (rr >= 0 && rr < 5 && cc >= 0 && cc < 5)
+                                    sum += w[((o * in + i) * kernel + kr) * kernel + kc] * x[i][rr * 5 + cc];
+                            }
+                        }
+                    }
+                    y[o][r * 5 + c] = sum;
+                }
+            }
+        }
+        return y;
+    }
+
+    Planes batchNorm(Planes x, const std::string &name) const {
+        const auto &gamma = at(name + ".weight");
+        const auto &beta = at(name + ".bias");
+        const auto &mean = at(name + ".running_mean");
+        const auto &var = at(name + ".running_var");
+        for (size_t c = 0; c < x.size(); c++)
+            for (auto &v : x[c]) v = (v - mean[c]) / std::sqrt(var[c] + 1e-5) * gamma[c] + beta[c];
+        return x;
+    }
+
+    static Planes relu(Planes x) {
+        for (auto &plane : x)
+            for (auto &v : plane) v = std::max(v, 0.0);
+        return x;
+    }
+
+    static std::vector<double> flatten(const Planes &x) {
+        std::vector<double> flat;
+        for (const auto &plane : x) flat.insert(flat.end(), plane.begin(), plane.end());
+        return flat;
+    }
+
+    std::vector<double> linear(const std::vector<double> &x, const std::string &name) const {
+        const auto &w = at(name + ".weight");
+        const auto &bias = at(name + ".bias");
+        std::vector<double> y(bias.size());
+        for (size_t o = 0; o < y.size(); o++) {
+            double sum = bias[o];
+            for (size_t i = 0; i < x.size(); i++) sum += w[o * x.size() + i] * x[i];
+            y[o] = sum;
+        }
+        return y;
+    }
+
+    const Weights &weights;
+};
+
+std::vector<float> randomPositions(const size_t count) {
+    std::mt19937 rng(3);
+    std::vector<float> inputs;
+    size_t positions = 0;
+    while (positions < count) {
+        GameState state;
+        while (!state.is_terminal() && positions < count) {
+            const auto encoded = state.encode();
+            inputs.insert(inputs.end(), encoded.begin(), encoded.end());
+            positions++;
+            const auto actions = state.legal_actions();
+            state = state.apply_action(actions[rng() % actions.size()]);
+        }
+    }
+    return inputs;
+}
+
+}  // namespace
+
+int main() {
+    const auto weights = randomWeights();
+    // ctest la ejecuta en el directorio de build
+    const std::string path = "rl_network_test.bin";
+    write(path, weights);
+
+    constexpr size_t kPositions = 64;
+    const auto inputs = randomPositions(kPositions);
+    const Reference reference(weights);
+    std::vector<std::vector<double>> expectedPolicy(kPositions);
+    std::vector<double> expectedValue(kPositions);
+    for (size_t p = 0; p < kPositions; p++) reference.forward(&inputs[p * 100], expectedPolicy[p], expectedValue[p]);
+
+    for (const auto isa : {NativeNetwork::Isa::Scalar, NativeNetwork::Isa::Avx2, NativeNetwork::Isa::Avx512}) {
+        const auto network = NativeNetwork::load(path, isa);
+        if (network->isa() != isa) {
+            std::printf("%s: not supported by this CPU, skipped\n", NativeNetwork::isa_name(isa));
+            continue;
+        }
+
+        double policyDiff = 0, valueDiff = 0;
+        for (const size_t batch : {size_t{1}, size_t{7}, kPositions}) {
+            std::vector<float> policy(batch * NativeNetwork::kActionSize), value(batch);
+            for (size_t first = 0; first + batch <= kPositions; first += batch) {
+                network->forward(&inputs[first * 100], batch, policy.data(), value.data());
+                for (size_t p = 0; p < batch; p++) {
+                    for (int a = 0; a < NativeNetwork::kActionSize; a++)
+                        policyDiff = std::max(policyDiff, std::abs(policy[p * NativeNetwork::kActionSize + a] - expectedPolicy[first + p][a]));
+                    valueDiff = std::max(valueDiff, std::abs(value[p] - expectedValue[first + p]));
+                }
+            }
+        }
+        std::printf("%s: max |policy logit diff| %.3g, max |value diff| %.3g\n", NativeNetwork::isa_name(isa), policyDiff, valueDiff);
+        CHECK(policyDiff < 1e-4);
+        CHECK(valueDiff < 1e-5);
+    }
+
+    std::filesystem::remove(path);
+    return test::result();
+}
@@ -0,0 +1,315 @@
+/**
+ * Authors:
+ * Rigoberto Leander Salgado Reyes <rlsalgado2006@gmail.com>
+ *
+ * Copyright 2025 by Rigoberto Leander Salgado Reyes.
+ *
+ * This program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ */
+
+// Núcleo de reglas compartido (Rules.h, Board::moves, GameState) frente a las implementaciones
+// que tenía cada motor antes de compartirlo, copiadas aquí como referencia: destinos, orden de
+// jugadas, turnos, ganador y hash sobre posiciones aleatorias y de partidas aleatorias.
+
+#include <Board.h>
+#include <Rules.h>
+#include <TranspositionTable.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "check.h"
+#include "neutron_rl/game_state.hpp"
+
+using neutron_rl::GameState;
+using neutron_rl::Phase;
+
+namespace {
+
+constexpr auto kCell = static_cast<uint8_t>(PieceKind::CELL);
+constexpr auto kNeutron = static_cast<uint8_t>(PieceKind::NEUTRON);
+constexpr auto kBlack = static_cast<uint8_t>(PieceKind::BLACK);
+constexpr auto kWhite = static_cast<uint8_t>(PieceKind::WHITE);
+
+namespace reference {
+
+// (fila, columna) en el orden del antiguo Board::moves(): N, S, E, O, NE, NO, SE, SO.
+constexpr int kBoardDeltas[8][2] = {{-1, 0}, {1, 0}, {0, 1}, {0, -1}, {-1, 1}, {-1, -1}, {1, 1}, {1, -1}};
+
+// (fila, columna) de las acciones RL: N, NE, E, SE, S, SO, O, NO.
+constexpr int kRlDeltas[8][2] = {{-1, 0}, {-1, 1}, {0, 1}, {1, 1}, {1, 0}, {1, -1}, {0, -1}, {-1, -1}};
+
+// Casilla más lejana a la que desliza (fila, columna) en una dirección, o nada si no se mueve.
+std::optional<std::pair<int, int>> slide(const rules::Cells &cells, const int row, const int col, const int dr, const int dc) {
+    int r = row;
+    int c = col;
+    while (r + dr >= 0 && r + dr < 5 && c + dc >= 0 && c + dc < 5 && cells[(c + dc) * 5 + r + dr] == kCell) {
+        r += dr;
+        c += dc;
+    }
+    if (r == row && c == col)
+        return std::nullopt;
+    return std::pair{r, c};
+}
+
+// Destinos de Board::moves(), en su orden.
+std::vector<std::pair<int, int>> moves(const rules::Cells &cells, const int row, const int col) {
+    std::vector<std::pair<int, int>> result;
+    for (const auto &[dr, dc] : kBoardDeltas) {
+        if (auto tip = slide(cells, row, col, dr, dc))
+            result.push_back(*tip);
+    }
+    return result;
+}
+
+uint32_t slides(const rules::Cells &cells, const int index) {
+    uint32_t mask = 0;
+    for (const auto &[row, col] : moves(cells, index % 5, index / 5)) mask |= uint32_t{1} << (col * 5 + row);
+    return mask;
+}
+
+PieceKind outcome(const rules::Cells &cells, const PieceKind mover) {
+    const auto neutron = static_cast<int>(std::find(cells.begin(), cells.end(), kNeutron) - cells.begin());
+    if (neutron == 25)
+        return PieceKind::CELL;
+    if (!slides(cells, neutron))
+        return mover;
+    if (neutron % 5 == 0)
+        return PieceKind::BLACK;
+    if (neutron % 5 == 4)
+        return PieceKind::WHITE;
+    return PieceKind::CELL;
+}
+
+std::vector<rules::Turn> turns(rules::Cells cells, const PieceKind player) {
+    std::vector<rules::Turn> result;
+    const auto neutron = static_cast<int>(std::find(cells.begin(), cells.end(), kNeutron) - cells.begin());
+    if (neutron == 25)
+        return result;
+
+    for (int neutronTo = 0; neutronTo < 25; neutronTo++) {
+        if (!(slides(cells, neutron) >> neutronTo & 1))
+            continue;
+        cells[neutron] = kCell;
+        cells[neutronTo] = kNeutron;
+        if (outcome(cells, player) != PieceKind::CELL) {
+            result.push_back({neutronTo, rules::kNone, rules::kNone});
+        } else {
+            for (int pawn = 0; pawn < 25; pawn++) {
+                if (cells[pawn] != static_cast<uint8_t>(player))
+                    continue;
+                for (int pawnTo = 0; pawnTo < 25; pawnTo++) {
+                    if (slides(cells, pawn) >> pawnTo & 1)
+                        result.push_back({neutronTo, pawn, pawnTo});
+                }
+            }
+        }
+        cells[neutronTo] = kCell;
+        cells[neutron] = kNeutron;
+    }
+    return result;
+}
+
+// Zobrist del antiguo TranspositionTable::hash().
+uint64_t splitmix64(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ull;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+uint64_t hash(const rules::Cells &cells) {
+    uint64_t hash = 0;
+    for (size_t i = 0; i < cells.size(); i++) hash ^= splitmix64(i * 9 + cells[i] % 9 + 1);
+    return hash;
+}
+
+// El antiguo GameState de RL, sobre su tablero por filas (0 vacía, 1 y 2 peones, 3 neutrón).
+struct RlState {
+    std::array<int8_t, 25> board;
+    int player;
+    Phase phase;
+
+    [[nodiscard]] int distance(const int cell, const int dir) const {
+        const auto [dr, dc] = kRlDeltas[dir];
+        int distance = 0;
+        for (int r = cell / 5 + dr, c = cell % 5 + dc; r >= 0 && r < 5 && c >= 0 && c < 5 && board[r * 5 + c] == 0;
+             r += dr, c += dc) {
+            distance++;
+        }
+        return distance;
+    }
+
+    [[nodiscard]] std::vector<int> actions() const {
+        std::vector<int> actions;
+        const int piece = phase == Phase::MoveNeutron ? 3 : player;
+        for (int cell = 0; cell < 25; cell++) {
+            if (board[cell] != piece)
+                continue;
+            for (int dir = 0; dir < 8; dir++) {
+                if (const int max = distance(cell, dir))
+                    actions.push_back(cell * 32 + dir * 4 + max - 1);
+            }
+        }
+        return actions;
+    }
+
+    [[nodiscard]] std::optional<int> winner() const {
+        const auto neutron = static_cast<int>(std::find(board.begin(), board.end(), 3) - board.begin());
+        if (neutron / 5 == 0)
+            return 2;
+        if (neutron / 5 == 4)
+            return 1;
+        if (actions().empty())
+            return player == 1 ? 2 : 1;
+        return std::nullopt;
+    }
+};
+
+}  // namespace reference
+
+// Tablero por filas de RL: el jugador 1 mueve los blancos (fila 4), el 2 los negros (fila 0).
+std::array<int8_t, 25> toRl(const rules::Cells &cells) {
+    std::array<int8_t, 25> board{};
+    for (int i = 0; i < 25; i++) {
+        const int cell = (i % 5) * 5 + i / 5;
+        board[cell] = cells[i] == kWhite ? 1 : cells[i] == kBlack ? 2 : cells[i] == kNeutron ? 3 : 0;
+    }
+    return board;
+}
+
+rules::Cells shuffled(std::mt19937 &rng) {
+    rules::Cells cells;
+    cells.fill(kCell);
+    std::fill_n(cells.begin(), 5, kBlack);
+    std::fill_n(cells.begin() + 5, 5, kWhite);
+    cells[10] = kNeutron;
+    std::ranges::shuffle(cells, rng);
+    return cells;
+}
+
+// Posiciones de partidas al azar desde la inicial, con el jugador y la fase de cada una.
+std::vector<GameState> playouts(std::mt19937 &rng, const int games) {
+    std::vector<GameState> states;
+    for (int game = 0; game < games; game++) {
+        GameState state;
+        while (!state.is_terminal()) {
+            states.push_back(state);
+            const auto legal = state.legal_actions();
+            state = state.apply_action(legal[std::uniform_int_distribution<size_t>(0, legal.size() - 1)(rng)]);
+        }
+        states.push_back(state);
+    }
+    return states;
+}
+
+// Las casillas resaltadas (SBLACK..SNEUTRON) cuentan como su tipo simple.
+rules::Cells highlighted(rules::Cells cells, std::mt19937 &rng) {
+    constexpr std::array<uint8_t, 5> kLit = {0, 5, 6, 8, 7};
+    for (auto &cell : cells) {
+        if (rng() % 3 == 0)
+            cell = kLit[cell];
+    }
+    return cells;
+}
+
+void checkBoard(const rules::Cells &cells, std::mt19937 &rng) {
+    Board board(cells);
+    const auto lit = highlighted(cells, rng);
+
+    for (int index = 0; index < 25; index++) {
+        const auto expected = reference::slides(cells, index);
+        CHECK(rules::targets(cells, index) == expected);
+        CHECK(rules::targets(lit, index) == expected);
+        if (cells[index] == kCell)
+            continue;
+
+        const auto start = std::make_unique<Move>(index % 5, index / 5, static_cast<PieceKind>(cells[index]));
+        const auto moves = board.moves(start);
+        const auto want = reference::moves(cells, index % 5, index / 5);
+        CHECK(moves.size() == want.size());
+        for (size_t i = 0; i < std::min(moves.size(), want.size()); i++) {
+            CHECK(moves[i]->row == want[i].first && moves[i]->col == want[i].second);
+            CHECK(moves[i]->kind == start->kind);
+        }
+    }
+
+    for (const auto player : {PieceKind::BLACK, PieceKind::WHITE}) {
+        CHECK(rules::winner(cells, player) == reference::outcome(cells, player));
+        CHECK(rules::winner(lit, player) == reference::outcome(cells, player));
+
+        std::array<rules::Turn, rules::kMaxTurns> out{};
+        const auto count = rules::turns(cells, player, out.data());
+        const auto want = reference::turns(cells, player);
+        CHECK(count == want.size());
+        for (size_t i = 0; i < std::min(count, want.size()); i++) {
+            CHECK(out[i].neutronTo == want[i].neutronTo && out[i].pawnFrom == want[i].pawnFrom && out[i].pawnTo == want[i].pawnTo);
+        }
+        const int neutron = rules::find(cells, kNeutron);
+        for (const auto &turn : want) {
+            CHECK(rules::valid(lit, player, neutron, turn.neutronTo, turn.pawnFrom, turn.pawnTo));
+        }
+    }
+
+    CHECK(TranspositionTable::hash(cells) == reference::hash(cells));
+    CHECK(rules::hash(cells) == reference::hash(cells));
+}
+
+void checkState(const GameState &state) {
+    const auto &cells = state.cells();
+    const reference::RlState old{toRl(cells), state.current_player(), state.phase()};
+
+    const auto actions = state.get_legal_actions();
+    const auto legal = state.legal_actions();
+    CHECK(actions == old.actions());
+    CHECK(std::ranges::equal(legal, actions));
+
+    const auto winner = old.winner();
+    CHECK(state.is_terminal() == winner.has_value());
+    CHECK(state.get_winner() == winner);
+
+    // El hash se mantiene incremental en apply_action(): debe coincidir con el de la posición construida de cero.
+    const GameState fresh(old.board, old.player, old.phase);
+    CHECK(fresh.hash() == state.hash());
+    CHECK(fresh.get_legal_actions() == actions);
+    for (const auto action : actions) {
+        const auto child = state.apply_action(action);
+        CHECK(child.hash() == GameState(child.cells(), child.current_player(), child.phase()).hash());
+    }
+
+    // Mismo tablero con otro jugador o fase: otra clave.
+    const GameState other(old.board, 3 - old.player, old.phase);
+    const GameState turned(old.board, old.player, old.phase == Phase::MoveNeutron ? Phase::MovePawn : Phase::MoveNeutron);
+    CHECK(other.hash() != state.hash());
+    CHECK(turned.hash() != state.hash());
+}
+
+}  // namespace
+
+int main() {
+    std::mt19937 rng(2025);
+
+    for (int i = 0; i < 2000; i++) {
+        const auto cells = shuffled(rng);
+        checkBoard(cells, rng);
+        for (const int player : {1, 2}) {
+            for (const auto phase : {Phase::MoveNeutron, Phase::MovePawn}) checkState(GameState(cells, player, phase));
+        }
+    }
+
+    for (const auto &state : playouts(rng, 200)) {
+        checkBoard(state.cells(), rng);
+        checkState(state);
+    }
+
+    return test::result();
+}
@@ -9,18 +9,30 @@
 * Contact            : rlsalgado2006@gmail.com
 * ===============================================================================
 */
-import { Direction, PieceKind } from "(src)/domain/types";
+import { PieceKind } from "(src)/domain/types";
 import { GameState } from "(src)/domain/GameState";
 import { Move } from "(src)/domain/Move";
 
 import { existsSync } from "node:fs";
+import { performance } from "node:perf_hooks";
 import path from "path";
 import { FullMove } from "(src)/domain/FullMove";
 import { logger } from "(src)/infra/logger";
+import { config } from "(src)/infra/config";
+import { getDefaultBoard } from "(src)/domain/utils";
 
 type NativeMove = { row: number; col: number; kind: number };
-type NativeOutput = { moves: NativeMove[]; score: number };
+// depth/simulations: lo que la búsqueda usó de verdad; el control de admisión puede bajarlo.
+type NativeOutput = { moves: NativeMove[]; score: number; depth?: number; simulations?: number };
+// Solo con targetMs; predictionError = tiempo real / previsto - 1 (ausente si la jugada salió de la caché).
+type CostPrediction = { predictedMs?: number; predictionError?: number };
+// Int32Array [score, count, row0, col0, kind0, ...]; see native/include/PackedResult.h.
+type PackedRequest = { packed?: boolean; out?: Int32Array };
 type RlDifficulty = "easy" | "medium" | "hard";
+// Avisos durante la búsqueda, como mucho uno cada progressIntervalMs (default 100); nunca llegan tras resolverse la promesa.
+export type MinimaxProgress = { depth: number; score: number; nodes: number; moves: NativeMove[] };
+export type RlProgress = { simulations: number; visitShare: number; value: number; moves: NativeMove[] };
+type ProgressRequest<P> = { onProgress?: (progress: P) => void; progressIntervalMs?: number };
 
 function resolveMinimaxAddonPath(): string {
 	const candidates = [
@@ -37,16 +49,157 @@ function resolveMinimaxAddonPath(): string {
 	return found;
 }
 
-const minimaxAddon: { minimaxAsync(input: { board: Uint8Array; depth: number }): Promise<NativeOutput> } =
-	require(resolveMinimaxAddonPath());
+// Celdas col * 5 + row, -1 = ninguna; moves: [neutronFrom, neutronTo, pawnFrom, pawnTo, pawnKind] por jugada.
+type GameRecord = {
+	start: Uint8Array;
+	board: Uint8Array;
+	phase: number;
+	version: number;
+	difficulty: number;
+	selected?: number;
+	neutronFrom?: number;
+	neutronTo?: number;
+	moves: Int32Array;
+	scores?: Float64Array;
+};
+
+type EngineOptions = {
+	threads?: number;
+	pinThreads?: boolean;
+	sliceNodes?: number;
+	sliceSimulations?: number;
+	leafBatch?: number;
+	searchThreads?: number;
+	inferenceBatch?: number;
+	inferenceWaitUs?: number;
+	evalCacheEntries?: number;
+	inferencePrecision?: "fp32" | "int8";
+	rlPoolSize?: number;
+	sloMs?: number;
+	overloadPolicy?: "off" | "reject" | "downgrade";
+	cacheEntries?: number;
+};
+
+type HistogramSummary = { count: number; mean: number; p50: number; p90: number; p99: number; p999: number; max: number };
+
+// Métricas por clase de coste; ver native/include/EngineStats.h.
+type EngineClassStats = {
+	requests: number;
+	completed: number;
+	failed: number;
+	rejected: number;
+	downgraded: number;
+	cancelled: number;
+	cacheHits: number;
+	coalesced: number;
+	units: number;
+	unitsPerSec: number;
+	ttProbes: number;
+	ttHitRate: number;
+	inferences: number;
+	meanBatchSize: number;
+	reusedVisits: number;
+	evalCacheProbes: number;
+	evalCacheHitRate: number;
+	poolWaitUs: HistogramSummary;
+	queueWaitUs: HistogramSummary;
+	executionUs: HistogramSummary;
+	unitsPerSearch: HistogramSummary;
+	predictionErrorPct: HistogramSummary;
+	inferenceUs: HistogramSummary;
+	batchSize: HistogramSummary;
+};
+
+// Caché de resultados compartida por minimax y RL (hard); ver native/include/ResultCache.h.
+type ResultCacheStats = {
+	entries: number;
+	capacity: number;
+	inflight: number;
+	hits: number;
+	coalesced: number;
+	misses: number;
+	evictions: number;
+	hitRate: number;
+};
+
+// Búsquedas RL en curso y en espera de hueco (RL_POOL_SIZE, 0 = sin límite); ver native/include/SearchPool.h.
+type SearchPoolStats = {
+	size: number;
+	active: number;
+	waiting: number;
+};
 
+export type EngineStats = {
+	threads: number;
+	queueDepth: number;
+	expectedWaitMs: number;
+	cache: ResultCacheStats;
+	rlPool: SearchPoolStats;
+	classes: Record<string, EngineClassStats>;
+};
+
+const minimaxAddon: {
+	minimaxAsync(
+		input: { board: Uint8Array; depth: number; targetMs?: number } & PackedRequest & ProgressRequest<MinimaxProgress>
+	): Promise<(NativeOutput & CostPrediction) | Int32Array>;
+	minimaxBatchAsync(input: { boards: Uint8Array; depth: number; out?: Int32Array; ttEntries?: number }): Promise<Int32Array>;
+	// Reglas síncronas sobre el tablero (col * 5 + row); ver native/include/Rules.h.
+	legalTargets(board: Uint8Array, index: number): number;
+	legalTurns(board: Uint8Array, player: PieceKind, out?: Int32Array): Int32Array;
+	gameWinner(board: Uint8Array, mover: PieceKind): PieceKind;
+	validateTurn(board: Uint8Array, player: PieceKind, neutronFrom: number, neutronTo: number, pawnFrom: number, pawnTo: number): boolean;
+	// Codec binario de posiciones y partidas; ver native/include/GameCodec.h.
+	encodePosition(board: Uint8Array, phase: number): number | null;
+	decodePosition(key: number): { board: Uint8Array; phase: number };
+	encodeGame(record: GameRecord): Uint8Array | null;
+	decodeGame(bytes: Uint8Array): Required<GameRecord>;
+	replayGame(bytes: Uint8Array, plies?: number): Uint8Array;
+	// Modelo de coste de targetMs; ver native/include/CostModel.h.
+	calibrateCostModel(): { nodesPerSecond: number; alpha: number; beta: number; samples: number };
+	configureEngine(options: EngineOptions): boolean;
+	getStats(): EngineStats;
+} = require(resolveMinimaxAddonPath());
+
+// Both addons share one native scheduler; it must be sized before the first search starts.
+minimaxAddon.configureEngine({
+	threads: config.engineThreads,
+	pinThreads: config.enginePinThreads,
+	sliceNodes: config.engineSliceNodes,
+	sliceSimulations: config.engineSliceSimulations,
+	leafBatch: config.rlLeafBatch,
+	searchThreads: config.rlSearchThreads,
+	inferenceBatch: config.rlInferBatch,
+	inferenceWaitUs: config.rlInferWaitUs,
+	evalCacheEntries: config.rlEvalCacheEntries,
+	inferencePrecision: config.rlPrecision,
+	rlPoolSize: config.rlPoolSize,
+	sloMs: config.engineSloMs,
+	overloadPolicy: config.engineOverloadPolicy,
+	cacheEntries: config.engineCacheEntries
+});
+
+// Con objetivos de latencia o control de admisión (sus costes salen del mismo modelo) la calibración
+// (~100ms de búsquedas) se paga al arrancar, no en la primera jugada.
+if (Object.keys(config.engineDepthTargetsMs).length || (config.engineSloMs > 0 && config.engineOverloadPolicy !== "off")) {
+	logger.info({ns: "engine", ev: "cost_model_calibrated", ...minimaxAddon.calibrateCostModel()});
+}
+
+// Frente ligero: libtorch (neutron_rl_engine.so) se carga con dlopen en el primer loadModel().
 type RlAddon = {
 	loadModel(path: string): Promise<void>;
-	moveAsync(input: { board: Uint8Array; difficulty: RlDifficulty }): Promise<NativeOutput>;
+	engineLoaded(): boolean;
+	// game: id de la partida; sus jugadas reutilizan el árbol MCTS de la anterior hasta endGame(game).
+	moveAsync(
+		input: { board: Uint8Array; difficulty: RlDifficulty; game?: string } & PackedRequest & ProgressRequest<RlProgress>
+	): Promise<NativeOutput | Int32Array>;
+	endGame(game: string): void;
+	configureEngine(options: EngineOptions): boolean;
+	getStats(): EngineStats;
 };
 
 let rlAddon: RlAddon | undefined;
 let rlReady = false;
+let rlLoading: Promise<boolean> | undefined;
 
 function resolveRlAddonPath(): string | undefined {
 	const candidates = [
@@ -72,8 +225,82 @@ try {
 	logger.warn({ns: "rl", ev: "addon_load_error", err: String(err?.message ?? err)});
 }
 
-export function nativeMinimax(input: { board: Uint8Array; depth: number }): Promise<NativeOutput> {
-	return minimaxAddon.minimaxAsync(input);
+const PACKED_LEVEL = 14;
+
+function unpackNativeOutput(result: NativeOutput | Int32Array): NativeOutput & { level?: number } {
+	if (!(result instanceof Int32Array)) return result;
+
+	const moves: NativeMove[] = [];
+	for (let i = 0; i < result[1]; i++) {
+		const at = 2 + i * 3;
+		moves.push({row: result[at], col: result[at + 1], kind: result[at + 2]});
+	}
+
+	return {moves, score: result[0], level: result[PACKED_LEVEL]};
+}
+
+// El addon rechaza con code ENGINE_OVERLOADED; se traduce al formato "code: mensaje" del resto de errores.
+function engineError(err: any): Error {
+	if (err?.code !== "ENGINE_OVERLOADED") return err;
+
+	logger.warn({ns: "engine", ev: "overloaded", retryAfterMs: err.retryAfterMs});
+	return new Error(`engine_overloaded: retry in ${Math.ceil(err.retryAfterMs ?? 0)}ms`);
+}
+
+export async function nativeMinimax(
+	input: { board: Uint8Array; depth: number } & ProgressRequest<MinimaxProgress>
+): Promise<NativeOutput> {
+	// con objetivo de latencia la profundidad la elige el modelo de coste, hasta input.depth; se pide
+	// el objeto para recibir la predicción. Si no, packed: el addon no construye objetos JS por jugada.
+	const targetMs: number | undefined = config.engineDepthTargetsMs[input.depth];
+	const output = await minimaxAddon.minimaxAsync({...input, targetMs, packed: targetMs === undefined}).catch((err) => {
+		throw engineError(err);
+	});
+	const result = unpackNativeOutput(output);
+
+	const depth = result.level ?? result.depth ?? input.depth;
+	if (targetMs !== undefined && !(output instanceof Int32Array)) {
+		logger.debug({
+			ns: "engine",
+			ev: "cost_model",
+			requestedDepth: input.depth,
+			depth,
+			targetMs,
+			predictedMs: output.predictedMs,
+			predictionError: output.predictionError
+		});
+	} else if (depth !== input.depth) {
+		logger.info({ns: "engine", ev: "downgraded", requestedDepth: input.depth, depth});
+	}
+
+	return {moves: result.moves, score: result.score, depth};
+}
+
+// Análisis offline: N tableros de 25 bytes seguidos; devuelve N registros empaquetados de 15 int32
+// (mismo formato que packed). Usa todos los hilos del motor con una tabla de transposición común.
+export async function nativeMinimaxBatch(boards: Uint8Array, depth: number, out?: Int32Array): Promise<NativeOutput[]> {
+	const packed = await minimaxAddon.minimaxBatchAsync({boards, depth, out});
+
+	const stride = PACKED_LEVEL + 1;
+	const results: NativeOutput[] = [];
+	for (let i = 0; i < boards.length / 25; i++) {
+		const {moves, score, level} = unpackNativeOutput(packed.subarray(i * stride, (i + 1) * stride));
+		results.push({moves, score, depth: level});
+	}
+	return results;
+}
+
+// Ambos addons comparten scheduler y métricas: basta con preguntar a uno.
+export function engineStats(): EngineStats {
+	return minimaxAddon.getStats();
+}
+
+export function startEngineStatsLog(intervalMs: number): void {
+	if (intervalMs <= 0) return;
+
+	setInterval(() => {
+		logger.info({ns: "engine", ev: "stats", ...engineStats()});
+	}, intervalMs).unref();
 }
 
 function rlDifficulty(difficulty: number): RlDifficulty {
@@ -96,33 +323,79 @@ export function isRlAvailable(): boolean {
 	return Boolean(rlAddon && rlReady);
 }
 
-export async function loadRlModel(modelPath: string): Promise<void> {
+// Carga el modelo (y con él libtorch) la primera vez que se pide; las llamadas siguientes esperan
+// esa misma carga. Devuelve si RL quedó disponible. Una carga fallida no se recuerda: la siguiente
+// petición lo vuelve a intentar (sin addon no, que solo se resuelve al arrancar).
+export function ensureRlModel(): Promise<boolean> {
+	if (!rlLoading) {
+		const loading: Promise<boolean> = loadRlModel(config.rlModelPath).then(
+			(ready) => {
+				if (!ready && rlAddon && rlLoading === loading) rlLoading = undefined;
+				return ready;
+			},
+			(err) => {
+				if (rlLoading === loading) rlLoading = undefined;
+				throw err;
+			}
+		);
+		rlLoading = loading;
+	}
+	return rlLoading;
+}
+
+export async function loadRlModel(modelPath: string): Promise<boolean> {
 	if (!rlAddon) {
 		logger.warn({ns: "rl", ev: "addon_unavailable"});
-		return;
+		return false;
 	}
 
 	const resolvedPath = path.isAbsolute(modelPath) ? modelPath : path.join(process.cwd(), modelPath);
+	const coldStart = !rlAddon.engineLoaded();
+	const rss = process.memoryUsage.rss();
+	const started = performance.now();
 
 	try {
 		await rlAddon.loadModel(resolvedPath);
 		rlReady = true;
-		logger.info({ns: "rl", ev: "model_loaded", modelPath: resolvedPath});
+		logger.info({
+			ns: "rl",
+			ev: "model_loaded",
+			modelPath: resolvedPath,
+			coldStart,
+			ms: Math.round(performance.now() - started),
+			rssDeltaMb: Math.round((process.memoryUsage.rss() - rss) / 2 ** 20)
+		});
 	} catch (err: any) {
 		rlReady = false;
 		logger.warn({ns: "rl", ev: "model_load_error", modelPath: resolvedPath, err: String(err?.message ?? err)});
 	}
+	return rlReady;
 }
 
-export function nativeRlMove(input: { board: Uint8Array; difficulty: number }): Promise<NativeOutput> {
-	if (!rlAddon || !rlReady) {
+export async function nativeRlMove(
+	input: { board: Uint8Array; difficulty: number; game?: string } & ProgressRequest<RlProgress>
+): Promise<NativeOutput> {
+	// p. ej. una partida RL guardada antes de reiniciar el servidor: el modelo se carga aquí.
+	if (!(await ensureRlModel()) || !rlAddon) {
 		throw new Error("rl_unavailable: RL addon/model not available");
 	}
 
-	return rlAddon.moveAsync({
-		board: input.board,
-		difficulty: rlDifficulty(input.difficulty)
-	});
+	const difficulty = rlDifficulty(input.difficulty);
+	const {board, game, onProgress, progressIntervalMs} = input;
+	const request = {board, difficulty, game, packed: true, onProgress, progressIntervalMs};
+	const result = unpackNativeOutput(await rlAddon.moveAsync(request).catch((err) => {
+		throw engineError(err);
+	}));
+
+	const simulations = result.level;
+	logger.info({ns: "rl", ev: "move", difficulty, simulations});
+
+	return {moves: result.moves, score: result.score, simulations};
+}
+
+// Libera el árbol MCTS que el addon guarda para la partida (también cae solo si hay muchas partidas).
+export function endRlGame(game: string): void {
+	if (rlAddon && rlReady) rlAddon.endGame(game);
 }
 
 const rotation = [PieceKind.NEUTRON, PieceKind.WHITE];
@@ -149,38 +422,82 @@ const mappingForHighlightingBoard: Record<PieceKind, PieceKind> = {
 	[PieceKind.SCELL]: PieceKind.SCELL
 };
 
-const rowMoveMapping: Record<Direction, number> = {
-	[Direction.NORTH]: -1,
-	[Direction.SOUTH]: 1,
-	[Direction.EAST]: 0,
-	[Direction.WEST]: 0,
-	[Direction.NORTHEAST]: -1,
-	[Direction.NORTHWEST]: -1,
-	[Direction.SOUTHEAST]: 1,
-	[Direction.SOUTHWEST]: 1
-};
+const startBoard = Uint8Array.from(getDefaultBoard());
 
-const colMoveMapping: Record<Direction, number> = {
-	[Direction.NORTH]: 0,
-	[Direction.SOUTH]: 0,
-	[Direction.EAST]: 1,
-	[Direction.WEST]: -1,
-	[Direction.NORTHEAST]: 1,
-	[Direction.NORTHWEST]: -1,
-	[Direction.SOUTHEAST]: 1,
-	[Direction.SOUTHWEST]: -1
-};
+function cellOf(move: Move | undefined): number {
+	return move ? move.col * 5 + move.row : -1;
+}
+
+function moveAt(cell: number, kind: PieceKind): Move {
+	return new Move(cell % 5, Math.floor(cell / 5), kind);
+}
 
-const directions: Direction[] = [
-	Direction.NORTH,
-	Direction.SOUTH,
-	Direction.EAST,
-	Direction.WEST,
-	Direction.NORTHEAST,
-	Direction.NORTHWEST,
-	Direction.SOUTHEAST,
-	Direction.SOUTHWEST
-];
+// Partida en el formato binario del addon (~2 bytes por jugada), o undefined si no se puede guardar
+// exactamente así (p. ej. una partida cargada con game:load que no sale de la posición inicial).
+export function encodeGameState(state: GameState): Buffer | undefined {
+	const moves = new Int32Array(state.movements.length * 5);
+	const scores = new Float64Array(state.movements.length);
+	for (const [i, fullMove] of state.movements.entries()) {
+		const [neutronFrom, neutronTo, pawnFrom, pawnTo] = fullMove.moves;
+		if (neutronFrom.kind !== PieceKind.NEUTRON || neutronTo.kind !== PieceKind.NEUTRON || pawnTo.kind !== pawnFrom.kind) return undefined;
+
+		moves.set([cellOf(neutronFrom), cellOf(neutronTo), cellOf(pawnFrom), cellOf(pawnTo), pawnFrom.kind], i * 5);
+		scores[i] = fullMove.score;
+	}
+
+	// el codec deduce estos tipos: solo se aceptan los que onClickCell produce.
+	const selected = state.selectedChip;
+	if (selected && selected.kind !== mappingForCleaningBoard[state.elementAt(selected.row, selected.col)]) return undefined;
+	if ([state.neutronFrom, state.neutronTo].some((m) => m && m.kind !== PieceKind.NEUTRON)) return undefined;
+
+	const bytes = minimaxAddon.encodeGame({
+		start: startBoard,
+		board: Uint8Array.from(state.board),
+		phase: state.whoMove,
+		version: state.version,
+		difficulty: state.difficulty,
+		selected: cellOf(selected),
+		neutronFrom: cellOf(state.neutronFrom),
+		neutronTo: cellOf(state.neutronTo),
+		moves,
+		scores
+	});
+	return bytes ? Buffer.from(bytes.buffer, bytes.byteOffset, bytes.byteLength) : undefined;
+}
+
+export function decodeGameState(id: string, bytes: Uint8Array): GameState {
+	const record = minimaxAddon.decodeGame(bytes);
+
+	const movements: FullMove[] = [];
+	for (let i = 0; i < record.scores.length; i++) {
+		const [neutronFrom, neutronTo, pawnFrom, pawnTo, pawnKind] = record.moves.subarray(i * 5, i * 5 + 5);
+		movements.push(new FullMove([
+			moveAt(neutronFrom, PieceKind.NEUTRON),
+			moveAt(neutronTo, PieceKind.NEUTRON),
+			moveAt(pawnFrom, pawnKind),
+			moveAt(pawnTo, pawnKind)
+		], record.scores[i]));
+	}
+
+	const board = Array.from(record.board) as PieceKind[];
+	const optional = (cell: number, kind: PieceKind) => (cell >= 0 ? moveAt(cell, kind) : undefined);
+	return new GameState(
+		id,
+		board,
+		movements,
+		record.phase,
+		optional(record.selected, mappingForCleaningBoard[board[record.selected]]),
+		optional(record.neutronFrom, PieceKind.NEUTRON),
+		optional(record.neutronTo, PieceKind.NEUTRON),
+		record.version,
+		record.difficulty
+	);
+}
+
+// Posición actual en un número (< 2^36) para los logs; null si el tablero no es estándar.
+export function encodePosition(state: GameState): number | null {
+	return minimaxAddon.encodePosition(Uint8Array.from(state.board), state.whoMove);
+}
 
 function getWhoMove(state: GameState): PieceKind {
 	if (state.whoMove !== 0 && state.whoMove !== 1) {
@@ -206,38 +523,22 @@ function updateBoard(moves: Move[], state: GameState): void {
 	);
 }
 
-function inBounds(value: number, inc: number): boolean {
-	return value + inc >= 0 && value + inc < 5;
-}
+// Tablero reutilizado para las reglas nativas: ninguna llamada retiene el Uint8Array.
+const rulesBoard = new Uint8Array(25);
 
-function getRowMove(direction: Direction): number {
-	return rowMoveMapping[direction];
+function nativeBoard(state: GameState): Uint8Array {
+	rulesBoard.set(state.board);
+	return rulesBoard;
 }
 
-function getColMove(direction: Direction): number {
-	return colMoveMapping[direction];
-}
+function moves(startPoint: Move, state: GameState): Move[] {
+	const targets = minimaxAddon.legalTargets(nativeBoard(state), startPoint.col * 5 + startPoint.row);
 
-function checkMove(move: Move, direction: Direction, state: GameState) {
-	function _check(row: number, col: number, incR: number, incC: number, state: GameState): {
-		row: number;
-		col: number
-	} {
-		if (!inBounds(row, incR) ||
-			!inBounds(col, incC) ||
-			state.elementAt(row + incR, col + incC) !== PieceKind.CELL) return {row: row, col: col};
-		return _check(row + incR, col + incC, incR, incC, state);
+	const result: Move[] = [];
+	for (let cell = 0; cell < 25; cell++) {
+		if (targets & (1 << cell)) result.push(new Move(cell % 5, Math.floor(cell / 5), startPoint.kind));
 	}
-
-	const {row, col} = _check(move.row, move.col, getRowMove(direction), getColMove(direction), state);
-
-	return row === move.row && col === move.col ? undefined : new Move(row, col, move.kind);
-}
-
-function moves(startPoint: Move, state: GameState): Move[] {
-	return directions
-		.map((direction: Direction) => checkMove(startPoint, direction, state))
-		.filter((m: Move | undefined) => m !== undefined);
+	return result;
 }
 
 function checkGameOver(
@@ -246,11 +547,8 @@ function checkGameOver(
 	state: GameState): { success: boolean; kind: PieceKind } {
 	if (!neutronDestination) return {success: false, kind: PieceKind.CELL};
 
-	const neutronMoves = moves(neutronDestination, state);
-	if (!neutronMoves.length) return {success: true, kind: pieceKind};
-	if (!neutronDestination.row) return {success: true, kind: PieceKind.BLACK};
-	if (neutronDestination.row === 4) return {success: true, kind: PieceKind.WHITE};
-	return {success: false, kind: PieceKind.CELL};
+	const kind: PieceKind = minimaxAddon.gameWinner(nativeBoard(state), pieceKind);
+	return {success: kind !== PieceKind.CELL, kind};
 }
 
 function applyMove(from: Move | undefined, to: Move | undefined, state: GameState): void {
@@ -291,7 +589,7 @@ export async function onClickCell(state: GameState, row: number, col: number): P
 
 			if (!endGame.success) {
 				const obj = isRlMode(state.difficulty)
-					? await nativeRlMove({board: Uint8Array.from(state.board), difficulty: state.difficulty})
+					? await nativeRlMove({board: Uint8Array.from(state.board), difficulty: state.difficulty, game: state.id})
 					: await nativeMinimax({board: Uint8Array.from(state.board), depth: state.difficulty});
 				const machineFullMove = new FullMove(
 					obj.moves.map((m: any) => new Move(m.row, m.col, m.kind)),
@@ -320,5 +618,6 @@ export async function onClickCell(state: GameState, row: number, col: number): P
 		state.selectedChip = undefined;
 	}
 
+	if (endGame.success && isRlMode(state.difficulty)) endRlGame(state.id);
 	return endGame;
 }
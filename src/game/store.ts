@@ -9,16 +9,26 @@
 * Contact            : rlsalgado2006@gmail.com
 * ===============================================================================
 */
-import { createClient, type RedisClientType } from "redis";
+import { createClient, RESP_TYPES, type RedisClientType } from "redis";
 import { config } from "(src)/infra/config";
 import { GameState } from "(src)/domain/GameState";
 import { getReviver } from "(src)/domain/utils";
 
+// Estados guardados antes del codec binario (o que no caben en él) siguen siendo JSON.
+const JSON_START = "{".charCodeAt(0);
+
+// Codec binario de partidas (encodeGameState/decodeGameState de engine.ts, que cargan el addon).
+// Se inyecta para que el store no dependa del addon: sin codec todo se guarda en JSON.
+export type GameCodec = {
+	encode(state: GameState): Buffer | undefined;
+	decode(id: string, raw: Uint8Array): GameState;
+};
+
 export class GameStore {
 	private client: RedisClientType;
 	private readonly prefix = "neutron:game:";
 
-	constructor() {
+	constructor(private readonly codec?: GameCodec) {
 		this.client = createClient({url: config.redisUrl});
 	}
 
@@ -44,19 +54,34 @@ export class GameStore {
 		return this.prefix + id;
 	}
 
+	// Mismo socket que `client` (WATCH sigue valiendo), pero GET devuelve Buffer.
+	private get binary() {
+		return this.client.withTypeMapping({[RESP_TYPES.BLOB_STRING]: Buffer});
+	}
+
+	private decode(id: string, raw: Buffer): GameState {
+		if (raw[0] === JSON_START)
+			return JSON.parse(raw.toString(), getReviver("GameState")) as GameState;
+		if (!this.codec)
+			throw new Error(`codec_unavailable: key=${this.key(id)}, cause=binary_state_without_codec`);
+
+		return this.codec.decode(id, raw);
+	}
+
+	private encode(state: GameState): Buffer | string {
+		return this.codec?.encode(state) ?? JSON.stringify(state);
+	}
+
 	async load(gameId: string): Promise<GameState | undefined> {
-		const raw = await this.client.get(this.key(gameId));
-		return raw ?
-			JSON.parse(raw, getReviver("GameState")) as GameState :
-			undefined
-			;
+		const raw = await this.binary.get(this.key(gameId));
+		return raw ? this.decode(gameId, raw) : undefined;
 	}
 
 	async save(next: GameState) {
 		const key = this.key(next.id);
 		await this.client.watch(key);
-		const currentRaw = await this.client.get(key);
-		const current: GameState | undefined = currentRaw ? JSON.parse(currentRaw, getReviver("GameState")) : undefined;
+		const currentRaw = await this.binary.get(key);
+		const current: GameState | undefined = currentRaw ? this.decode(next.id, currentRaw) : undefined;
 
 		if (!current) {
 			if (next.version !== 0) {
@@ -66,7 +91,7 @@ export class GameStore {
 
 			const res = await this.client
 				.multi()
-				.set(key, JSON.stringify(next), {EX: 3600 * 2})
+				.set(key, this.encode(next), {EX: 3600 * 2})
 				.exec();
 
 			if (res === undefined)
@@ -81,7 +106,7 @@ export class GameStore {
 		}
 
 		const multi = this.client.multi();
-		multi.set(key, JSON.stringify(next), {EX: 3600 * 2});
+		multi.set(key, this.encode(next), {EX: 3600 * 2});
 		const res = await multi.exec();
 
 		if (res === undefined)
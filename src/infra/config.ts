@@ -25,11 +25,39 @@ const Envs = z.object({
 	REDIS_URL: z.string().default("redis://127.0.0.1:6379"),
 
 	PG_URL: z.string().default("postgresql://localhost:5432/neutron"),
-	RL_MODEL_PATH: z.string().default("data/model.pt")
+	RL_MODEL_PATH: z.string().default("data/model.pt"),
+	RL_PRELOAD: z.coerce.number().int().min(0).max(1).default(0),
+	RL_LEAF_BATCH: z.coerce.number().int().min(1).max(256).default(1),
+	RL_SEARCH_THREADS: z.coerce.number().int().min(1).max(64).default(1),
+	RL_INFER_BATCH: z.coerce.number().int().min(1).max(1024).default(64),
+	RL_INFER_WAIT_US: z.coerce.number().int().min(0).default(1000),
+	RL_EVAL_CACHE_ENTRIES: z.coerce.number().int().min(0).default(65536),
+	RL_PRECISION: z.enum(["fp32", "int8"]).default("fp32"),
+	RL_POOL_SIZE: z.coerce.number().int().min(0).default(0),
+
+	ENGINE_THREADS: z.coerce.number().int().min(0).default(0),
+	ENGINE_PIN_THREADS: z.coerce.number().int().min(0).max(1).default(0),
+	ENGINE_SLICE_NODES: z.coerce.number().int().positive().default(20000),
+	ENGINE_SLICE_SIMULATIONS: z.coerce.number().int().positive().default(16),
+	ENGINE_SLO_MS: z.coerce.number().min(0).default(0),
+	ENGINE_OVERLOAD_POLICY: z.enum(["off", "reject", "downgrade"]).default("off"),
+	ENGINE_CACHE_ENTRIES: z.coerce.number().int().min(0).default(4096),
+	ENGINE_DEPTH_TARGETS_MS: z.string().regex(/^(\s*\d+\s*:\s*\d+(\.\d+)?\s*(,|$))*$/).default(""),
+	ENGINE_STATS_INTERVAL_MS: z.coerce.number().int().min(0).default(60000)
 });
 
 const parsed = Envs.parse(process.env);
 
+// "3:150,4:400" → {3: 150, 4: 400}: objetivo de latencia (ms) por dificultad minimax.
+function parseDepthTargets(spec: string): Record<number, number> {
+	const targets: Record<number, number> = {};
+	for (const entry of spec.split(",").map((s) => s.trim()).filter(Boolean)) {
+		const [depth, ms] = entry.split(":").map((s) => Number(s.trim()));
+		targets[depth] = ms;
+	}
+	return targets;
+}
+
 export const config = {
 	env: parsed.NODE_ENV,
 	isDev: parsed.NODE_ENV === "development",
@@ -46,5 +74,23 @@ export const config = {
 	redisUrl: parsed.REDIS_URL,
 
 	pgUrl: parsed.PG_URL,
-	rlModelPath: parsed.RL_MODEL_PATH
+	rlModelPath: parsed.RL_MODEL_PATH,
+	rlPreload: parsed.RL_PRELOAD === 1,
+	rlLeafBatch: parsed.RL_LEAF_BATCH,
+	rlSearchThreads: parsed.RL_SEARCH_THREADS,
+	rlInferBatch: parsed.RL_INFER_BATCH,
+	rlInferWaitUs: parsed.RL_INFER_WAIT_US,
+	rlEvalCacheEntries: parsed.RL_EVAL_CACHE_ENTRIES,
+	rlPrecision: parsed.RL_PRECISION,
+	rlPoolSize: parsed.RL_POOL_SIZE,
+
+	engineThreads: parsed.ENGINE_THREADS,
+	enginePinThreads: parsed.ENGINE_PIN_THREADS === 1,
+	engineSliceNodes: parsed.ENGINE_SLICE_NODES,
+	engineSliceSimulations: parsed.ENGINE_SLICE_SIMULATIONS,
+	engineSloMs: parsed.ENGINE_SLO_MS,
+	engineOverloadPolicy: parsed.ENGINE_OVERLOAD_POLICY,
+	engineCacheEntries: parsed.ENGINE_CACHE_ENTRIES,
+	engineDepthTargetsMs: parseDepthTargets(parsed.ENGINE_DEPTH_TARGETS_MS),
+	engineStatsIntervalMs: parsed.ENGINE_STATS_INTERVAL_MS
 } as const;
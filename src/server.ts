@@ -28,7 +28,15 @@ import {
     GameNewSchema
 } from "(src)/domain/schemas";
 import {GameState} from "(src)/domain/GameState";
-import {isRlAvailable, isRlMode, loadRlModel, onClickCell} from "(src)/game/engine";
+import {
+    decodeGameState,
+    encodeGameState,
+    encodePosition,
+    ensureRlModel,
+    isRlMode,
+    onClickCell,
+    startEngineStatsLog
+} from "(src)/game/engine";
 import {pgConnect, pgDisconnect, pgIsConnected, pgPing} from "(src)/infra/pg";
 import {insertSession, closeSession, logEvent} from "(src)/infra/event-log";
 
@@ -107,7 +115,7 @@ app.use((err: unknown, _req: Request, res: Response, _next: NextFunction) => {
 const server = http.createServer(app);
 const io = new Server(server, {cors: {origin: config.corsOrigins}});
 
-const store = new GameStore();
+const store = new GameStore({encode: encodeGameState, decode: decodeGameState});
 const ns = io.of("/game");
 
 /**
@@ -157,7 +165,7 @@ ns.on("connection", async (socket) => {
         logEvent(sessionId, "game_new", gid);
         const created = await store.initIfMissing(new GameState(gid));
         if (typeof difficulty === "number") {
-            if (isRlMode(difficulty) && !isRlAvailable()) {
+            if (isRlMode(difficulty) && !(await ensureRlModel())) {
                 throw new Error("rl_unavailable: RL addon/model not available");
             }
             created.difficulty = difficulty;
@@ -175,7 +183,7 @@ ns.on("connection", async (socket) => {
     socket.on("game:change:diff", withAck(GameChangeDifficultySchema, async ({difficulty, gameId}) => {
         logEvent(sessionId, "game_change_difficulty", gameId, {difficulty});
 
-        if (isRlMode(difficulty) && !isRlAvailable()) {
+        if (isRlMode(difficulty) && !(await ensureRlModel())) {
             throw new Error("rl_unavailable: RL addon/model not available");
         }
 
@@ -222,11 +230,13 @@ ns.on("connection", async (socket) => {
         ns.to(gameId).emit("state", next);
         if (endGame.success) {
             logger.info({ns: "game", ev: "game_over", gameId, winner: endGame.kind});
+            const position = encodePosition(next);
             logEvent(sessionId, "game_over", gameId, {
                 winner: endGame.kind,
                 difficulty: next.difficulty,
                 moveCount: next.movements.length,
-                board: Array.from(next.board)
+                // clave de GameCodec.h (decodePosition); el tablero entero solo si la posición no es estándar
+                ...(position !== null ? {position} : {board: Array.from(next.board)})
             });
             ns.to(gameId).emit("game:over", {winner: endGame.kind});
         }
@@ -255,7 +265,11 @@ async function applyClickAndEvolve(current: GameState, click: { row: number; col
 async function main() {
     await store.connect();
     await pgConnect();
-    await loadRlModel(config.rlModelPath);
+    // Sin RL_PRELOAD, libtorch no se carga hasta la primera partida con dificultad RL.
+    if (config.rlPreload) {
+        await ensureRlModel();
+    }
+    startEngineStatsLog(config.engineStatsIntervalMs);
 
     server.listen(
         config.port,